@@ -1,14 +1,15 @@
 // ActiveEventBuilders
 // ---------------------
 // These methods generate main events in order to resolve their effects.
-// - When Event* is null:     CombatSystem creates a new Event and pushes it to the main event queue.
-// - When Event* is non-null: CombatSystem fills in resolved values (damage, resource changes, etc.).
+// - When Event* is null:     CombatSystem reserves a new Event in the main event queue and fills in its shape.
+// - When Event* is non-null: CombatSystem fills in resolved values (damage, resource changes, etc.) in the same slot.
+// - New events are pushed through the BattleContext of the battle being resolved.
+// - Builders are templates over the battle's CombatConfig, instantiated for every shipped mode.
+// - The phases they run and dispatch_active_event_builder are defined in the header, for inlining into the engine.
 
 #include "active_event_builders.h"
-#include "alias.h"
-#include <godot_cpp/variant/utility_functions.hpp>
 
-#include "pipelinepunch/systems/combat_system/combat_system.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
 #include "pipelinepunch/systems/combat_system/structs/character_table.h"
 #include "pipelinepunch/systems/combat_system/structs/event.h"
 #include "pipelinepunch/systems/combat_system/structs/intent.h"
@@ -17,57 +18,34 @@ namespace pipelinepunch {
     
     // --- Methods ---
     // DEMO_ATTACK
-    void demo_attack(const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const Intent& intent, Event* event) {
-        if (!event) {
-            // Phase 1: CREATE event with flags for reaction triggers.
-            Event new_event{};
-            new_event.intent = intent;
-            new_event.target_bitmask = single_target(intent);
-            new_event.effect_bitmask = DAMAGE;
-
-            CombatSystem::get_instance()->push_main_event(new_event);
-            
-            return;
-        }
-
-        // Phase 2: UPDATE event with damage calculations.
-        uint8_t owner_index  = intent.owner_index;
-        uint8_t target_pos = intent.target_pos;
-        uint8_t target_index = other_ct.pos_to_index[target_pos];
-
-        const int owner_atk = owner_ct.atk[owner_index];
-        const int other_def = other_ct.def[target_index];
-
-        float damage = (other_ct.character_sheet[target_index].creature_sheet.type == TypeEnum::UNDEAD) ? 400*owner_atk/other_def : 200*owner_atk/other_def;
-        event->other_pos_damage[target_pos] = damage;
+    template <typename Config>
+    void demo_attack(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event) {
+        if (!event) { demo_attack_create(context, owner_ct, other_ct, intent); }
+        else        { demo_attack_resolve(context, owner_ct, other_ct, intent, *event); }
     }
 
     // DEMO_CLEAVE
-    void demo_cleave(const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const Intent& intent, Event* event) {
-        // Phase 1: CREATE event with flags for reaction triggers.
-        if (!event) {
-            Event new_event{};
-            new_event.intent = intent;
-            new_event.is_aoe = true;
-            new_event.target_bitmask = AOE;
-            new_event.effect_bitmask = DAMAGE;
-
-            CombatSystem::get_instance()->push_main_event(new_event);
-
-            return;
-        }
-
-        // Phase 2: UPDATE event with damage calculations.
-        const int owner_atk = owner_ct.atk[intent.owner_index];
-        for (int pos = 0; pos < 5; pos++) {
-            uint8_t owner_index  = intent.owner_index;
-            uint8_t target_pos = pos;
-            uint8_t target_index = other_ct.pos_to_index[target_pos];
-
-            const int other_def = other_ct.def[target_index];
-
-            float damage = (other_ct.character_sheet[target_index].creature_sheet.type == TypeEnum::UNDEAD) ? 200*owner_atk/other_def : 100*owner_atk/other_def;
-            event->other_pos_damage[target_pos] = damage;
-        }
+    template <typename Config>
+    void demo_cleave(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event) {
+        if (!event) { demo_cleave_create(context, owner_ct, other_ct, intent); }
+        else        { demo_cleave_resolve(context, owner_ct, other_ct, intent, *event); }
     }
+
+    // --- Instantiations ---
+    template void demo_attack<Config5v5>       (BattleContext<Config5v5>&,        const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_attack<Config5v5Pointer>(BattleContext<Config5v5Pointer>&, const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_attack<Config5v5Program>(BattleContext<Config5v5Program>&, const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_attack<Config1v20>      (BattleContext<Config1v20>&,       const CharacterTable<20>&, const CharacterTable<20>&, const Intent&, Event<20>*);
+    template void demo_attack<Config30v30>     (BattleContext<Config30v30>&,      const CharacterTable<30>&, const CharacterTable<30>&, const Intent&, Event<30>*);
+    template void demo_cleave<Config5v5>       (BattleContext<Config5v5>&,        const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_cleave<Config5v5Pointer>(BattleContext<Config5v5Pointer>&, const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_cleave<Config5v5Program>(BattleContext<Config5v5Program>&, const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_cleave<Config1v20>      (BattleContext<Config1v20>&,       const CharacterTable<20>&, const CharacterTable<20>&, const Intent&, Event<20>*);
+    template void demo_cleave<Config30v30>     (BattleContext<Config30v30>&,      const CharacterTable<30>&, const CharacterTable<30>&, const Intent&, Event<30>*);
+    template void demo_attack<Config5v5Fixed>  (BattleContext<Config5v5Fixed>&,   const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_attack<Config1v20Fixed> (BattleContext<Config1v20Fixed>&,  const CharacterTable<20>&, const CharacterTable<20>&, const Intent&, Event<20>*);
+    template void demo_attack<Config30v30Fixed>(BattleContext<Config30v30Fixed>&, const CharacterTable<30>&, const CharacterTable<30>&, const Intent&, Event<30>*);
+    template void demo_cleave<Config5v5Fixed>  (BattleContext<Config5v5Fixed>&,   const CharacterTable<5>&,  const CharacterTable<5>&,  const Intent&, Event<5>*);
+    template void demo_cleave<Config1v20Fixed> (BattleContext<Config1v20Fixed>&,  const CharacterTable<20>&, const CharacterTable<20>&, const Intent&, Event<20>*);
+    template void demo_cleave<Config30v30Fixed>(BattleContext<Config30v30Fixed>&, const CharacterTable<30>&, const CharacterTable<30>&, const Intent&, Event<30>*);
 }
\ No newline at end of file
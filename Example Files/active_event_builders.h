@@ -5,14 +5,121 @@
 // These methods generate main events in order to resolve their effects.
 // - When Event* is null:     CombatSystem creates a new Event and pushes it to the main event queue.
 // - When Event* is non-null: CombatSystem fills in resolved values (damage, resource changes, etc.).
+// - New events are pushed through the BattleContext of the battle being resolved.
+// - Builders are templates over the battle's CombatConfig, instantiated for every shipped mode.
+// - Each skill's phases are separate functions (<skill>_create, <skill>_resolve), so neither tests Event* at runtime.
+//   The <skill> form keeps the Event* convention for the ActiveEventBuilder function pointers.
+// - The phases and dispatch_active_event_builder, a switch over SkillEnum, are defined in this header, so the phase
+//   bodies inline into the switch and the switch into the CombatEngine, which calls it instead of a per-slot pointer.
 
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/data/skills/alias.h"
+#include "pipelinepunch/systems/combat_system/enums/skill_dispatch.h"
+#include "pipelinepunch/systems/combat_system/kernels/combat_kernels.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
 #include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
 #include "pipelinepunch/systems/combat_system/structs/event.h"
 #include "pipelinepunch/systems/combat_system/structs/intent.h"
 
 namespace pipelinepunch {
     
     // --- Methods ---
-    void demo_attack(const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const Intent& intent, Event* event); // DEMO_ATTACK
-    void demo_cleave(const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const Intent& intent, Event* event); // DEMO_CLEAVE
+    template <typename Config> void demo_attack(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event); // DEMO_ATTACK
+    template <typename Config> void demo_cleave(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event); // DEMO_CLEAVE
+
+    // --- Phases ---
+    // DEMO_ATTACK, phase 1: CREATE event with flags for reaction triggers.
+    template <typename Config>
+    void demo_attack_create(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>&, const CharacterTable<Config::TEAM_SIZE>&, const Intent& intent) {
+        Event<Config::TEAM_SIZE>* new_event = context.emplace_main_event(intent);
+        if (!new_event) return;
+
+        new_event->target_bitmask = single_target(intent);
+        new_event->effect_bitmask = DAMAGE;
+    }
+
+    // DEMO_ATTACK, phase 2: UPDATE event with damage calculations.
+    template <typename Config>
+    void demo_attack_resolve(BattleContext<Config>&, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>& event) {
+        uint8_t owner_index  = intent.owner_index;
+        uint8_t target_pos = intent.target_pos;
+        uint8_t target_index = other_ct.pos_to_index[target_pos];
+
+        const int owner_atk = owner_ct.atk[owner_index];
+        const int other_def = other_ct.def[target_index];
+
+        float damage = (other_ct.type[target_index] == TypeEnum::UNDEAD) ? 400*owner_atk/other_def : 200*owner_atk/other_def;
+        event.other_pos_damage[target_pos] = damage;
+    }
+
+    // DEMO_CLEAVE, phase 1: CREATE event with flags for reaction triggers.
+    template <typename Config>
+    void demo_cleave_create(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>&, const CharacterTable<Config::TEAM_SIZE>&, const Intent& intent) {
+        Event<Config::TEAM_SIZE>* new_event = context.emplace_main_event(intent);
+        if (!new_event) return;
+
+        new_event->is_aoe = true;
+        new_event->target_bitmask = AOE;
+        new_event->effect_bitmask = DAMAGE;
+    }
+
+    // DEMO_CLEAVE, phase 2: UPDATE event with damage calculations.
+    template <typename Config>
+    void demo_cleave_resolve(BattleContext<Config>&, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>& event) {
+        constexpr int N = Config::TEAM_SIZE;
+        const int owner_atk = owner_ct.atk[intent.owner_index];
+
+        // Small teams divide per living target; wider ones go through the scaled_ratio kernel.
+        if constexpr (N < COMBAT_KERNEL_MIN_UNITS) {
+            for (int pos = 0; pos < N; pos++) {
+                uint8_t target_pos = pos;
+                uint8_t target_index = other_ct.pos_to_index[target_pos];
+
+                if (other_ct.life[target_index] <= 0.0f) continue;
+
+                const int other_def = other_ct.def[target_index];
+
+                float damage = (other_ct.type[target_index] == TypeEnum::UNDEAD) ? 200*owner_atk/other_def : 100*owner_atk/other_def;
+                event.other_pos_damage[target_pos] = damage;
+            }
+        } else {
+            // Gathers each living target's power and defence, then divides them all at once. Dead targets get a
+            // divisor of 0, which scaled_ratio skips.
+            int32_t power[N];
+            int32_t other_def[N];
+            int32_t damage[N];
+            for (int pos = 0; pos < N; pos++) {
+                uint8_t target_index = other_ct.pos_to_index[pos];
+
+                power[pos]     = (other_ct.type[target_index] == TypeEnum::UNDEAD) ? 200 : 100;
+                other_def[pos] = (other_ct.life[target_index] > 0.0f) ? static_cast<int>(other_ct.def[target_index]) : 0;
+            }
+
+            scaled_ratio(damage, power, owner_atk, other_def, N);
+
+            for (int pos = 0; pos < N; pos++) {
+                if (other_ct.life[other_ct.pos_to_index[pos]] > 0.0f) { event.other_pos_damage[pos] = damage[pos]; }
+            }
+        }
+    }
+
+    // --- Dispatch ---
+    // Runs one phase of a skill's ActiveEventBuilder; event is only read in SkillPhase::RESOLVE.
+    // Every SkillEnum with an ActiveEventBuilder needs a case here and in get_active_event_builder.
+    template <typename Config, SkillPhase PHASE>
+    void dispatch_active_event_builder(SkillEnum skill_enum, BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event) {
+        switch (skill_enum) {
+            case SkillEnum::DEMO_ATTACK:
+                if constexpr (PHASE == SkillPhase::CREATE) { demo_attack_create(context, owner_ct, other_ct, intent); }
+                else                                       { demo_attack_resolve(context, owner_ct, other_ct, intent, *event); }
+                return;
+            case SkillEnum::DEMO_CLEAVE:
+                if constexpr (PHASE == SkillPhase::CREATE) { demo_cleave_create(context, owner_ct, other_ct, intent); }
+                else                                       { demo_cleave_resolve(context, owner_ct, other_ct, intent, *event); }
+                return;
+            default:
+                return;
+        }
+    }
 }
\ No newline at end of file
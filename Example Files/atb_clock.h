@@ -0,0 +1,10 @@
+#pragma once
+
+namespace pipelinepunch {
+
+    // Represents how an AtbScheduler keeps time.
+    enum class AtbClock {
+        FLOAT, // Double-precision times and float speeds; bit-exact across platforms only with strict IEEE builds.
+        FIXED  // Integer ticks and fixed-point speeds; identical turn orders on every platform and with any float flags.
+    };
+}
\ No newline at end of file
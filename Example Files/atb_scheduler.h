@@ -0,0 +1,327 @@
+#pragma once
+
+// AtbScheduler
+// ------------
+// Picks the next actor of an N-v-N battle from each unit's time-to-full instead of filling every turn bar.
+// - Keeps a battle clock and, per living unit, the clock time at which its turn bar reaches full.
+// - Waiting units sit in a pending heap keyed by ready time; units with a full bar sit in a ready heap keyed by
+//   speed. Selecting an actor, consuming a turn or changing a speed costs O(log n) rather than a rescan of both sides.
+// - Ties at the highest speed are broken by the battle's BattleRng in team/index order, with no cap on tied units.
+// - Dead units are dropped lazily when they surface at the top of a heap, so damage code never has to notify it.
+// - Turn bars are derived from the clock on demand; sync_turn_bars() writes them back for the GUI and state hash.
+// - forecast() previews upcoming actors on a copy of the heaps and random stream, leaving the battle untouched.
+//
+// The CombatConfig's AtbClock picks how time is kept:
+// - AtbClock::FLOAT: times are doubles so the clock keeps sub-step precision in long battles; like turn bars they
+//   only use IEEE add/sub/mul/div, so replays stay bit-exact across platforms when built with -ffp-contract=off.
+// - AtbClock::FIXED: times are integer ticks and speeds are fixed-point with SPEED_ONE steps per speed point. A full
+//   bar is BAR_TICKS bar units and a unit gains its speed in bar units per tick, so ready times round up to the
+//   next whole tick. Turn orders then depend on integer arithmetic only, identical on every platform and compiler
+//   flag; units that would fill within the same tick are ordered by speed and the tie draw.
+
+#include <cstdint>
+#include <type_traits>
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the ATB turn order of both sides of a battle.
+    template <int N, AtbClock CLOCK = AtbClock::FLOAT>
+    struct AtbScheduler {
+        static constexpr int     UNITS   = 2 * N; // Units are identified by team_index * N + index.
+        static constexpr uint8_t NONE    = 0;     // Not scheduled (dead, empty or dropped).
+        static constexpr uint8_t PENDING = 1;     // Waiting for its turn bar to fill.
+        static constexpr uint8_t READY   = 2;     // Full turn bar, waiting to be picked.
+
+        static constexpr bool    FIXED     = CLOCK == AtbClock::FIXED;
+        static constexpr int64_t BAR_TICKS = int64_t(1) << 32; // AtbClock::FIXED: bar units in a full turn bar.
+        static constexpr int64_t SPEED_ONE = 256;              // AtbClock::FIXED: fixed-point steps per speed point.
+
+        using Time  = typename std::conditional<FIXED, int64_t, double>::type; // Clock time: ticks or seconds.
+        using Speed = typename std::conditional<FIXED, int64_t, float>::type;  // Speed: fixed-point or float.
+
+        Time    clock { 0 };
+        Time    ready_time[UNITS];  // Clock time at which the unit's turn bar is full.
+        Speed   spe[UNITS];         // Speed the ready time was computed with.
+        int32_t pending[UNITS];     // Min-heap of unit ids by (ready_time, id).
+        int32_t ready[UNITS];       // Max-heap of unit ids by (spe, -id).
+        int32_t slot[UNITS];        // Position of each unit in its heap.
+        uint8_t heap[UNITS];        // Which heap holds each unit.
+        int32_t pending_count { 0 };
+        int32_t ready_count { 0 };
+
+        // --- Entry Points ---
+        // Schedules every living unit from its current turn bar and speed, and resets the clock.
+        void reset(const CharacterTable<N>& ally_ct, const CharacterTable<N>& opponent_ct) {
+            clock         = 0;
+            pending_count = 0;
+            ready_count   = 0;
+
+            for (int id = 0; id < UNITS; id++) {
+                const CharacterTable<N>& ct = (id < N) ? ally_ct : opponent_ct;
+                const int index = id % N;
+
+                heap[id] = NONE;
+                spe[id]  = to_speed(ct.spe[index]);
+
+                if (ct.life[index] <= 0.0f) continue;
+
+                if (ct.turn_bar[index] >= 1.0f) {
+                    ready_time[id] = clock;
+                    push(READY, id);
+                } else {
+                    if constexpr (FIXED) {
+                        const int64_t filled = (ct.turn_bar[index] > 0.0f) ? static_cast<int64_t>(static_cast<double>(ct.turn_bar[index]) * BAR_TICKS) : 0;
+                        ready_time[id] = clock + ticks_to_fill(BAR_TICKS - filled, spe[id]);
+                    } else {
+                        ready_time[id] = clock + (1.0 - static_cast<double>(ct.turn_bar[index])) / static_cast<double>(spe[id]);
+                    }
+                    push(PENDING, id);
+                }
+            }
+        }
+
+        // Gets the next actor, advancing the clock to the earliest ready time if no living unit has a full bar.
+        // Returns an owner_team_index of -1 if no living unit is left.
+        Intent next(BattleRng& rng, const CharacterTable<N>& ally_ct, const CharacterTable<N>& opponent_ct) {
+            auto is_alive = [&](int id) {
+                const CharacterTable<N>& ct = (id < N) ? ally_ct : opponent_ct;
+                return ct.life[id % N] > 0.0f;
+            };
+
+            while (ready_count > 0 && !is_alive(ready[0])) { pop(READY); }
+
+            if (ready_count == 0) {
+                while (pending_count > 0 && !is_alive(pending[0])) { pop(PENDING); }
+                if (pending_count == 0) { return Intent{ -1, -1 }; }
+
+                clock = ready_time[pending[0]];
+
+                while (pending_count > 0 && ready_time[pending[0]] <= clock) {
+                    const int id = pop(PENDING);
+                    if (is_alive(id)) { push(READY, id); }
+                }
+            }
+
+            // Collects every living ready unit tied at the highest speed without reordering the heap.
+            // Equal keys form a subtree at the root, so only tied nodes and their direct children are visited.
+            int32_t tied[UNITS];
+            int32_t stack[UNITS];
+            int     tied_count    = 0;
+            int     stack_count   = 0;
+            const Speed top_speed = spe[ready[0]];
+
+            stack[stack_count++] = 0;
+            while (stack_count > 0) {
+                const int i  = stack[--stack_count];
+                const int id = ready[i];
+
+                if (spe[id] != top_speed) continue;
+                if (is_alive(id)) { tied[tied_count++] = id; }
+                if (2 * i + 1 < ready_count) { stack[stack_count++] = 2 * i + 1; }
+                if (2 * i + 2 < ready_count) { stack[stack_count++] = 2 * i + 2; }
+            }
+
+            // Sorts the ties by id, so the draw does not depend on the heap layout.
+            for (int i = 1; i < tied_count; i++) {
+                const int id = tied[i];
+                int j = i;
+                for (; j > 0 && tied[j - 1] > id; j--) { tied[j] = tied[j - 1]; }
+                tied[j] = id;
+            }
+
+            const int chosen = tied[rng.next_below(static_cast<uint32_t>(tied_count))];
+
+            return Intent{ chosen / N, chosen % N };
+        }
+
+        // Empties a unit's turn bar after it acts.
+        void consume_turn(int team_index, int index) {
+            const int id = team_index * N + index;
+
+            if (heap[id] != NONE) { remove(id); }
+
+            if constexpr (FIXED) { ready_time[id] = clock + ticks_to_fill(BAR_TICKS, spe[id]); }
+            else                 { ready_time[id] = clock + 1.0 / static_cast<double>(spe[id]); }
+            push(PENDING, id);
+        }
+
+        // Changes a unit's speed, keeping the progress of its turn bar (e.g. for speed buffs).
+        void set_speed(int team_index, int index, float new_spe) {
+            const int   id    = team_index * N + index;
+            const Speed speed = to_speed(new_spe);
+
+            if (heap[id] == PENDING) {
+                if constexpr (FIXED) {
+                    const int64_t distance = (ready_time[id] - clock) * spe[id];
+                    ready_time[id] = clock + ticks_to_fill(distance, speed);
+                } else {
+                    const double distance = (ready_time[id] - clock) * static_cast<double>(spe[id]);
+                    ready_time[id] = clock + distance / static_cast<double>(speed);
+                }
+            }
+
+            const uint8_t which = heap[id];
+            if (which != NONE) { remove(id); }
+            spe[id] = speed;
+            if (which != NONE) { push(which, id); }
+        }
+
+        // --- Queries ---
+        // Gets a scheduled unit's turn bar at the current clock.
+        float get_turn_bar(int team_index, int index) const {
+            const int id = team_index * N + index;
+
+            if (heap[id] == READY) { return 1.0f; }
+
+            float turn_bar;
+            if constexpr (FIXED) { turn_bar = static_cast<float>(static_cast<double>(BAR_TICKS - (ready_time[id] - clock) * spe[id]) / static_cast<double>(BAR_TICKS)); }
+            else                 { turn_bar = static_cast<float>(1.0 - (ready_time[id] - clock) * static_cast<double>(spe[id])); }
+            return (turn_bar < 0.0f) ? 0.0f : turn_bar;
+        }
+
+        // Gets the clock time a unit takes to fill a number of turn bars at its current speed, e.g. for effect durations.
+        Time get_bar_time(int team_index, int index, float bars) const {
+            const int id = team_index * N + index;
+
+            if constexpr (FIXED) { return ticks_to_fill(static_cast<int64_t>(static_cast<double>(bars) * BAR_TICKS), spe[id]); }
+            else                 { return static_cast<double>(bars) / static_cast<double>(spe[id]); }
+        }
+
+        // Writes the turn bars of all living scheduled units into both character tables.
+        void sync_turn_bars(CharacterTable<N>& ally_ct, CharacterTable<N>& opponent_ct) const {
+            CharacterTable<N>* tables[2] = { &ally_ct, &opponent_ct };
+
+            for (int team_index = 0; team_index < 2; team_index++) {
+                CharacterTable<N>& ct = *tables[team_index];
+
+                for (int index = 0; index < N; index++) {
+                    if (heap[team_index * N + index] == NONE || ct.life[index] <= 0.0f) continue;
+                    ct.turn_bar[index] = get_turn_bar(team_index, index);
+                }
+            }
+        }
+
+        // Previews up to max_count actors that follow current_actor, assuming no deaths or speed changes.
+        // Runs on copies of the heaps and of rng, so the live battle and its random stream are untouched.
+        // Returns the number of actors written.
+        int forecast(Intent* out, int max_count, const Intent& current_actor, BattleRng rng, const CharacterTable<N>& ally_ct, const CharacterTable<N>& opponent_ct) const {
+            AtbScheduler preview = *this;
+            int written = 0;
+
+            preview.consume_turn(current_actor.owner_team_index, current_actor.owner_index);
+
+            while (written < max_count) {
+                const Intent actor = preview.next(rng, ally_ct, opponent_ct);
+                if (actor.owner_team_index < 0) break;
+
+                out[written++] = actor;
+                preview.consume_turn(actor.owner_team_index, actor.owner_index);
+            }
+
+            return written;
+        }
+
+    private:
+        // --- Internal time logic ---
+        // Converts a CharacterTable speed to the clock's speed. Fixed-point speeds truncate to 1/SPEED_ONE steps,
+        // which is exact for the power-of-two scale, and stay at least one step so every unit can still act.
+        static Speed to_speed(float value) {
+            if constexpr (FIXED) {
+                const double scaled = static_cast<double>(value) * SPEED_ONE;
+                return (scaled >= 1.0) ? static_cast<int64_t>(scaled) : 1;
+            } else {
+                return value;
+            }
+        }
+
+        // Gets the whole ticks a unit needs to gain a number of bar units at a fixed-point speed, rounded up.
+        static int64_t ticks_to_fill(int64_t bar_units, int64_t speed) {
+            return (bar_units <= 0) ? 0 : (bar_units + speed - 1) / speed;
+        }
+
+        // --- Internal heap logic ---
+        // Checks whether unit a sorts above unit b in a heap.
+        bool before(uint8_t which, int a, int b) const {
+            if (which == PENDING) { return (ready_time[a] < ready_time[b]) || (ready_time[a] == ready_time[b] && a < b); }
+            return (spe[a] > spe[b]) || (spe[a] == spe[b] && a < b);
+        }
+
+        // Gets a heap's storage and size.
+        int32_t* items(uint8_t which) { return (which == PENDING) ? pending : ready; }
+        int32_t& count(uint8_t which) { return (which == PENDING) ? pending_count : ready_count; }
+
+        // Moves the unit at position i towards the root until its parent sorts above it.
+        void sift_up(uint8_t which, int i) {
+            int32_t* h = items(which);
+            const int id = h[i];
+
+            while (i > 0) {
+                const int parent = (i - 1) / 2;
+                if (!before(which, id, h[parent])) break;
+                h[i] = h[parent];
+                slot[h[i]] = i;
+                i = parent;
+            }
+
+            h[i]     = id;
+            slot[id] = i;
+        }
+
+        // Moves the unit at position i towards the leaves until it sorts above both children.
+        void sift_down(uint8_t which, int i) {
+            int32_t* h = items(which);
+            const int n  = count(which);
+            const int id = h[i];
+
+            while (true) {
+                int child = 2 * i + 1;
+                if (child >= n) break;
+                if (child + 1 < n && before(which, h[child + 1], h[child])) { child++; }
+                if (!before(which, h[child], id)) break;
+                h[i] = h[child];
+                slot[h[i]] = i;
+                i = child;
+            }
+
+            h[i]     = id;
+            slot[id] = i;
+        }
+
+        // Inserts a unit into a heap.
+        void push(uint8_t which, int id) {
+            const int i = count(which)++;
+            items(which)[i] = id;
+            heap[id] = which;
+            sift_up(which, i);
+        }
+
+        // Removes and returns the unit at the top of a heap.
+        int pop(uint8_t which) {
+            const int id = items(which)[0];
+            remove(id);
+            return id;
+        }
+
+        // Removes a unit from whichever heap holds it.
+        void remove(int id) {
+            const uint8_t which = heap[id];
+            int32_t* h = items(which);
+            const int i    = slot[id];
+            const int last = --count(which);
+
+            heap[id] = NONE;
+            if (i == last) return;
+
+            const int moved = h[last];
+            h[i]        = moved;
+            slot[moved] = i;
+            sift_up(which, i);
+            sift_down(which, slot[moved]);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,437 @@
+// BatchCombatEngine
+// -----------------
+// Runs LANES independent 5v5 battles in lockstep for bulk simulation.
+// - Stores both sides in WideCharacterTables, so the scheduler clock/pick and the damage-apply
+//   loop each run as one vector operation across battles instead of scalar per-battle loops.
+// - Battles that have ended are masked out; their lanes stay untouched until every lane finishes.
+// - Follows the same rules, random stream and float operation order as CombatEngine, so a lane
+//   reproduces the CombatEngine battle with the same seed and intents bit for bit.
+// - Skills are lowered to a lane-wise damage description when a lane is set up; lanes whose
+//   skills have no lowering are rejected and must run on CombatEngine.
+//
+// Every inner loop runs over lanes with selects instead of branches, so compilers can emit one
+// SSE/AVX2/NEON operation per vector of battles.
+
+#include <cstring>
+#include <limits>
+
+#include "batch_combat_engine.h"
+
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/data/enums/type_enums.h"
+
+namespace pipelinepunch {
+
+    // Represents the lane-wise lowering of an ActiveEventBuilder's damage formula.
+    // Damage is power * atk / def, with undead_power replacing power against TypeEnum::UNDEAD.
+    struct WideSkill {
+        float is_aoe;
+        float power;
+        float undead_power;
+    };
+
+    // Gets the lane-wise lowering of a skill's ActiveEventBuilder, returning false if it has none.
+    static bool get_wide_skill(SkillEnum skill_enum, WideSkill& wide_skill) {
+        switch (skill_enum) {
+            case SkillEnum::DEMO_ATTACK: wide_skill = { 0.0f, 200.0f, 400.0f }; return true;
+            case SkillEnum::DEMO_CLEAVE: wide_skill = { 1.0f, 100.0f, 200.0f }; return true;
+            default:                     return false;
+        }
+    }
+
+    // --- Entry Points ---
+    // Registers a battle in a lane, returning false if a skill has no lane-wise lowering.
+    template <int LANES>
+    bool BatchCombatEngine<LANES>::setup_lane(int lane, const std::array<const CharacterSheet*, 5>& ally_sheets, const std::array<const CharacterSheet*, 5>& opponent_sheets, uint64_t seed_value) {
+        const std::array<const CharacterSheet*, 5>* sides[2] = { &ally_sheets, &opponent_sheets };
+
+        for (int team_index = 0; team_index < 2; team_index++) {
+            WideCharacterTable<5, LANES>& wt = table[team_index];
+
+            for (int pos = 0; pos < 5; pos++) {
+                const CharacterSheet* cs = (*sides[team_index])[pos];
+
+                wt.turn_bar[pos][lane] = 0.0f;
+                wt.life_bar[pos][lane] = 1.0f;
+
+                if (!cs) {
+                    // Empty slots hold no life, so the scheduler and state checks skip them.
+                    // LP and DEF stay at 1 so the lane-wide divisions never divide by zero.
+                    wt.spe[pos][lane]    = 0.0f;
+                    wt.life[pos][lane]   = 0.0f;
+                    wt.lp[pos][lane]     = 1.0f;
+                    wt.atk[pos][lane]    = 0.0f;
+                    wt.def[pos][lane]    = 1.0f;
+                    wt.undead[pos][lane] = 0.0f;
+
+                    for (int slot = 0; slot < SKILL_SLOTS; slot++) { skill_valid[team_index][pos][slot][lane] = 0; }
+                    continue;
+                }
+
+                wt.spe[pos][lane]    = cs->stats.spe;
+                wt.life[pos][lane]   = cs->stats.lp;
+                wt.lp[pos][lane]     = cs->stats.lp;
+                wt.atk[pos][lane]    = cs->stats.atk;
+                wt.def[pos][lane]    = cs->stats.def;
+                wt.undead[pos][lane] = (cs->creature_sheet.type == TypeEnum::UNDEAD) ? 1.0f : 0.0f;
+
+                for (int slot = 0; slot < SKILL_SLOTS; slot++) {
+                    const ActiveEventBuilder builder = cs->skills.active_event_builder[slot];
+                    WideSkill wide_skill { 0.0f, 0.0f, 0.0f };
+
+                    if (builder && !get_wide_skill(cs->skills.skill_enum[slot], wide_skill)) {
+                        clear_lane(lane);
+                        return false;
+                    }
+
+                    skill_is_aoe[team_index][pos][slot][lane]       = wide_skill.is_aoe;
+                    skill_power[team_index][pos][slot][lane]        = wide_skill.power;
+                    skill_undead_power[team_index][pos][slot][lane] = wide_skill.undead_power;
+                    skill_valid[team_index][pos][slot][lane]        = builder ? 1 : 0;
+                }
+            }
+        }
+
+        used[lane]              = 1;
+        running[lane]           = 0;
+        seed[lane]              = seed_value;
+        winner_team_index[lane] = -1;
+        turn_count[lane]        = 0;
+        actor_team_index[lane]  = 0;
+        actor_index[lane]       = 0;
+        return true;
+    }
+
+    // Leaves a lane empty for this batch.
+    template <int LANES>
+    void BatchCombatEngine<LANES>::clear_lane(int lane) {
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                table[team_index].turn_bar[pos][lane] = 0.0f;
+                table[team_index].spe[pos][lane]      = 0.0f;
+                table[team_index].life[pos][lane]     = 0.0f;
+                table[team_index].life_bar[pos][lane] = 1.0f;
+                table[team_index].lp[pos][lane]       = 1.0f;
+                table[team_index].atk[pos][lane]      = 0.0f;
+                table[team_index].def[pos][lane]      = 1.0f;
+                table[team_index].undead[pos][lane]   = 0.0f;
+
+                for (int slot = 0; slot < SKILL_SLOTS; slot++) {
+                    skill_is_aoe[team_index][pos][slot][lane]       = 0.0f;
+                    skill_power[team_index][pos][slot][lane]        = 0.0f;
+                    skill_undead_power[team_index][pos][slot][lane] = 0.0f;
+                    skill_valid[team_index][pos][slot][lane]        = 0;
+                }
+            }
+        }
+
+        used[lane]              = 0;
+        running[lane]           = 0;
+        seed[lane]              = 0;
+        winner_team_index[lane] = -1;
+        turn_count[lane]        = 0;
+        actor_team_index[lane]  = 0;
+        actor_index[lane]       = 0;
+    }
+
+    // Initialises life and turn bars, then selects the first actor in every used lane.
+    template <int LANES>
+    void BatchCombatEngine<LANES>::roll_initiative() {
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    table[team_index].life_bar[pos][lane] = 1.0f;
+                    table[team_index].turn_bar[pos][lane] = 0.0f;
+                    ready_time[team_index][pos][lane]     = 1.0 / static_cast<double>(table[team_index].spe[pos][lane]);
+                }
+            }
+        }
+
+        for (int lane = 0; lane < LANES; lane++) {
+            clock[lane]             = 0.0;
+            running[lane]           = used[lane];
+            winner_team_index[lane] = -1;
+            turn_count[lane]        = 0;
+            rng[lane].seed(seed[lane]);
+        }
+
+        state_check();
+        get_next_character();
+    }
+
+    // Resolves one turn in every running lane, then advances each to its next actor.
+    template <int LANES>
+    void BatchCombatEngine<LANES>::turn(const int (&skill_slot)[LANES], const int (&target_pos)[LANES]) {
+        alignas(64) float   owner_atk[LANES];
+        alignas(64) float   is_aoe[LANES];
+        alignas(64) float   power[LANES];
+        alignas(64) float   undead_power[LANES];
+        alignas(64) int32_t target[LANES];
+
+        // Gathers each lane's actor and skill; this is the only per-lane indirection in a turn.
+        for (int lane = 0; lane < LANES; lane++) {
+            const int team_index = actor_team_index[lane];
+            const int index      = actor_index[lane];
+            const int slot       = running[lane] ? skill_slot[lane] : 0;
+
+            owner_atk[lane]    = table[team_index].atk[index][lane];
+            is_aoe[lane]       = skill_is_aoe[team_index][index][slot][lane];
+            power[lane]        = skill_power[team_index][index][slot][lane];
+            undead_power[lane] = skill_undead_power[team_index][index][slot][lane];
+            target[lane]       = target_pos[lane];
+        }
+
+        // Applies damage to every unit of both sides across all lanes.
+        // - power * atk stays below 2^24, so truncating the float quotient equals the builders' integer division.
+        // - Life values are clamped between 0 and max LP, and life_bar values between 0 and 1.
+        // - life_bar is recomputed from the final life of every unit; for units that were not hit this gives back
+        //   the value already stored, and keeping the division unconditional lets compilers vectorize the loop.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            WideCharacterTable<5, LANES>& wt = table[team_index];
+
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const bool  is_other = (running[lane] != 0) & (actor_team_index[lane] != team_index);
+                    const bool  alive    = wt.life[pos][lane] > 0.0f;
+                    const bool  aoe      = is_aoe[lane] != 0.0f;
+                    const bool  targeted = (aoe & alive) | (!aoe & (target[lane] == pos));
+                    const float scale    = (wt.undead[pos][lane] != 0.0f) ? undead_power[lane] : power[lane];
+                    const float damage   = static_cast<float>(static_cast<int32_t>(scale * owner_atk[lane] / wt.def[pos][lane]));
+
+                    float new_life = wt.life[pos][lane] - damage;
+                    new_life = (new_life < 0.0f)              ? 0.0f              : new_life;
+                    new_life = (new_life > wt.lp[pos][lane]) ? wt.lp[pos][lane] : new_life;
+
+                    const bool  apply = is_other & targeted & (damage > 0.0f);
+                    const float life  = apply ? new_life : wt.life[pos][lane];
+
+                    wt.life[pos][lane]     = life;
+                    wt.life_bar[pos][lane] = life / wt.lp[pos][lane];
+                }
+            }
+        }
+
+        // Consumes the active unit's turn bar, schedules its next turn and counts the turn.
+        for (int lane = 0; lane < LANES; lane++) {
+            if (!running[lane]) continue;
+
+            const int team_index = actor_team_index[lane];
+            const int index      = actor_index[lane];
+
+            table[team_index].turn_bar[index][lane] = 0.0f;
+            ready_time[team_index][index][lane]     = clock[lane] + 1.0 / static_cast<double>(table[team_index].spe[index][lane]);
+            turn_count[lane]++;
+        }
+
+        state_check();
+        get_next_character();
+    }
+
+    // Ends a lane as a draw (e.g. on a turn cap).
+    template <int LANES>
+    void BatchCombatEngine<LANES>::stop_lane(int lane) {
+        running[lane]           = 0;
+        winner_team_index[lane] = -1;
+    }
+
+    // --- Queries ---
+    // Checks whether any lane is still running.
+    template <int LANES>
+    bool BatchCombatEngine<LANES>::any_running() const {
+        int32_t any = 0;
+        for (int lane = 0; lane < LANES; lane++) { any |= running[lane]; }
+        return any != 0;
+    }
+
+    // Checks whether a lane is still running.
+    template <int LANES>
+    bool BatchCombatEngine<LANES>::is_running(int lane) const { return running[lane] != 0; }
+
+    // Checks whether a unit can still act in a lane.
+    template <int LANES>
+    bool BatchCombatEngine<LANES>::is_alive(int lane, int team_index, int pos) const { return table[team_index].life[pos][lane] > 0.0f; }
+
+    // Checks whether a unit has a skill in a slot.
+    template <int LANES>
+    bool BatchCombatEngine<LANES>::has_skill(int lane, int team_index, int pos, int skill_slot) const { return skill_valid[team_index][pos][skill_slot][lane] != 0; }
+
+    // Gets the team index of a lane's current actor.
+    template <int LANES>
+    int BatchCombatEngine<LANES>::get_actor_team_index(int lane) const { return actor_team_index[lane]; }
+
+    // Gets the SoA index of a lane's current actor.
+    template <int LANES>
+    int BatchCombatEngine<LANES>::get_actor_index(int lane) const { return actor_index[lane]; }
+
+    // Gets a lane's winning team index, or -1 while running or on a draw.
+    template <int LANES>
+    int BatchCombatEngine<LANES>::get_winner_team_index(int lane) const { return winner_team_index[lane]; }
+
+    // Gets the number of turns a lane has resolved.
+    template <int LANES>
+    int BatchCombatEngine<LANES>::get_turn_count(int lane) const { return turn_count[lane]; }
+
+    // Gets the same state hash CombatEngine::get_state_hash gives for this battle.
+    template <int LANES>
+    uint64_t BatchCombatEngine<LANES>::get_state_hash(int lane) const {
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        // Folds a 32-bit word into the FNV-1a hash.
+        auto mix = [&hash](uint32_t word) {
+            for (int byte = 0; byte < 4; byte++) {
+                hash ^= (word >> (byte * 8)) & 0xFFu;
+                hash *= 0x100000001B3ull;
+            }
+        };
+
+        // Folds a float into the hash by bit pattern.
+        auto mix_float = [&mix](float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            mix(bits);
+        };
+
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                mix_float(table[team_index].life[pos][lane]);
+                mix_float(table[team_index].turn_bar[pos][lane]);
+            }
+        }
+
+        mix(static_cast<uint32_t>(turn_count[lane]));
+        mix(static_cast<uint32_t>(actor_team_index[lane]));
+        mix(static_cast<uint32_t>(actor_index[lane]));
+        mix(static_cast<uint32_t>(rng[lane].state));
+        mix(static_cast<uint32_t>(rng[lane].state >> 32));
+
+        return hash;
+    }
+
+    // --- Internal logic ---
+    // Ends every lane in which a side has no living units.
+    template <int LANES>
+    void BatchCombatEngine<LANES>::state_check() {
+        alignas(64) int32_t alive[2][LANES] = {};
+
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) { alive[team_index][lane] |= (table[team_index].life[pos][lane] > 0.0f) ? 1 : 0; }
+            }
+        }
+
+        for (int lane = 0; lane < LANES; lane++) {
+            if (!running[lane] || (alive[0][lane] && alive[1][lane])) continue;
+
+            winner_team_index[lane] = alive[0][lane] ? 0 : (alive[1][lane] ? 1 : -1);
+            running[lane]           = 0;
+        }
+    }
+
+    // Advances each lane's ATB clock and picks the next actor in every running lane.
+    // - Matches CombatEngine's AtbScheduler: a unit is ready once its ready time is at or before the lane's clock,
+    //   and the clock only advances, to the earliest ready time, when no living unit is ready.
+    // - Ties at the highest speed draw from the lane's random stream and resolve in the same team/index order.
+    // - Turn bars are derived from the clock with the scheduler's formula, so both engines hash identically.
+    template <int LANES>
+    void BatchCombatEngine<LANES>::get_next_character() {
+        alignas(64) int32_t candidate[2][5][LANES];
+        alignas(64) double  earliest[LANES];
+        alignas(64) float   highest_speed[LANES];
+        alignas(64) int32_t found_ready[LANES];
+        alignas(64) int32_t candidates_count[LANES];
+        alignas(64) int32_t pick[LANES];
+        alignas(64) int32_t rank[LANES];
+
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        for (int lane = 0; lane < LANES; lane++) {
+            earliest[lane]         = infinity;
+            highest_speed[lane]    = -1.0f;
+            found_ready[lane]      = 0;
+            candidates_count[lane] = 0;
+            rank[lane]             = 0;
+        }
+
+        // Records whether any living unit is already ready, and the earliest ready time among living units.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const double time  = ready_time[team_index][pos][lane];
+                    const bool   alive = table[team_index].life[pos][lane] > 0.0f;
+
+                    found_ready[lane] |= (alive & (time <= clock[lane])) ? 1 : 0;
+                    earliest[lane]     = (alive & (time < earliest[lane])) ? time : earliest[lane];
+                }
+            }
+        }
+
+        // Advances the clock of running lanes with no ready unit.
+        for (int lane = 0; lane < LANES; lane++) {
+            clock[lane] = (running[lane] & (found_ready[lane] ^ 1)) ? earliest[lane] : clock[lane];
+        }
+
+        // Marks the ready units and tracks the highest speed among them.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const float spe   = table[team_index].spe[pos][lane];
+                    const bool  alive = table[team_index].life[pos][lane] > 0.0f;
+                    const bool  ready = alive & (ready_time[team_index][pos][lane] <= clock[lane]);
+
+                    candidate[team_index][pos][lane] = ready ? 1 : 0;
+                    highest_speed[lane]              = (ready & (spe > highest_speed[lane])) ? spe : highest_speed[lane];
+                }
+            }
+        }
+
+        // Keeps only the ready units tied at the highest speed, and counts them.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const bool tied = (candidate[team_index][pos][lane] != 0) & (table[team_index].spe[pos][lane] == highest_speed[lane]);
+
+                    candidate[team_index][pos][lane] = tied ? 1 : 0;
+                    candidates_count[lane]          += tied ? 1 : 0;
+                }
+            }
+        }
+
+        // Draws the tie-break from each running lane's stream.
+        for (int lane = 0; lane < LANES; lane++) {
+            pick[lane] = running[lane] ? static_cast<int32_t>(rng[lane].next_below(candidates_count[lane])) : -1;
+        }
+
+        // Selects the drawn candidate in team/index order.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const bool tied   = candidate[team_index][pos][lane] != 0;
+                    const bool chosen = tied & (rank[lane] == pick[lane]);
+
+                    actor_team_index[lane] = chosen ? team_index : actor_team_index[lane];
+                    actor_index[lane]      = chosen ? pos        : actor_index[lane];
+                    rank[lane]            += tied ? 1 : 0;
+                }
+            }
+        }
+
+        // Writes the derived turn bars of living units in running lanes.
+        for (int team_index = 0; team_index < 2; team_index++) {
+            for (int pos = 0; pos < 5; pos++) {
+                for (int lane = 0; lane < LANES; lane++) {
+                    const double time    = ready_time[team_index][pos][lane];
+                    const bool   alive   = table[team_index].life[pos][lane] > 0.0f;
+                    const bool   sync    = (running[lane] != 0) & alive;
+                    const float  pending = static_cast<float>(1.0 - (time - clock[lane]) * static_cast<double>(table[team_index].spe[pos][lane]));
+                    const float  bar     = (time <= clock[lane]) ? 1.0f : ((pending < 0.0f) ? 0.0f : pending);
+
+                    table[team_index].turn_bar[pos][lane] = sync ? bar : table[team_index].turn_bar[pos][lane];
+                }
+            }
+        }
+    }
+
+    // --- Instantiations ---
+    template class BatchCombatEngine<8>;  // One AVX2 register (or two SSE/NEON registers) of battles.
+    template class BatchCombatEngine<16>; // One AVX-512 register (or two AVX2 registers) of battles.
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+// BatchCombatEngine
+// -----------------
+// Runs LANES independent 5v5 battles in lockstep for bulk simulation.
+// - Stores both sides in WideCharacterTables, so the scheduler clock/pick and the damage-apply
+//   loop each run as one vector operation across battles instead of scalar per-battle loops.
+// - Battles that have ended are masked out; their lanes stay untouched until every lane finishes.
+// - Follows the same rules, random stream and float operation order as CombatEngine, so a lane
+//   reproduces the CombatEngine battle with the same seed and intents bit for bit.
+// - Skills are lowered to a lane-wise damage description when a lane is set up; lanes whose
+//   skills have no lowering are rejected and must run on CombatEngine.
+
+#include <array>
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/wide_character_table.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    // Represents LANES battles running in lockstep.
+    template <int LANES>
+    class BatchCombatEngine {
+    public:
+        // --- Entry Points ---
+        bool setup_lane(int lane,                                                  // Registers a battle in a lane, returning false if a skill has no lane-wise lowering.
+                        const std::array<const CharacterSheet*, 5>& ally_sheets,
+                        const std::array<const CharacterSheet*, 5>& opponent_sheets,
+                        uint64_t seed);
+        void clear_lane(int lane);                                                 // Leaves a lane empty for this batch.
+        void roll_initiative();                                                    // Initialises life and turn bars, then selects the first actor in every used lane.
+        void turn(const int (&skill_slot)[LANES], const int (&target_pos)[LANES]); // Resolves one turn in every running lane, then advances each to its next actor.
+        void stop_lane(int lane);                                                  // Ends a lane as a draw (e.g. on a turn cap).
+
+        // --- Queries ---
+        bool     any_running() const;                                   // Checks whether any lane is still running.
+        bool     is_running(int lane) const;                            // Checks whether a lane is still running.
+        bool     is_alive(int lane, int team_index, int pos) const;     // Checks whether a unit can still act in a lane.
+        bool     has_skill(int lane, int team_index, int pos, int skill_slot) const; // Checks whether a unit has a skill in a slot.
+        int      get_actor_team_index(int lane) const;                  // Gets the team index of a lane's current actor.
+        int      get_actor_index(int lane) const;                       // Gets the SoA index of a lane's current actor.
+        int      get_winner_team_index(int lane) const;                 // Gets a lane's winning team index, or -1 while running or on a draw.
+        int      get_turn_count(int lane) const;                        // Gets the number of turns a lane has resolved.
+        uint64_t get_state_hash(int lane) const;                        // Gets the same state hash CombatEngine::get_state_hash gives for this battle.
+
+    private:
+        // --- Runtime Wide Character Tables ---
+        WideCharacterTable<5, LANES> table[2];
+
+        // --- Lane-wise Skill Descriptions ---
+        alignas(64) float   skill_is_aoe[2][5][SKILL_SLOTS][LANES];
+        alignas(64) float   skill_power[2][5][SKILL_SLOTS][LANES];
+        alignas(64) float   skill_undead_power[2][5][SKILL_SLOTS][LANES];
+        alignas(64) int32_t skill_valid[2][5][SKILL_SLOTS][LANES];
+
+        // --- Runtime ATB Clocks (as in AtbScheduler) ---
+        alignas(64) double clock[LANES];
+        alignas(64) double ready_time[2][5][LANES];
+
+        // --- Runtime Lane State ---
+        alignas(64) int32_t running[LANES];
+        alignas(64) int32_t used[LANES];
+        alignas(64) int32_t actor_team_index[LANES];
+        alignas(64) int32_t actor_index[LANES];
+        int32_t             winner_team_index[LANES];
+        int32_t             turn_count[LANES];
+        uint64_t            seed[LANES];
+        BattleRng           rng[LANES];
+
+        // --- Internal logic ---
+        void state_check();        // Ends every lane in which a side has no living units.
+        void get_next_character(); // Advances turn bars and picks the next actor in every running lane.
+    };
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+// BattleContext
+// -------------
+// Holds the per-battle event queues and is passed explicitly to every event builder.
+// - Replaces the global CombatSystem lookup, so independent battles never share mutable state.
+// - Each CombatEngine owns exactly one context; builders only ever see the context of the battle
+//   they are running in, which makes battles safe to run concurrently on different threads.
+// - Every event of a turn lives in the context's EventArena; the queues hold its slots. Builders reserve an event
+//   with emplace_*_event and fill it in place. The arena is reset at the start of each turn, and the reactions of
+//   each main event are freed before the next main event's cascade, so the arena never fills before a queue.
+// - Queue capacities come from the battle's CombatConfig; a push into a full queue is dropped and counted.
+
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/systems/combat_system/structs/event.h"
+#include "pipelinepunch/systems/combat_system/structs/event_arena.h"
+#include "pipelinepunch/systems/combat_system/structs/event_queue.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the event state of a single battle.
+    template <typename Config>
+    struct BattleContext {
+        static constexpr int N            = Config::TEAM_SIZE;
+        static constexpr int ARENA_EVENTS = Config::MAIN_EVENTS + Config::FAST_EVENTS_PLUS + Config::FAST_EVENTS
+                                          + Config::SLOW_EVENTS_PLUS + Config::SLOW_EVENTS; // Events a turn holds at once, at most.
+
+        // --- Runtime Event Storage ---
+        EventArena<ARENA_EVENTS, N> arena;
+        int                         cascade_base { -1 }; // Arena mark after the turn's main events; -1 before the first cascade.
+
+        // --- Runtime Event Queues ---
+        EventQueue<Config::FAST_EVENTS_PLUS, N> fast_event_queue_plus;
+        EventQueue<Config::FAST_EVENTS, N>      fast_event_queue;
+        EventQueue<Config::MAIN_EVENTS, N>      main_event_queue;
+        EventQueue<Config::SLOW_EVENTS_PLUS, N> slow_event_queue_plus;
+        EventQueue<Config::SLOW_EVENTS, N>      slow_event_queue;
+
+        // --- Event emplacing ---
+        // Each reserves a cleared event for an intent in a queue and returns it to be filled in place, or returns
+        // nullptr if the queue was full.
+        Event<N>* emplace_fast_event_plus(const Intent& intent) { return emplace(fast_event_queue_plus, intent); }
+        Event<N>* emplace_fast_event(const Intent& intent)      { return emplace(fast_event_queue, intent); }
+        Event<N>* emplace_main_event(const Intent& intent)      { return emplace(main_event_queue, intent); }
+        Event<N>* emplace_slow_event_plus(const Intent& intent) { return emplace(slow_event_queue_plus, intent); }
+        Event<N>* emplace_slow_event(const Intent& intent)      { return emplace(slow_event_queue, intent); }
+
+        // --- Event pushing ---
+        // Copies an event built elsewhere; emplacing avoids the copy.
+        bool push_fast_event_plus(const Event<N>& e) { return push(fast_event_queue_plus, e); } // Pushes an event to the fast_event_queue_plus; false if it was full.
+        bool push_fast_event(const Event<N>& e)      { return push(fast_event_queue, e); }      // Pushes an event to the fast_event_queue; false if it was full.
+        bool push_main_event(const Event<N>& e)      { return push(main_event_queue, e); }      // Pushes an event to the main_event_queue; false if it was full.
+        bool push_slow_event_plus(const Event<N>& e) { return push(slow_event_queue_plus, e); } // Pushes an event to the slow_event_queue_plus; false if it was full.
+        bool push_slow_event(const Event<N>& e)      { return push(slow_event_queue, e); }      // Pushes an event to the slow_event_queue; false if it was full.
+
+        // --- Queries ---
+        // Gets the i-th event of a queue.
+        template <int CAPACITY>
+        Event<N>&       get_event(const EventQueue<CAPACITY, N>& queue, int i)       { return arena.event[queue.slot[i]]; }
+        template <int CAPACITY>
+        const Event<N>& get_event(const EventQueue<CAPACITY, N>& queue, int i) const { return arena.event[queue.slot[i]]; }
+
+        // --- Turn lifecycle ---
+        // Frees every event and empties the main_event_queue, before a turn's main events are built.
+        void begin_turn() {
+            arena.reset();
+            main_event_queue.clear();
+            cascade_base = -1;
+        }
+
+        // Empties the reaction queues and frees the reactions of the previous cascade, before a main event's cascade.
+        void begin_cascade() {
+            if (cascade_base < 0) { cascade_base = arena.mark(); }
+            else                  { arena.rewind(cascade_base); }
+
+            fast_event_queue_plus.clear();
+            fast_event_queue.clear();
+            slow_event_queue_plus.clear();
+            slow_event_queue.clear();
+        }
+
+    private:
+        template <int CAPACITY>
+        Event<N>* emplace(EventQueue<CAPACITY, N>& queue, const Intent& intent) {
+            Event<N>* e = queue.emplace_event(arena);
+            if (e) { e->intent.pack(intent); }
+            return e;
+        }
+
+        template <int CAPACITY>
+        bool push(EventQueue<CAPACITY, N>& queue, const Event<N>& e) {
+            Event<N>* slot = queue.emplace_event(arena);
+            if (slot) { *slot = e; }
+            return slot != nullptr;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+// BattleRng
+// ---------
+// Fast, seedable and splittable random stream owned by a single battle.
+// - Based on SplitMix64 (the SplittableRandom generator): a 64-bit counter advanced by an odd gamma
+//   and finalised by a bijective mixer.
+// - Uses only 64-bit integer arithmetic, so a seed produces the same stream on x86 and ARM.
+// - split() derives an independent child stream, letting tools hand each battle or policy its own
+//   stream without sharing state between threads.
+
+#include <cstdint>
+
+namespace pipelinepunch {
+
+    // Represents a per-battle random stream.
+    struct BattleRng {
+        static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+        uint64_t state { 0 };
+        uint64_t gamma { GOLDEN_GAMMA };
+
+        // Resets the stream to the start of a seed.
+        void seed(uint64_t seed_value) {
+            state = seed_value;
+            gamma = GOLDEN_GAMMA;
+        }
+
+        // Gets the next 64 random bits.
+        uint64_t next_u64() { return mix64(state += gamma); }
+
+        // Gets the next 32 random bits.
+        uint32_t next_u32() { return static_cast<uint32_t>(next_u64() >> 32); }
+
+        // Gets a value in [0, bound) using a multiply-shift reduction (no division, no platform-dependent modulo).
+        uint32_t next_below(uint32_t bound) { return static_cast<uint32_t>((static_cast<uint64_t>(next_u32()) * bound) >> 32); }
+
+        // Splits off an independent child stream, advancing this stream by two draws.
+        BattleRng split() {
+            BattleRng child;
+            child.state = next_u64();
+            child.gamma = mix_gamma(next_u64());
+            return child;
+        }
+
+        // Derives the seed of the index-th child of a root seed without touching any stream.
+        static uint64_t derive_seed(uint64_t root_seed, uint64_t index) { return mix64(root_seed + (index + 1) * GOLDEN_GAMMA); }
+
+        // Finalises a counter value into 64 well-mixed bits.
+        static uint64_t mix64(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Derives an odd gamma with enough bit transitions to keep child streams well distributed.
+        static uint64_t mix_gamma(uint64_t z) {
+            z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDull;
+            z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ull;
+            z = (z ^ (z >> 33)) | 1ull;
+            return (popcount64(z ^ (z >> 1)) < 24) ? (z ^ 0xAAAAAAAAAAAAAAAAull) : z;
+        }
+
+        // Counts set bits without relying on compiler builtins.
+        static int popcount64(uint64_t x) {
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,628 @@
+// Battle Simulator
+// ----------------
+// Headless, Godot-free batch simulator used for balance testing.
+// - Runs the CombatEngine's roll_initiative/turn logic with no engine dependencies.
+// - Spreads battles over all hardware threads, one CombatEngine per worker.
+// - Reports battles/sec plus win-rate and turn-count statistics.
+// - Derives every battle's seed from the root seed and battle index, so results are identical for
+//   any thread count and on any platform; the printed digest makes cross-platform checks cheap.
+//
+// - With --batch, runs SIM_BATCH_LANES battles per worker in lockstep on the BatchCombatEngine.
+//   Both modes produce the same statistics and digest for the same seed.
+// - With --mode, runs one of the CombatConfig instantiations (5v5, 1v20 raids, 30v30 skirmishes).
+// - With --atb fixed, runs the mode's AtbClock::FIXED config, whose turn order is kept in integer ticks.
+// - With --journal, every scalar battle records into a per-worker CombatJournal, to measure its cost.
+//   --journal-dir also flushes each battle's journal to its own file, as input for the replay_verifier.
+// - With --ai-rollouts, opponents play with a per-worker CombatAi capped at that many rollouts per move
+//   (single-threaded and without a time budget, so results stay reproducible), to measure its strength.
+// - With --skills, 5v5 battles run on Config5v5Program with the SkillPrograms compiled from a skill file, so a
+//   data-driven skill can be balanced without a rebuild; programs that mirror the builders keep the digest unchanged.
+// - With --library, creatures come from a CreaturePack mapped in place of the static creature library.
+// - With --effects, the policy also adds a random timed effect, dispel or cooldown before each turn, as items and
+//   field effects would, so effect expiry, journaling and replay run under load.
+// - With --trace, battle 0 is replayed once more on its own with a CombatTrace attached, and its turn phases are
+//   written as Chrome trace event JSON (builds with PIPELINEPUNCH_TRACE only).
+//
+// Usage: battle_simulator [--battles N] [--threads T] [--seed S] [--max-turns M] [--mode 5v5|1v20|30v30]
+//                         [--atb float|fixed] [--allies a,b,...] [--opponents a,b,...] [--verify-replay] [--batch] [--journal]
+//                         [--journal-dir DIR] [--ai-rollouts R] [--skills FILE] [--library FILE] [--trace FILE] [--effects]
+// Party slots are creature ids from the creature library (or pack); -1 leaves a slot empty, as do slots past the end
+// of a list. --batch runs 5v5 only and without --ai-rollouts, --skills, --effects or --atb fixed; --skills runs 5v5
+// only, on the float clock.
+// --verify-replay re-simulates every battle from its seed and counts any state-hash mismatch
+// (in --batch mode the re-simulation runs on the scalar CombatEngine). With --journal it also seeks to the last
+// turn from the journal's snapshots and checks that hash too.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/data/skills/skill_program.h"
+#include "pipelinepunch/systems/combat_system/batch_combat_engine.h"
+#include "pipelinepunch/systems/combat_system/combat_ai.h"
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+
+namespace pipelinepunch {
+
+    constexpr int SIM_CHUNK_SIZE  = 1024; // Battles claimed by a worker per atomic fetch.
+    constexpr int SIM_BATCH_LANES = 8;    // Battles per BatchCombatEngine in --batch mode.
+    constexpr int SIM_MAX_PARTY   = 32;   // Longest party list accepted on the command line.
+
+    // Represents the simulator's command-line configuration.
+    struct SimConfig {
+        uint64_t         battles     { 1000000 };
+        int              threads     { 0 };
+        uint64_t         seed        { 1 };
+        int              max_turns   { 1000 };
+        int              team_size   { 5 };     // TEAM_SIZE of the selected CombatConfig.
+        AtbClock         atb_clock   { AtbClock::FLOAT };
+        std::vector<int> allies;                // Empty until parsed; filled with the mode's default party.
+        std::vector<int> opponents;
+        bool             verify      { false };
+        bool             batch       { false };
+        bool             journal     { false };
+        const char*      journal_dir { nullptr }; // Directory that receives one journal file per battle.
+        int              ai_rollouts { 0 };     // Rollouts per opponent move; 0 keeps the random policy.
+        const char*      skills      { nullptr }; // Skill file compiled into SkillPrograms; nullptr keeps the builders.
+        const char*      library     { nullptr }; // CreaturePack mapped in place of the static creature library.
+        const char*      trace       { nullptr }; // Chrome trace file written for battle 0.
+        bool             effects     { false }; // Adds random timed effects between turns.
+    };
+
+    // Represents the statistics gathered by one worker, merged once all workers finish.
+    struct SimStats {
+        uint64_t              battles        { 0 };
+        uint64_t              ally_wins      { 0 };
+        uint64_t              opponent_wins  { 0 };
+        uint64_t              draws          { 0 };
+        uint64_t              turn_sum       { 0 };
+        uint64_t              digest         { 0 };
+        uint64_t              mismatches     { 0 };
+        std::vector<uint64_t> turn_histogram;
+
+        // Merges another worker's statistics into this one.
+        void merge(const SimStats& other) {
+            battles       += other.battles;
+            ally_wins     += other.ally_wins;
+            opponent_wins += other.opponent_wins;
+            draws         += other.draws;
+            turn_sum      += other.turn_sum;
+            digest        += other.digest;
+            mismatches    += other.mismatches;
+            for (size_t i = 0; i < turn_histogram.size(); i++) { turn_histogram[i] += other.turn_histogram[i]; }
+        }
+    };
+
+    // Parses a comma separated list of creature ids; they are checked against the library once it is loaded.
+    static bool parse_party(const char* text, std::vector<int>& party) {
+        party.clear();
+
+        for (;;) {
+            char* end = nullptr;
+            long  id  = std::strtol(text, &end, 10);
+            if (end == text || id < -1 || id > INT32_MAX || party.size() == SIM_MAX_PARTY) return false;
+
+            party.push_back(static_cast<int>(id));
+            text = end;
+
+            if (*text == '\0') return true;
+            if (*text != ',') return false;
+            text++;
+        }
+    }
+
+    // Checks that every creature id of a party exists in the creature library, or in the loaded pack.
+    static bool party_is_known(const std::vector<int>& party) {
+        CreatureSheet creature;
+        for (int id : party) {
+            if (id >= 0 && !get_creature_sheet(id, creature)) return false;
+        }
+        return true;
+    }
+
+    // Fills any party left unset with the default party of the selected mode.
+    static void apply_default_parties(SimConfig& config) {
+        if (config.team_size == 5) {
+            if (config.allies.empty())    { config.allies    = { 0, 1, 2, 0, 1 }; }
+            if (config.opponents.empty()) { config.opponents = { 2, 1, 0, 2, 1 }; }
+            return;
+        }
+
+        // Raids put a single Orc against a full side; skirmishes fill both sides.
+        if (config.allies.empty()) {
+            if (config.team_size == 20) { config.allies = { 2 }; }
+            else { for (int pos = 0; pos < config.team_size; pos++) { config.allies.push_back(pos % CREATURE_LIBRARY_SIZE); } }
+        }
+        if (config.opponents.empty()) {
+            for (int pos = 0; pos < config.team_size; pos++) { config.opponents.push_back((CREATURE_LIBRARY_SIZE - 1) - pos % CREATURE_LIBRARY_SIZE); }
+        }
+    }
+
+    // Parses command-line arguments into a SimConfig.
+    static bool parse_args(int argc, char** argv, SimConfig& config) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (std::strcmp(arg, "--verify-replay") == 0) {
+                config.verify = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--batch") == 0) {
+                config.batch = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--journal") == 0) {
+                config.journal = true;
+                continue;
+            }
+            if (std::strcmp(arg, "--effects") == 0) {
+                config.effects = true;
+                continue;
+            }
+
+            if (!value) return false;
+
+            if      (std::strcmp(arg, "--battles")     == 0) { config.battles     = std::strtoull(value, nullptr, 10); }
+            else if (std::strcmp(arg, "--threads")     == 0) { config.threads     = std::atoi(value); }
+            else if (std::strcmp(arg, "--seed")        == 0) { config.seed        = std::strtoull(value, nullptr, 10); }
+            else if (std::strcmp(arg, "--max-turns")   == 0) { config.max_turns   = std::max(1, std::atoi(value)); }
+            else if (std::strcmp(arg, "--ai-rollouts") == 0) { config.ai_rollouts = std::max(0, std::atoi(value)); }
+            else if (std::strcmp(arg, "--skills")      == 0) { config.skills      = value; }
+            else if (std::strcmp(arg, "--library")     == 0) { config.library     = value; }
+            else if (std::strcmp(arg, "--journal-dir") == 0) { config.journal_dir = value; config.journal = true; }
+            else if (std::strcmp(arg, "--trace")       == 0) { config.trace       = value; }
+            else if (std::strcmp(arg, "--mode")        == 0) {
+                if      (std::strcmp(value, "5v5")   == 0) { config.team_size = Config5v5::TEAM_SIZE; }
+                else if (std::strcmp(value, "1v20")  == 0) { config.team_size = Config1v20::TEAM_SIZE; }
+                else if (std::strcmp(value, "30v30") == 0) { config.team_size = Config30v30::TEAM_SIZE; }
+                else return false;
+            }
+            else if (std::strcmp(arg, "--atb")         == 0) {
+                if      (std::strcmp(value, "float") == 0) { config.atb_clock = AtbClock::FLOAT; }
+                else if (std::strcmp(value, "fixed") == 0) { config.atb_clock = AtbClock::FIXED; }
+                else return false;
+            }
+            else if (std::strcmp(arg, "--allies")      == 0) { if (!parse_party(value, config.allies))    return false; }
+            else if (std::strcmp(arg, "--opponents")   == 0) { if (!parse_party(value, config.opponents)) return false; }
+            else return false;
+
+            i++;
+        }
+
+        apply_default_parties(config);
+
+        const size_t team_size = static_cast<size_t>(config.team_size);
+        const bool   fixed     = config.atb_clock == AtbClock::FIXED;
+        return config.allies.size() <= team_size && config.opponents.size() <= team_size
+            && (!config.batch  || (team_size == 5 && config.ai_rollouts == 0 && !config.skills && !config.effects && !fixed))
+            && (!config.skills || (team_size == 5 && !fixed));
+    }
+
+    // Builds the runtime CharacterSheets for a party of creature ids.
+    template <size_t N>
+    static void build_party(const std::vector<int>& creature_ids, std::array<CharacterSheet, N>& sheets, std::array<const CharacterSheet*, N>& slots) {
+        for (size_t pos = 0; pos < N; pos++) {
+            if (pos >= creature_ids.size() || creature_ids[pos] < 0) {
+                slots[pos] = nullptr;
+                continue;
+            }
+
+            sheets[pos] = CharacterSheet{};
+            get_creature_sheet(creature_ids[pos], sheets[pos].creature_sheet);
+
+            const CreatureSheet& creature = sheets[pos].creature_sheet;
+            sheets[pos].stats          = creature.stats;
+            sheets[pos].skills         = creature.skills;
+            slots[pos] = &sheets[pos];
+        }
+    }
+
+    // Adds a random timed effect before a turn, as an item or field effect would: a one- or two-turn cooldown on one
+    // of the actor's skill slots, a buff or debuff on one of the low 8 bits lasting one to four bars, a dispel of
+    // those bits, or nothing. Effects on dead or empty slots are refused by the engine and change nothing.
+    template <typename Config>
+    static void add_random_effect(CombatEngine<Config>& engine, BattleRng& policy_rng) {
+        const Intent& intent     = engine.get_main_intent();
+        const int     team_index = static_cast<int>(policy_rng.next_below(2));
+        const int     index      = static_cast<int>(policy_rng.next_below(Config::TEAM_SIZE));
+
+        switch (policy_rng.next_below(4)) {
+            case 0:  engine.start_cooldown(intent.owner_team_index, intent.owner_index, static_cast<int>(policy_rng.next_below(SKILL_SLOTS)), 1 + static_cast<int>(policy_rng.next_below(2))); break;
+            case 1:  engine.add_effect(team_index, index, 1u << policy_rng.next_below(8), 0.1f, 1.0f + static_cast<float>(policy_rng.next_below(4))); break;
+            case 2:  engine.dispel_effects(team_index, index, 0xFFu); break;
+            default: break;
+        }
+    }
+
+    // Runs one battle to completion with a uniform random policy, returning the number of turns taken.
+    // The policy draws from a stream split off the battle seed, so it never perturbs the engine's own stream.
+    // With an opponent_ai, the opponents' moves are chosen by it instead. With effects, add_random_effect runs
+    // before every turn.
+    template <typename Config>
+    static int run_battle(CombatEngine<Config>& engine, const std::array<const CharacterSheet*, Config::TEAM_SIZE>& allies, const std::array<const CharacterSheet*, Config::TEAM_SIZE>& opponents, uint64_t seed, int max_turns, CombatAi<Config>* opponent_ai = nullptr, bool effects = false) {
+        constexpr int N = Config::TEAM_SIZE;
+
+        BattleRng policy_rng;
+        policy_rng.seed(seed);
+        policy_rng = policy_rng.split();
+
+        engine.setup_from_sheets(allies, opponents);
+        engine.set_seed(seed);
+        engine.roll_initiative();
+
+        while (engine.get_combat_state() == CombatState::RUNNING && engine.get_turn_count() < max_turns) {
+            if (effects) { add_random_effect(engine, policy_rng); }
+
+            const Intent& intent = engine.get_main_intent();
+            const int     other  = 1 - intent.owner_team_index;
+
+            if (opponent_ai && intent.owner_team_index == 1) {
+                const CombatAiChoice choice = opponent_ai->choose(engine);
+                engine.turn(choice.skill_slot, choice.target_pos);
+                continue;
+            }
+
+            // Picks a usable skill slot, falling back to the first one; an actor with none passes on slot 0.
+            int skill_slot = static_cast<int>(policy_rng.next_below(SKILL_SLOTS));
+            if (!engine.has_skill(intent.owner_team_index, intent.owner_index, skill_slot)) { skill_slot = std::max(0, engine.first_skill(intent.owner_team_index, intent.owner_index)); }
+
+            // Picks a living target position.
+            int living[N];
+            int living_count = 0;
+            for (int pos = 0; pos < N; pos++) {
+                if (engine.is_alive(other, pos)) { living[living_count++] = pos; }
+            }
+            const int target_pos = living[policy_rng.next_below(living_count)];
+
+            engine.turn(skill_slot, target_pos);
+        }
+
+        return engine.get_turn_count();
+    }
+
+    // Runs up to SIM_BATCH_LANES consecutive battles in lockstep with the same policy as run_battle.
+    // Returns false if the parties use a skill the batch engine cannot lower.
+    static bool run_batch(BatchCombatEngine<SIM_BATCH_LANES>& engine, const std::array<const CharacterSheet*, 5>& allies, const std::array<const CharacterSheet*, 5>& opponents, uint64_t root_seed, uint64_t first, uint64_t last, int max_turns) {
+        BattleRng policy_rng[SIM_BATCH_LANES];
+
+        for (int lane = 0; lane < SIM_BATCH_LANES; lane++) {
+            const uint64_t battle = first + lane;
+            if (battle >= last) {
+                engine.clear_lane(lane);
+                continue;
+            }
+
+            const uint64_t seed = BattleRng::derive_seed(root_seed, battle);
+            if (!engine.setup_lane(lane, allies, opponents, seed)) return false;
+
+            policy_rng[lane].seed(seed);
+            policy_rng[lane] = policy_rng[lane].split();
+        }
+
+        engine.roll_initiative();
+
+        int skill_slot[SIM_BATCH_LANES] = {};
+        int target_pos[SIM_BATCH_LANES] = {};
+
+        while (engine.any_running()) {
+            for (int lane = 0; lane < SIM_BATCH_LANES; lane++) {
+                if (!engine.is_running(lane)) continue;
+                if (engine.get_turn_count(lane) >= max_turns) {
+                    engine.stop_lane(lane);
+                    continue;
+                }
+
+                const int team_index = engine.get_actor_team_index(lane);
+                const int index      = engine.get_actor_index(lane);
+                const int other      = 1 - team_index;
+
+                // Picks a usable skill slot.
+                skill_slot[lane] = static_cast<int>(policy_rng[lane].next_below(SKILL_SLOTS));
+                if (!engine.has_skill(lane, team_index, index, skill_slot[lane])) { skill_slot[lane] = 0; }
+
+                // Picks a living target position.
+                int living[5];
+                int living_count = 0;
+                for (int pos = 0; pos < 5; pos++) {
+                    if (engine.is_alive(lane, other, pos)) { living[living_count++] = pos; }
+                }
+                target_pos[lane] = living[policy_rng[lane].next_below(living_count)];
+            }
+
+            if (engine.any_running()) { engine.turn(skill_slot, target_pos); }
+        }
+
+        return true;
+    }
+
+    // Replays battle 0 on a fresh engine with a CombatTrace attached, writes its spans as Chrome trace event JSON
+    // and prints its counters. The replay runs after the batch, so tracing never slows the timed battles.
+    template <typename Config>
+    static bool write_trace(const SimConfig& config, const std::array<const CharacterSheet*, Config::TEAM_SIZE>& allies, const std::array<const CharacterSheet*, Config::TEAM_SIZE>& opponents, const SkillProgramLibrary* skill_programs) {
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        std::unique_ptr<CombatTrace>          trace(new CombatTrace());
+        engine->set_trace(trace.get());
+        engine->set_skill_programs(skill_programs);
+
+        CombatAiSettings ai_settings;
+        ai_settings.time_budget_us = 0;
+        ai_settings.max_rollouts   = config.ai_rollouts;
+        ai_settings.thread_count   = 1;
+        ai_settings.seed           = config.seed;
+        std::unique_ptr<CombatAi<Config>> ai(config.ai_rollouts > 0 ? new CombatAi<Config>(ai_settings) : nullptr);
+
+        run_battle(*engine, allies, opponents, BattleRng::derive_seed(config.seed, 0), config.max_turns, ai.get(), config.effects);
+
+        std::FILE* file = std::fopen(config.trace, "wb");
+        const bool written = file && trace->write_chrome_trace(file);
+        if (file && std::fclose(file) != 0) { return false; }
+        if (!written) return false;
+
+        const TraceCounters& c = trace->counters;
+        std::printf("trace           %s (%llu spans, %llu lost)\n", config.trace,
+            static_cast<unsigned long long>(trace->span_count - trace->first_span()), static_cast<unsigned long long>(trace->first_span()));
+        std::printf("trace events    %llu in %llu turns, max %u per turn\n",
+            static_cast<unsigned long long>(c.events_resolved), static_cast<unsigned long long>(c.turns), c.max_events_per_turn);
+        std::printf("trace queues    main %u, fast+ %u, fast %u, slow+ %u, slow %u (high water)\n",
+            c.queue_high_water[0], c.queue_high_water[1], c.queue_high_water[2], c.queue_high_water[3], c.queue_high_water[4]);
+        std::printf("trace passives  %llu lookups, %llu scanned, %llu conditions\n",
+            static_cast<unsigned long long>(c.passive_lookups), static_cast<unsigned long long>(c.passives_scanned), static_cast<unsigned long long>(c.condition_calls));
+        return true;
+    }
+
+    // Runs the configured batch across all workers and prints a report.
+    // skill_programs is shared read-only by every worker's engine.
+    template <typename Config>
+    static int run_simulator(const SimConfig& config, const SkillProgramLibrary* skill_programs = nullptr) {
+        constexpr int N = Config::TEAM_SIZE;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(config.allies,    ally_sheets,     ally_slots);
+        build_party(config.opponents, opponent_sheets, opponent_slots);
+
+        const int thread_count = (config.threads > 0) ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+
+        std::atomic<uint64_t> next_battle { 0 };
+        std::atomic<bool>     unsupported { false };
+        std::atomic<bool>     unwritten { false };
+        std::vector<SimStats> worker_stats(thread_count);
+        std::vector<std::thread> workers;
+
+        // Claims chunks of battles until the batch is exhausted.
+        auto worker = [&](int worker_index) {
+            SimStats& stats = worker_stats[worker_index];
+            stats.turn_histogram.assign(config.max_turns + 1, 0);
+
+            // Engines are large, so each worker keeps one on the heap and reuses it between battles.
+            std::unique_ptr<CombatEngine<Config>>               engine(new CombatEngine<Config>());
+            std::unique_ptr<BatchCombatEngine<SIM_BATCH_LANES>> batch_engine(config.batch ? new BatchCombatEngine<SIM_BATCH_LANES>() : nullptr);
+            using Journal = typename CombatEngine<Config>::Journal;
+            std::unique_ptr<Journal>                            journal(config.journal ? new Journal() : nullptr);
+            engine->set_journal(journal.get());
+            engine->set_skill_programs(skill_programs);
+
+            // Workers already cover the hardware threads, so each AI searches on its worker's thread only.
+            CombatAiSettings ai_settings;
+            ai_settings.time_budget_us = 0;
+            ai_settings.max_rollouts   = config.ai_rollouts;
+            ai_settings.thread_count   = 1;
+            ai_settings.seed           = config.seed;
+            std::unique_ptr<CombatAi<Config>> ai(config.ai_rollouts > 0 ? new CombatAi<Config>(ai_settings) : nullptr);
+
+            // Records one finished battle.
+            auto record = [&](int turns, int winner, uint64_t hash) {
+                stats.battles++;
+                stats.turn_sum += turns;
+                stats.turn_histogram[turns]++;
+                stats.digest += hash;
+
+                switch (winner) {
+                    case 0:  stats.ally_wins++;     break;
+                    case 1:  stats.opponent_wins++; break;
+                    default: stats.draws++;         break;
+                }
+            };
+
+            for (;;) {
+                const uint64_t first = next_battle.fetch_add(SIM_CHUNK_SIZE, std::memory_order_relaxed);
+                if (first >= config.battles) break;
+                const uint64_t last = std::min<uint64_t>(first + SIM_CHUNK_SIZE, config.battles);
+
+                // Only the 5v5 mode has a lockstep engine.
+                if constexpr (std::is_same<Config, Config5v5>::value) {
+                    if (batch_engine) {
+                        for (uint64_t group = first; group < last; group += SIM_BATCH_LANES) {
+                            if (!run_batch(*batch_engine, ally_slots, opponent_slots, config.seed, group, last, config.max_turns)) {
+                                unsupported = true;
+                                return;
+                            }
+
+                            const int lanes = static_cast<int>(std::min<uint64_t>(SIM_BATCH_LANES, last - group));
+                            for (int lane = 0; lane < lanes; lane++) {
+                                const int      turns = batch_engine->get_turn_count(lane);
+                                const uint64_t hash  = batch_engine->get_state_hash(lane);
+                                record(turns, batch_engine->get_winner_team_index(lane), hash);
+
+                                // Cross-checks the lane against the scalar engine.
+                                if (config.verify) {
+                                    const uint64_t seed         = BattleRng::derive_seed(config.seed, group + lane);
+                                    const int      replay_turns = run_battle(*engine, ally_slots, opponent_slots, seed, config.max_turns);
+                                    if (replay_turns != turns || engine->get_state_hash() != hash) { stats.mismatches++; }
+                                }
+                            }
+                        }
+                        continue;
+                    }
+                }
+
+                for (uint64_t battle = first; battle < last; battle++) {
+                    const uint64_t seed  = BattleRng::derive_seed(config.seed, battle);
+                    const int      turns = run_battle(*engine, ally_slots, opponent_slots, seed, config.max_turns, ai.get(), config.effects);
+                    const uint64_t hash  = engine->get_state_hash();
+
+                    record(turns, engine->get_winner_team_index(), hash);
+
+                    if (config.journal_dir) {
+                        char path[1024];
+                        std::snprintf(path, sizeof(path), "%s/battle_%llu.journal", config.journal_dir, static_cast<unsigned long long>(battle));
+
+                        std::FILE* file = std::fopen(path, "wb");
+                        const bool written = file && journal->flush(file);
+                        if (!file || std::fclose(file) != 0 || !written) { unwritten = true; }
+                    }
+
+                    // Seeks to the last turn from the closest snapshot, which must land on the same state.
+                    if (config.verify && journal) {
+                        if (!engine->seek(*journal, turns) || engine->get_state_hash() != hash) { stats.mismatches++; }
+                    }
+
+                    if (config.verify) {
+                        const int replay_turns = run_battle(*engine, ally_slots, opponent_slots, seed, config.max_turns, ai.get(), config.effects);
+                        if (replay_turns != turns || engine->get_state_hash() != hash) { stats.mismatches++; }
+                    }
+                }
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < thread_count; i++) { workers.emplace_back(worker, i); }
+        for (std::thread& t : workers) { t.join(); }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (unsupported) {
+            std::fprintf(stderr, "--batch: a party uses a skill with no lane-wise lowering.\n");
+            return 1;
+        }
+
+        if (unwritten) {
+            std::fprintf(stderr, "--journal-dir: cannot write a journal to %s\n", config.journal_dir);
+            return 1;
+        }
+
+        SimStats total;
+        total.turn_histogram.assign(config.max_turns + 1, 0);
+        for (const SimStats& stats : worker_stats) { total.merge(stats); }
+
+        if (total.battles == 0) {
+            std::printf("No battles run.\n");
+            return 0;
+        }
+
+        // Gets the smallest turn count reached by at least the given fraction of battles.
+        auto percentile = [&](double fraction) {
+            const uint64_t threshold = static_cast<uint64_t>(fraction * total.battles);
+            uint64_t       seen      = 0;
+            for (size_t turns = 0; turns < total.turn_histogram.size(); turns++) {
+                seen += total.turn_histogram[turns];
+                if (seen > threshold) return static_cast<int>(turns);
+            }
+            return config.max_turns;
+        };
+
+        int min_turns = 0;
+        while (total.turn_histogram[min_turns] == 0) { min_turns++; }
+        int max_turns = config.max_turns;
+        while (total.turn_histogram[max_turns] == 0) { max_turns--; }
+
+        const double battles = static_cast<double>(total.battles);
+
+        std::printf("battles         %llu\n", static_cast<unsigned long long>(total.battles));
+        std::printf("threads         %d\n", thread_count);
+        std::printf("seconds         %.3f\n", seconds);
+        std::printf("battles/sec     %.0f\n", battles / seconds);
+        std::printf("ally wins       %.4f\n", total.ally_wins / battles);
+        std::printf("opponent wins   %.4f\n", total.opponent_wins / battles);
+        std::printf("draws           %.4f\n", total.draws / battles);
+        std::printf("turns mean      %.2f\n", total.turn_sum / battles);
+        std::printf("turns min/max   %d / %d\n", min_turns, max_turns);
+        std::printf("turns p50/p90   %d / %d\n", percentile(0.5), percentile(0.9));
+        std::printf("digest          %016llx\n", static_cast<unsigned long long>(total.digest));
+
+        if (config.trace && !write_trace<Config>(config, ally_slots, opponent_slots, skill_programs)) {
+            std::fprintf(stderr, "--trace: cannot write %s\n", config.trace);
+            return 1;
+        }
+
+        if (config.verify) {
+            std::printf("replay mismatch %llu\n", static_cast<unsigned long long>(total.mismatches));
+            return (total.mismatches == 0) ? 0 : 2;
+        }
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    pipelinepunch::SimConfig config;
+
+    if (!pipelinepunch::parse_args(argc, argv, config)) {
+        std::fprintf(stderr, "usage: battle_simulator [--battles N] [--threads T] [--seed S] [--max-turns M] [--mode 5v5|1v20|30v30] [--atb float|fixed] [--allies a,b,...] [--opponents a,b,...] [--verify-replay] [--batch] [--journal] [--journal-dir DIR] [--ai-rollouts R] [--skills FILE] [--library FILE] [--trace FILE] [--effects]\n");
+        return 1;
+    }
+
+    if (config.trace && !pipelinepunch::COMBAT_TRACE_ENABLED) {
+        std::fprintf(stderr, "--trace: built without PIPELINEPUNCH_TRACE\n");
+        return 1;
+    }
+
+    // Maps the creature pack before any party is built; every worker reads the same mapping.
+    if (config.library && !pipelinepunch::load_creature_pack(config.library)) {
+        std::fprintf(stderr, "--library: %s: %s\n", config.library, pipelinepunch::get_creature_pack_error());
+        return 1;
+    }
+
+    if (!pipelinepunch::party_is_known(config.allies) || !pipelinepunch::party_is_known(config.opponents)) {
+        std::fprintf(stderr, "unknown creature id in --allies or --opponents\n");
+        return 1;
+    }
+
+    // Compiles the skill file once; every worker reads the same library.
+    if (config.skills) {
+        std::unique_ptr<pipelinepunch::SkillProgramLibrary> skill_programs(new pipelinepunch::SkillProgramLibrary());
+
+        std::FILE* file = std::fopen(config.skills, "rb");
+        const bool loaded = file && skill_programs->load(file);
+        if (file) { std::fclose(file); }
+
+        if (!loaded) {
+            if (!file) { std::fprintf(stderr, "--skills: cannot open %s\n", config.skills); }
+            else       { std::fprintf(stderr, "--skills: %s:%d: %s\n", config.skills, skill_programs->error_line, skill_programs->error); }
+            return 1;
+        }
+
+        return pipelinepunch::run_simulator<pipelinepunch::Config5v5Program>(config, skill_programs.get());
+    }
+
+    if (config.atb_clock == pipelinepunch::AtbClock::FIXED) {
+        switch (config.team_size) {
+            case pipelinepunch::Config1v20::TEAM_SIZE:  return pipelinepunch::run_simulator<pipelinepunch::Config1v20Fixed>(config);
+            case pipelinepunch::Config30v30::TEAM_SIZE: return pipelinepunch::run_simulator<pipelinepunch::Config30v30Fixed>(config);
+            default:                                    return pipelinepunch::run_simulator<pipelinepunch::Config5v5Fixed>(config);
+        }
+    }
+
+    switch (config.team_size) {
+        case pipelinepunch::Config1v20::TEAM_SIZE:  return pipelinepunch::run_simulator<pipelinepunch::Config1v20>(config);
+        case pipelinepunch::Config30v30::TEAM_SIZE: return pipelinepunch::run_simulator<pipelinepunch::Config30v30>(config);
+        default:                                    return pipelinepunch::run_simulator<pipelinepunch::Config5v5>(config);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+// BattleState
+// -----------
+// Trivially-copyable image of everything a turn can change in a battle with N slots per side.
+// - Holds the combat state, turn count, current intent, random stream, ATB scheduler, cascade counters,
+//   the per-unit life/life_bar/turn_bar columns, the passive live masks, the units' stat versions and both sides'
+//   EffectTables; nothing else changes during a turn.
+// - Base stats, standing stat modifiers, CharacterSheets, builders and passive registrations are fixed by setup and
+//   stay in the CombatEngine, so a BattleState is a few hundred bytes besides its EffectTables rather than a copy of
+//   both CharacterTables. The EffectTables are sized by CombatConfig::EFFECTS_PER_UNIT and make up most of it.
+// - Saving, restoring or stacking states (AI lookahead, undo, journal snapshots) is a plain struct copy. The
+//   CombatEngine copies only the live effects of each EffectTable, so a battle without effects pays for its
+//   wheel heads alone; the effect masks of the CharacterTables are rebuilt from the tables on restore, and the
+//   effective stats only for units whose stat versions show modifier changes.
+
+#include <cstdint>
+#include <type_traits>
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_state.h"
+#include "pipelinepunch/systems/combat_system/structs/atb_scheduler.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/cascade_stats.h"
+#include "pipelinepunch/systems/combat_system/structs/effect_table.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the mutable state of a battle between two turns, with the scheduler keeping time on CLOCK and each
+    // side holding up to EFFECTS timed effects.
+    template <int N, AtbClock CLOCK = AtbClock::FLOAT, int EFFECTS = DEFAULT_EFFECTS_PER_UNIT * N>
+    struct BattleState {
+        CombatState            combat_state;
+        int32_t                winner_team_index;
+        int32_t                turn_count;
+        Intent                 main_intent;
+        BattleRng              rng;
+        AtbScheduler<N, CLOCK> scheduler;
+        CascadeStats           battle_cascade_stats;
+        float                  life[2][N];          // By team index and SoA index.
+        float                  life_bar[2][N];
+        float                  turn_bar[2][N];
+        uint32_t               passive_live[2][4];  // Live masks of each side's passive tables, by PassiveTier.
+        uint8_t                stat_version[2][N];  // Modifier changes of each unit's effective stats (StatTable).
+        EffectTable<N, CLOCK, EFFECTS> effects[2];  // By team index.
+    };
+
+    static_assert(std::is_trivially_copyable<BattleState<5>>::value, "BattleState must be copyable with a single memcpy.");
+    static_assert(std::is_trivially_copyable<BattleState<5, AtbClock::FIXED>>::value, "BattleState must be copyable with a single memcpy.");
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+// CascadeStats
+// ------------
+// Counters of the tiered reaction cascade, kept per turn and per battle by the CombatEngine.
+// - Every dropped event is attributed to one cause: a full queue, the depth limit or the turn's event budget.
+// - Lets tools and the GUI spot kits whose reaction chains hit the bounds set by the CombatConfig.
+
+#include <cstdint>
+
+namespace pipelinepunch {
+
+    // Represents the counters of the reaction cascade.
+    struct CascadeStats {
+        uint32_t reactions_resolved { 0 }; // Reaction events resolved (main events are not counted).
+        uint32_t overflow_drops { 0 };     // Events pushed into a full queue.
+        uint32_t depth_cutoffs { 0 };      // Reactions at the depth limit that did not look for further passives.
+        uint32_t budget_drops { 0 };       // Reactions left unresolved once the turn's event budget was spent.
+        uint32_t max_depth { 0 };          // Deepest reaction resolved.
+
+        // Adds another set of counters, keeping the deepest max_depth.
+        void accumulate(const CascadeStats& other) {
+            reactions_resolved += other.reactions_resolved;
+            overflow_drops     += other.overflow_drops;
+            depth_cutoffs      += other.depth_cutoffs;
+            budget_drops       += other.budget_drops;
+            if (other.max_depth > max_depth) { max_depth = other.max_depth; }
+        }
+    };
+}
\ No newline at end of file
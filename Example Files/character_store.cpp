@@ -0,0 +1,351 @@
+// CharacterStore
+// --------------
+// Append-only character log with a persistent id index, lazy reads and compaction.
+// - Every write goes through append(), which flushes, so a save costs one record write.
+// - The index and a compacted log are written to a temporary file and renamed into place, so a crash leaves
+//   either the old file or the new one.
+
+#include "character_store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/data/libraries/skill_library.h"
+
+namespace pipelinepunch {
+
+    static_assert(sizeof(CharacterRecord) == 48, "CharacterRecord layout changed; bump CharacterLogHeader::VERSION.");
+    static_assert(sizeof(CharacterIndexEntry) == 16, "CharacterIndexEntry layout changed; bump CharacterIndexHeader::VERSION.");
+
+    // Gets the FNV-1a hash of bytes.
+    static uint64_t store_checksum(const void* bytes, size_t count) {
+        const uint8_t* b    = static_cast<const uint8_t*>(bytes);
+        uint64_t       hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < count; i++) {
+            hash ^= b[i];
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // Gets the checksum a record must carry.
+    static uint64_t record_checksum(const CharacterRecord& record) { return store_checksum(&record, offsetof(CharacterRecord, checksum)); }
+
+    // Moves a file over another, replacing it.
+    static bool replace_file(const std::string& from, const std::string& to) {
+        if (std::rename(from.c_str(), to.c_str()) == 0) return true;
+
+        // Windows does not rename over an existing file.
+        std::remove(to.c_str());
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+
+    // Writes a log header to the start of a file.
+    static bool write_log_header(std::FILE* file, uint64_t generation) {
+        const CharacterLogHeader header { CharacterLogHeader::MAGIC, CharacterLogHeader::VERSION, CharacterLogHeader::ENDIANNESS, sizeof(CharacterRecord), generation };
+        return std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1 && std::fflush(file) == 0;
+    }
+
+    // Builds the PUT record of a character.
+    static CharacterRecord make_record(uint32_t character_id, const CharacterSheet& sheet) {
+        CharacterRecord record {};
+        record.kind         = CharacterRecordKind::PUT;
+        record.character_id = character_id;
+        record.creature_id  = sheet.creature_sheet.creature_id;
+        record.stats[0]     = sheet.stats.lp;
+        record.stats[1]     = sheet.stats.atk;
+        record.stats[2]     = sheet.stats.def;
+        record.stats[3]     = sheet.stats.mag;
+        record.stats[4]     = sheet.stats.crt;
+        record.stats[5]     = sheet.stats.spe;
+        for (int slot = 0; slot < SKILL_SLOTS; slot++) { record.skill_enum[slot] = static_cast<uint16_t>(sheet.skills.skill_enum[slot]); }
+        record.checksum     = record_checksum(record);
+        return record;
+    }
+
+    // Rebuilds a CharacterSheet from its record and the creature library. Returns false for an unknown creature.
+    static bool read_record(const CharacterRecord& record, CharacterSheet& sheet) {
+        sheet = CharacterSheet{};
+        if (!get_creature_sheet(record.creature_id, sheet.creature_sheet)) return false;
+
+        const int32_t* s = record.stats;
+        sheet.stats  = { s[0], s[1], s[2], s[3], s[4], s[5] };
+        sheet.skills = sheet.creature_sheet.skills;
+
+        // Data-driven skills past the skill library have no builders; a program-dispatch engine resolves them by SkillEnum.
+        for (int slot = 0; slot < SKILL_SLOTS; slot++) {
+            const SkillEnum skill_enum = static_cast<SkillEnum>(record.skill_enum[slot]);
+            const bool      built_in   = record.skill_enum[slot] < SKILL_LIBRARY_SIZE;
+
+            sheet.skills.skill_enum[slot]            = skill_enum;
+            sheet.skills.active_event_builder[slot]  = built_in ? get_skill(skill_enum).active_event_builder  : nullptr;
+            sheet.skills.passive_event_builder[slot] = built_in ? get_skill(skill_enum).passive_event_builder : nullptr;
+        }
+
+        return true;
+    }
+
+    // --- Opening ---
+    CharacterStore::~CharacterStore() { close(); }
+
+    // Opens a store, creating an empty one if the log is missing. Reads the index, scans the records appended after
+    // it (or the whole log without a matching index), and reads no CharacterSheet. Returns false, with the store
+    // closed and the reason in get_error(), if the log cannot be opened or was written for another layout.
+    bool CharacterStore::open(const char* store_path) {
+        close();
+        error[0] = '\0';
+        path     = store_path;
+
+        // Records an error and closes the log.
+        auto fail_open = [this](const char* message) {
+            if (log) { std::fclose(log); }
+            log = nullptr;
+            return fail(message);
+        };
+
+        CharacterLogHeader header {};
+        log = std::fopen(path.c_str(), "r+b");
+        if (log) {
+            if (std::fread(&header, sizeof(header), 1, log) != 1)                           { return fail_open("log too small"); }
+            if (header.magic != CharacterLogHeader::MAGIC)                                  { return fail_open("not a character log"); }
+            if (header.version != CharacterLogHeader::VERSION || header.endianness != CharacterLogHeader::ENDIANNESS
+                || header.record_size != sizeof(CharacterRecord))                           { return fail_open("log written with another layout"); }
+        } else {
+            log = std::fopen(path.c_str(), "w+b");
+            if (!log || !write_log_header(log, 1))                                          { return fail_open("cannot create log"); }
+            header.generation = 1;
+        }
+
+        generation = header.generation;
+
+        if (!read_index()) {
+            index.clear();
+            log_size     = sizeof(CharacterLogHeader);
+            record_count = 0;
+        }
+
+        return scan(log_size) ? true : fail_open("cannot read log");
+    }
+
+    // Loads the index if it belongs to this log generation and its entries are intact.
+    bool CharacterStore::read_index() {
+        std::FILE* file = std::fopen((path + ".index").c_str(), "rb");
+        if (!file) return false;
+
+        CharacterIndexHeader header {};
+        std::vector<CharacterIndexEntry> entries;
+
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+            && header.magic == CharacterIndexHeader::MAGIC && header.version == CharacterIndexHeader::VERSION
+            && header.endianness == CharacterLogHeader::ENDIANNESS && header.generation == generation
+            && header.log_size >= sizeof(CharacterLogHeader) && header.entry_count <= header.record_count
+            && header.record_count * sizeof(CharacterRecord) == header.log_size - sizeof(CharacterLogHeader);
+
+        if (ok) {
+            entries.resize(header.entry_count);
+            ok = std::fread(entries.data(), sizeof(CharacterIndexEntry), entries.size(), file) == entries.size()
+                && store_checksum(entries.data(), entries.size() * sizeof(CharacterIndexEntry)) == header.checksum;
+        }
+        std::fclose(file);
+
+        // The log must still hold every byte the index covers.
+        ok = ok && std::fseek(log, 0, SEEK_END) == 0 && static_cast<uint64_t>(std::ftell(log)) >= header.log_size;
+        if (!ok) return false;
+
+        index.clear();
+        index.reserve(entries.size());
+        for (const CharacterIndexEntry& entry : entries) { index[static_cast<uint32_t>(entry.character_id)] = entry.offset; }
+
+        log_size     = header.log_size;
+        record_count = header.record_count;
+        return true;
+    }
+
+    // Indexes the log's records from an offset to its end. Stops at the first damaged or partial record, which
+    // later appends overwrite.
+    bool CharacterStore::scan(uint64_t from) {
+        scanned = 0;
+        if (std::fseek(log, static_cast<long>(from), SEEK_SET) != 0) return false;
+
+        CharacterRecord record;
+        uint64_t        offset = from;
+        while (std::fread(&record, sizeof(record), 1, log) == 1 && record.checksum == record_checksum(record)) {
+            if (record.kind == CharacterRecordKind::PUT) { index[record.character_id] = offset; }
+            else                                         { index.erase(record.character_id); }
+
+            offset += sizeof(record);
+            record_count++;
+            scanned++;
+        }
+
+        log_size = offset;
+        return true;
+    }
+
+    // Writes the index and closes the store. Returns false if the index could not be written; the next open then
+    // rebuilds it from the log.
+    bool CharacterStore::close() {
+        if (!log) return true;
+
+        const bool ok = write_index();
+        std::fclose(log);
+
+        log          = nullptr;
+        log_size     = 0;
+        record_count = 0;
+        index.clear();
+        sheets.clear();
+        return ok;
+    }
+
+    // Records an error; returns false.
+    bool CharacterStore::fail(const char* message) {
+        std::snprintf(error, sizeof(error), "%s", message);
+        return false;
+    }
+
+    // --- Access ---
+    // Gets a character, reading its record on first access. Returns nullptr if the id is unknown or its record
+    // cannot be read. The pointer stays valid until the character is saved or removed, or the store closes.
+    const CharacterSheet* CharacterStore::get(uint32_t character_id) {
+        const auto cached = sheets.find(character_id);
+        if (cached != sheets.end()) return &cached->second;
+
+        const auto entry = index.find(character_id);
+        if (entry == index.end()) return nullptr;
+
+        CharacterRecord record;
+        CharacterSheet  sheet;
+        if (std::fseek(log, static_cast<long>(entry->second), SEEK_SET) != 0 || std::fread(&record, sizeof(record), 1, log) != 1
+            || record.checksum != record_checksum(record) || !read_record(record, sheet)) {
+            fail("cannot read character");
+            return nullptr;
+        }
+
+        return &sheets.emplace(character_id, sheet).first->second;
+    }
+
+    // Saves a character by appending one record. Compacts the log afterwards if garbage outnumbers live records.
+    bool CharacterStore::put(uint32_t character_id, const CharacterSheet& sheet) {
+        const uint64_t offset = log_size;
+        if (!append(make_record(character_id, sheet))) return false;
+
+        index[character_id] = offset;
+        sheets.erase(character_id);
+
+        return (record_count >= COMPACT_MIN_RECORDS && garbage() > index.size()) ? compact() : true;
+    }
+
+    // Removes a character by appending a tombstone. Returns false if the id is unknown or the write fails.
+    bool CharacterStore::remove(uint32_t character_id) {
+        if (!contains(character_id)) return false;
+
+        CharacterRecord record {};
+        record.kind         = CharacterRecordKind::REMOVE;
+        record.character_id = character_id;
+        record.checksum     = record_checksum(record);
+        if (!append(record)) return false;
+
+        index.erase(character_id);
+        sheets.erase(character_id);
+
+        return (record_count >= COMPACT_MIN_RECORDS && garbage() > index.size()) ? compact() : true;
+    }
+
+    // Appends a record at the end of the valid log and flushes it.
+    bool CharacterStore::append(const CharacterRecord& record) {
+        if (!log) return fail("store is closed");
+        if (std::fseek(log, static_cast<long>(log_size), SEEK_SET) != 0 || std::fwrite(&record, sizeof(record), 1, log) != 1 || std::fflush(log) != 0) {
+            return fail("cannot write log");
+        }
+
+        log_size += sizeof(record);
+        record_count++;
+        return true;
+    }
+
+    // --- Maintenance ---
+    // Writes the index, sorted by id, to a temporary file and renames it into place.
+    bool CharacterStore::write_index() {
+        if (!log) return fail("store is closed");
+
+        std::vector<CharacterIndexEntry> entries;
+        entries.reserve(index.size());
+        for (const auto& entry : index) { entries.push_back(CharacterIndexEntry{ entry.first, entry.second }); }
+        std::sort(entries.begin(), entries.end(), [](const CharacterIndexEntry& a, const CharacterIndexEntry& b) { return a.character_id < b.character_id; });
+
+        CharacterIndexHeader header {};
+        header.magic        = CharacterIndexHeader::MAGIC;
+        header.version      = CharacterIndexHeader::VERSION;
+        header.endianness   = CharacterLogHeader::ENDIANNESS;
+        header.entry_count  = static_cast<uint32_t>(entries.size());
+        header.generation   = generation;
+        header.log_size     = log_size;
+        header.record_count = record_count;
+        header.checksum     = store_checksum(entries.data(), entries.size() * sizeof(CharacterIndexEntry));
+
+        const std::string temporary = path + ".index.tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file) return fail("cannot write index");
+
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(entries.data(), sizeof(CharacterIndexEntry), entries.size(), file) == entries.size();
+        ok = (std::fclose(file) == 0) && ok && replace_file(temporary, path + ".index");
+
+        return ok ? true : fail("cannot write index");
+    }
+
+    // Rewrites the live records, in id order, into a fresh log of the next generation, renames it into place and
+    // writes its index. Characters already read stay loaded.
+    bool CharacterStore::compact() {
+        if (!log) return fail("store is closed");
+
+        std::vector<uint32_t> ids;
+        ids.reserve(index.size());
+        for (const auto& entry : index) { ids.push_back(entry.first); }
+        std::sort(ids.begin(), ids.end());
+
+        const std::string temporary = path + ".compact";
+        std::FILE* file = std::fopen(temporary.c_str(), "w+b");
+        if (!file) return fail("cannot write compacted log");
+
+        std::unordered_map<uint32_t, uint64_t> compacted;
+        compacted.reserve(ids.size());
+
+        bool     ok     = write_log_header(file, generation + 1) && std::fseek(file, sizeof(CharacterLogHeader), SEEK_SET) == 0;
+        uint64_t offset = sizeof(CharacterLogHeader);
+        for (size_t i = 0; ok && i < ids.size(); i++) {
+            CharacterRecord record;
+            ok = std::fseek(log, static_cast<long>(index[ids[i]]), SEEK_SET) == 0 && std::fread(&record, sizeof(record), 1, log) == 1
+                && std::fwrite(&record, sizeof(record), 1, file) == 1;
+
+            compacted[ids[i]] = offset;
+            offset += sizeof(record);
+        }
+        ok = (std::fclose(file) == 0) && ok;
+
+        if (!ok) {
+            std::remove(temporary.c_str());
+            return fail("cannot write compacted log");
+        }
+
+        // Swaps the logs; the old one is closed first so Windows can replace it.
+        std::fclose(log);
+        log = nullptr;
+        if (!replace_file(temporary, path) || !(log = std::fopen(path.c_str(), "r+b"))) {
+            // Reopens whichever log is in place; its index may be stale, which the next open detects.
+            log = std::fopen(path.c_str(), "r+b");
+            return fail("cannot replace log");
+        }
+
+        generation++;
+        log_size     = offset;
+        record_count = ids.size();
+        index.swap(compacted);
+
+        return write_index();
+    }
+}
\ No newline at end of file
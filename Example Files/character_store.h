@@ -0,0 +1,128 @@
+#pragma once
+
+// CharacterStore
+// --------------
+// On-disk store of a player's characters, keyed by character id, that opens without reading the collection and
+// saves one character at a time.
+// - The log file is append-only: saving a character appends its new record and removing one appends a tombstone,
+//   so a save writes one fixed-size record instead of rewriting the whole collection.
+// - The index file maps each character id to the offset of its latest record. Opening reads the index and scans
+//   only the records appended after it was written; a CharacterSheet is read from the log on first access.
+// - Records superseded by later saves are garbage. compact() rewrites the live records into a fresh log and index,
+//   and saves compact on their own once garbage outnumbers live records.
+// - Records and the index carry checksums. The log is read up to its first damaged record, which drops a record
+//   torn by a crash mid-save; an index that does not match the log is rebuilt by scanning the log.
+//
+// Records hold what the combat core reads from a CharacterSheet: the creature id, stats and skill slots. Sheets are
+// rebuilt from the creature library (or the loaded CreaturePack) plus those fields.
+//
+// File layout: <path> is a CharacterLogHeader followed by CharacterRecords. <path>.index is a CharacterIndexHeader
+// followed by CharacterIndexEntry pairs sorted by id. Both are written in their in-memory layout and carry the
+// record size and an endianness tag, so a build with another layout rejects them instead of misreading.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+#include "pipelinepunch/utils/structs/character_sheet.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    // Represents the kind of a CharacterRecord.
+    enum class CharacterRecordKind : uint32_t {
+        PUT    = 1, // The character's latest state.
+        REMOVE = 2  // The character was removed.
+    };
+
+    // Represents the header at the start of a log file.
+    struct CharacterLogHeader {
+        static constexpr uint32_t MAGIC      = 0x53435050u; // "PPCS"
+        static constexpr uint32_t VERSION    = 1;
+        static constexpr uint32_t ENDIANNESS = 0x01020304u;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianness;
+        uint32_t record_size;
+        uint64_t generation; // Incremented by every compaction; an index must match it.
+    };
+
+    // Represents one saved state of a character.
+    struct CharacterRecord {
+        CharacterRecordKind kind;
+        uint32_t            character_id;
+        int32_t             creature_id;
+        int32_t             stats[6];                // lp, atk, def, mag, crt, spe.
+        uint16_t            skill_enum[SKILL_SLOTS];
+        uint64_t            checksum;                // Of every byte before it.
+    };
+
+    // Represents the header at the start of an index file.
+    struct CharacterIndexHeader {
+        static constexpr uint32_t MAGIC   = 0x49435050u; // "PPCI"
+        static constexpr uint32_t VERSION = 1;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianness;
+        uint32_t entry_count;
+        uint64_t generation;   // Generation of the log it indexes.
+        uint64_t log_size;     // Bytes of the log it covers; later records are scanned on open.
+        uint64_t record_count; // Records in the covered bytes, live or not.
+        uint64_t checksum;     // Of the entries.
+    };
+
+    // Represents the location of a character's latest record.
+    struct CharacterIndexEntry {
+        uint64_t character_id;
+        uint64_t offset;
+    };
+
+    // Represents an open store.
+    class CharacterStore {
+    public:
+        static constexpr uint64_t COMPACT_MIN_RECORDS = 1024; // Logs shorter than this never compact on their own.
+        static constexpr int      MAX_ERROR           = 96;
+
+        CharacterStore() = default;
+        ~CharacterStore();
+
+        CharacterStore(const CharacterStore&)            = delete;
+        CharacterStore& operator=(const CharacterStore&) = delete;
+
+        bool open(const char* path); // Opens a store, creating it if missing; false (and closed) on failure.
+        bool close();                // Writes the index and closes the store; false if the index could not be written.
+
+        const CharacterSheet* get(uint32_t character_id);                         // Gets a character, reading it on first access; nullptr if unknown.
+        bool                  put(uint32_t character_id, const CharacterSheet& sheet); // Saves a character by appending one record.
+        bool                  remove(uint32_t character_id);                     // Removes a character by appending a tombstone.
+        bool                  compact();                                         // Rewrites the live records into a fresh log and index.
+        bool                  write_index();                                     // Writes the index, so the next open scans no log.
+
+        bool        is_open() const          { return log != nullptr; }
+        bool        contains(uint32_t character_id) const { return index.count(character_id) != 0; }
+        size_t      size() const             { return index.size(); }                      // Gets the number of live characters.
+        size_t      loaded() const           { return sheets.size(); }                     // Gets the number of characters read so far.
+        uint64_t    garbage() const          { return record_count - index.size(); }       // Gets the records superseded or removed.
+        uint64_t    scanned_on_open() const  { return scanned; }                           // Gets the records the last open scanned.
+        const char* get_error() const        { return error; }
+
+    private:
+        std::string                                    path;
+        std::FILE*                                     log { nullptr };
+        uint64_t                                       generation { 0 };
+        uint64_t                                       log_size { 0 };      // Bytes of valid log; appends go here.
+        uint64_t                                       record_count { 0 };  // Records in the valid log, live or not.
+        uint64_t                                       scanned { 0 };
+        std::unordered_map<uint32_t, uint64_t>         index;               // Character id to offset of its latest record.
+        std::unordered_map<uint32_t, CharacterSheet>   sheets;              // Characters read so far.
+        char                                           error[MAX_ERROR] {};
+
+        bool read_index();                                    // Loads the index if it matches the log.
+        bool scan(uint64_t from);                             // Indexes the log's records from an offset to its end.
+        bool append(const CharacterRecord& record);           // Appends a record and flushes it.
+        bool fail(const char* message);                       // Records an error; returns false.
+    };
+}
\ No newline at end of file
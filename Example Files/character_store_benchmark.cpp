@@ -0,0 +1,225 @@
+// Character Store Benchmark
+// -------------------------
+// Headless benchmark of the CharacterStore against whole-document saves, on a large inventory.
+// - Baseline: a save rewrites every character into one file and a load reads them all back, as a whole-document
+//   inventory does.
+// - Store: times open (index read plus tail scan), first and repeated access to a character, a one-character
+//   save, open after saves made since the last index, open with no index (a full log scan) and compaction.
+// - Files are read from the OS cache, so "cold" means a fresh process with nothing parsed rather than a cold disk.
+//
+// Usage: character_store_benchmark [--characters N] [--saves S] [--dir DIR]
+// Files are written to DIR (default: the working directory) and removed afterwards.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/utils/io/character_store.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+
+namespace pipelinepunch {
+
+    constexpr int STORE_BENCH_READS = 1000; // Characters read by the access cases.
+
+    // Represents the benchmark's command-line configuration.
+    struct StoreBenchConfig {
+        int         characters { 10000 };
+        int         saves      { 1000 };
+        std::string dir        { "." };
+    };
+
+    // Gets the time since a start point, in microseconds.
+    static double elapsed_us(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Builds the CharacterSheet of character i: a library creature with its stats nudged, so records differ.
+    static CharacterSheet make_character(int i) {
+        CharacterSheet sheet;
+        get_creature_sheet(i % CREATURE_LIBRARY_SIZE, sheet.creature_sheet);
+        sheet.stats     = sheet.creature_sheet.stats;
+        sheet.stats.lp += i % 97;
+        sheet.stats.atk += i % 13;
+        sheet.skills    = sheet.creature_sheet.skills;
+        return sheet;
+    }
+
+    // Writes every character into one file, as a whole-document save does. Returns false on a write error.
+    static bool save_whole(const std::string& file_path, const std::vector<CharacterRecord>& records) {
+        std::FILE* file = std::fopen(file_path.c_str(), "wb");
+        if (!file) return false;
+
+        const bool ok = std::fwrite(records.data(), sizeof(CharacterRecord), records.size(), file) == records.size();
+        return (std::fclose(file) == 0) && ok;
+    }
+
+    // Reads every character back from one file and rebuilds its sheet, as a whole-document load does.
+    static bool load_whole(const std::string& file_path, std::vector<CharacterSheet>& sheets, size_t count) {
+        std::FILE* file = std::fopen(file_path.c_str(), "rb");
+        if (!file) return false;
+
+        std::vector<CharacterRecord> records(count);
+        const bool ok = std::fread(records.data(), sizeof(CharacterRecord), count, file) == count;
+        std::fclose(file);
+
+        sheets.resize(count);
+        for (size_t i = 0; ok && i < count; i++) {
+            sheets[i] = CharacterSheet{};
+            get_creature_sheet(records[i].creature_id, sheets[i].creature_sheet);
+            sheets[i].stats  = { records[i].stats[0], records[i].stats[1], records[i].stats[2], records[i].stats[3], records[i].stats[4], records[i].stats[5] };
+            sheets[i].skills = sheets[i].creature_sheet.skills;
+        }
+        return ok;
+    }
+
+    // Prints a result line.
+    static void report(const char* name, double us, const char* note = "") {
+        std::printf("%-26s %12.1f us %s\n", name, us, note);
+    }
+
+    // Runs every case. Returns the process exit status.
+    static int run_benchmark(const StoreBenchConfig& config) {
+        const std::string store_path = config.dir + "/bench_characters.store";
+        const std::string whole_path = config.dir + "/bench_characters.whole";
+        const uint32_t    count      = static_cast<uint32_t>(config.characters);
+
+        std::remove(store_path.c_str());
+        std::remove((store_path + ".index").c_str());
+
+        std::printf("characters %u, saves %d\n", count, config.saves);
+
+        // --- Baseline: whole-document save and load ---
+        std::vector<CharacterRecord> records(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const CharacterSheet sheet = make_character(static_cast<int>(i));
+            records[i] = CharacterRecord{};
+            records[i].kind         = CharacterRecordKind::PUT;
+            records[i].character_id = i;
+            records[i].creature_id  = sheet.creature_sheet.creature_id;
+            const Stats& stats = sheet.stats;
+            const int32_t values[6] = { stats.lp, stats.atk, stats.def, stats.mag, stats.crt, stats.spe };
+            std::memcpy(records[i].stats, values, sizeof(values));
+            for (int slot = 0; slot < SKILL_SLOTS; slot++) { records[i].skill_enum[slot] = static_cast<uint16_t>(sheet.skills.skill_enum[slot]); }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (!save_whole(whole_path, records)) { std::fprintf(stderr, "cannot write %s\n", whole_path.c_str()); return 1; }
+        const double whole_save_us = elapsed_us(start);
+
+        std::vector<CharacterSheet> whole_sheets;
+        start = std::chrono::steady_clock::now();
+        if (!load_whole(whole_path, whole_sheets, count)) { std::fprintf(stderr, "cannot read %s\n", whole_path.c_str()); return 1; }
+        const double whole_load_us = elapsed_us(start);
+        std::remove(whole_path.c_str());
+
+        report("whole_save", whole_save_us, "(every save)");
+        report("whole_load", whole_load_us, "(every start)");
+
+        // --- Store: fill, then open as a fresh start would ---
+        {
+            CharacterStore store;
+            if (!store.open(store_path.c_str())) { std::fprintf(stderr, "%s: %s\n", store_path.c_str(), store.get_error()); return 1; }
+            for (uint32_t i = 0; i < count; i++) { store.put(i, make_character(static_cast<int>(i))); }
+            store.close();
+        }
+
+        CharacterStore store;
+        start = std::chrono::steady_clock::now();
+        if (!store.open(store_path.c_str())) { std::fprintf(stderr, "%s: %s\n", store_path.c_str(), store.get_error()); return 1; }
+        report("store_open", elapsed_us(start), "(index read, no sheet read)");
+
+        // Spreads reads over the inventory, as a party screen jumping between characters does.
+        std::vector<uint32_t> ids(STORE_BENCH_READS);
+        for (int i = 0; i < STORE_BENCH_READS; i++) { ids[static_cast<size_t>(i)] = static_cast<uint32_t>((static_cast<uint64_t>(i) * 2654435761u) % count); }
+
+        uint64_t sink = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint32_t id : ids) { if (const CharacterSheet* sheet = store.get(id)) { sink += static_cast<uint64_t>(sheet->stats.lp); } }
+        report("store_first_get", elapsed_us(start) / STORE_BENCH_READS, "(per character)");
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t id : ids) { if (const CharacterSheet* sheet = store.get(id)) { sink += static_cast<uint64_t>(sheet->stats.lp); } }
+        report("store_cached_get", elapsed_us(start) / STORE_BENCH_READS, "(per character)");
+
+        // --- Saves: one character each, each flushed ---
+        std::vector<double> save_us(static_cast<size_t>(config.saves));
+        for (int i = 0; i < config.saves; i++) {
+            CharacterSheet sheet = make_character(i);
+            sheet.stats.lp += 1;
+
+            start = std::chrono::steady_clock::now();
+            store.put(static_cast<uint32_t>(ids[static_cast<size_t>(i) % ids.size()]), sheet);
+            save_us[static_cast<size_t>(i)] = elapsed_us(start);
+        }
+        std::sort(save_us.begin(), save_us.end());
+        if (!save_us.empty()) {
+            report("store_save_p50", save_us[save_us.size() / 2], "(one character)");
+            report("store_save_p99", save_us[save_us.size() * 99 / 100], "(one character)");
+        }
+
+        // --- Opens after saves: with a stale index (tail scan), then with none (full scan) ---
+        // Simulates a crash: the index on disk predates the saves, which the next open finds by scanning the tail.
+        CharacterStore reopened;
+        start = std::chrono::steady_clock::now();
+        reopened.open(store_path.c_str());
+        char note[64];
+        std::snprintf(note, sizeof(note), "(scanned %llu records)", static_cast<unsigned long long>(reopened.scanned_on_open()));
+        report("store_open_after_saves", elapsed_us(start), note);
+        reopened.close();
+
+        std::remove((store_path + ".index").c_str());
+        start = std::chrono::steady_clock::now();
+        reopened.open(store_path.c_str());
+        std::snprintf(note, sizeof(note), "(scanned %llu records)", static_cast<unsigned long long>(reopened.scanned_on_open()));
+        report("store_open_no_index", elapsed_us(start), note);
+        reopened.close();
+
+        // --- Compaction ---
+        store.close();
+        store.open(store_path.c_str());
+        std::snprintf(note, sizeof(note), "(%llu garbage records)", static_cast<unsigned long long>(store.garbage()));
+        start = std::chrono::steady_clock::now();
+        const bool compacted = store.compact();
+        report("store_compact", elapsed_us(start), note);
+
+        const bool intact = compacted && store.size() == count && store.garbage() == 0;
+        store.close();
+
+        std::remove(store_path.c_str());
+        std::remove((store_path + ".index").c_str());
+
+        std::printf("sink %llu, %s\n", static_cast<unsigned long long>(sink), intact ? "store intact" : "store damaged");
+        return intact ? 0 : 2;
+    }
+
+    // Parses command-line arguments into a StoreBenchConfig.
+    static bool parse_args(int argc, char** argv, StoreBenchConfig& config) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* arg   = argv[i];
+            const char* value = argv[i + 1];
+
+            if      (std::strcmp(arg, "--characters") == 0) { config.characters = std::atoi(value); }
+            else if (std::strcmp(arg, "--saves")      == 0) { config.saves      = std::atoi(value); }
+            else if (std::strcmp(arg, "--dir")        == 0) { config.dir        = value; }
+            else return false;
+        }
+        return argc % 2 == 1 && config.characters > 0 && config.saves >= 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    pipelinepunch::StoreBenchConfig config;
+
+    if (!pipelinepunch::parse_args(argc, argv, config)) {
+        std::fprintf(stderr, "usage: character_store_benchmark [--characters N] [--saves S] [--dir DIR]\n");
+        return 1;
+    }
+
+    return pipelinepunch::run_benchmark(config);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+// CharacterTable
+// --------------
+// Struct-of-Arrays runtime table of one side of a battle, split by access frequency.
+// - CharacterTable holds the hot columns: every field read or written while events resolve, in compact SoA form.
+//   Builders, the scheduler and the state checks only ever touch this table.
+// - CharacterColdTable holds the cold data: the full CharacterSheet (name, gear, creature sheet) and skill slots.
+//   It is filled once by setup_from_sheets and only read by the UI and tools.
+// - Values needed during resolution (e.g. creature type) are copied out of the sheet into their own hot column,
+//   so a 5v5 side's hot table fits in a few cache lines; combat_benchmark reports and checks its size.
+// - The stat columns (atk, def, mag, crt, spe, dmg_in, dmg_out) hold effective values, kept current by the
+//   engine's StatTables as modifiers change, so a modified stat costs the same single load as a base one.
+// - Timed effects live in the engine's EffectTables; only the OR of each unit's effect bits is kept here, so
+//   passive conditions can test buffs, debuffs and cooldowns with a mask.
+// - Both tables are indexed by SoA index; pos_to_index / index_to_pos map party positions.
+
+#include <cstdint>
+
+#include "pipelinepunch/data/enums/type_enums.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    // Represents the hot runtime columns of a side with N slots.
+    template <int N>
+    struct CharacterTable {
+        int8_t   pos_to_index[N]; // SoA index of each party position.
+        int8_t   index_to_pos[N]; // Party position of each SoA index.
+        TypeEnum type[N];         // Creature type, for type-dependent damage.
+        float    life[N];
+        float    life_bar[N];     // life / lp, for the UI.
+        float    turn_bar[N];
+        float    dmg_in[N];       // Incoming damage multiplier (effective).
+        float    dmg_out[N];      // Outgoing damage multiplier (effective).
+        float    lp[N];
+        float    atk[N];          // Effective stats: base and modifiers, see StatTable.
+        float    def[N];
+        float    mag[N];
+        float    crt[N];
+        float    spe[N];
+        uint32_t effects[N];      // Bits of the unit's active timed effects (EffectTable), for passive conditions.
+    };
+
+    // Represents the cold runtime data of a side with N slots.
+    template <int N>
+    struct CharacterColdTable {
+        Skills         skills[N];
+        CharacterSheet character_sheet[N];
+    };
+}
\ No newline at end of file
@@ -0,0 +1,279 @@
+// CombatAi
+// --------
+// Native turn AI: chooses a skill slot and target position for the current actor of a CombatEngine.
+// - Scores every (usable skill slot, living target) pair with Monte Carlo rollouts on forked battle states.
+// - Search is root-parallel over a worker pool and stops at a per-move deadline or rollout cap.
+
+#include "combat_ai.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pipelinepunch {
+
+	template <typename Config>
+	CombatAi<Config>::CombatAi(const CombatAiSettings& settings) : settings(settings) {}
+
+	template <typename Config>
+	CombatAi<Config>::~CombatAi() { stop_workers(); }
+
+	// --- Entry Points ---
+	// Replaces the search limits; stops the workers if the thread count changes.
+	template <typename Config>
+	void CombatAi<Config>::set_settings(const CombatAiSettings& new_settings) {
+		const bool restart = new_settings.thread_count != settings.thread_count;
+		settings = new_settings;
+		if (restart) { stop_workers(); }
+	}
+
+	// Chooses a move for the engine's current actor, blocking until the search stops.
+	// Returns slot 0 against position 0 if the battle is not running.
+	template <typename Config>
+	CombatAiChoice CombatAi<Config>::choose(const CombatEngine<Config>& engine) {
+		CombatAiChoice choice;
+		if (engine.get_combat_state() != CombatState::RUNNING) return choice;
+
+		const Intent& intent = engine.get_main_intent();
+		const int     other  = 1 - intent.owner_team_index;
+
+		candidate_count = 0;
+		for (int skill_slot = 0; skill_slot < SKILL_SLOTS; skill_slot++) {
+			if (!engine.has_skill(intent.owner_team_index, intent.owner_index, skill_slot)) continue;
+
+			for (int pos = 0; pos < N; pos++) {
+				if (engine.is_alive(other, pos)) { candidates[candidate_count++] = Candidate{ skill_slot, pos }; }
+			}
+		}
+
+		if (candidate_count == 0) return choice;
+
+		choice.skill_slot = candidates[0].skill_slot;
+		choice.target_pos = candidates[0].target_pos;
+		if (candidate_count == 1) return choice;
+
+		// Publishes the move; the pool threads read it only after job_ready.
+		const int budget_us = (settings.time_budget_us <= 0 && settings.max_rollouts <= 0) ? AI_DEFAULT_BUDGET : settings.time_budget_us;
+
+		root         = &engine;
+		team_index   = intent.owner_team_index;
+		root_seed    = BattleRng::derive_seed(settings.seed, engine.get_state_hash());
+		max_rollouts = settings.max_rollouts;
+		has_deadline = budget_us > 0;
+		deadline     = std::chrono::steady_clock::now() + std::chrono::microseconds(budget_us);
+		rollouts_started.store(0, std::memory_order_relaxed);
+
+		int worker_count = settings.thread_count;
+		if (worker_count <= 0) { worker_count = std::min<int>(AI_MAX_THREADS, std::max(1u, std::thread::hardware_concurrency())); }
+		if (static_cast<int>(workers.size()) != worker_count) { start_workers(worker_count); }
+
+		if (!threads.empty()) {
+			std::lock_guard<std::mutex> lock(mutex);
+			busy = static_cast<int>(threads.size());
+			job_generation++;
+		}
+		job_ready.notify_all();
+
+		search(0);
+
+		if (!threads.empty()) {
+			std::unique_lock<std::mutex> lock(mutex);
+			job_done.wait(lock, [this] { return busy == 0; });
+		}
+
+		root = nullptr;
+
+		// Picks the most visited move, the standard choice for Monte Carlo search; ties go to the better mean.
+		int   best_visits = -1;
+		float best_mean   = 0.0f;
+		for (int c = 0; c < candidate_count; c++) {
+			int   visits = 0;
+			float score  = 0.0f;
+			for (const Worker& w : workers) {
+				visits += w.visits[c];
+				score  += w.score[c];
+			}
+
+			choice.rollouts += visits;
+
+			const float mean = (visits > 0) ? score / visits : 0.0f;
+			if (visits > best_visits || (visits == best_visits && mean > best_mean)) {
+				best_visits       = visits;
+				best_mean         = mean;
+				choice.skill_slot = candidates[c].skill_slot;
+				choice.target_pos = candidates[c].target_pos;
+				choice.value      = mean;
+			}
+		}
+
+		return choice;
+	}
+
+	// --- Queries ---
+	// Gets the search limits.
+	template <typename Config>
+	const CombatAiSettings& CombatAi<Config>::get_settings() const { return settings; }
+
+	// Gets the number of workers, including the caller; 0 until the first choose().
+	template <typename Config>
+	int CombatAi<Config>::get_thread_count() const { return static_cast<int>(workers.size()); }
+
+	// --- Internal logic ---
+	// Allocates the workers and starts their threads. Engines are large, so each worker keeps one on the heap.
+	template <typename Config>
+	void CombatAi<Config>::start_workers(int worker_count) {
+		stop_workers();
+
+		workers.resize(worker_count);
+		for (Worker& w : workers) { w.engine.reset(new CombatEngine<Config>()); }
+
+		stopping = false;
+		for (int i = 1; i < worker_count; i++) { threads.emplace_back(&CombatAi::worker_loop, this, i, job_generation); }
+	}
+
+	// Stops and joins the pool threads.
+	template <typename Config>
+	void CombatAi<Config>::stop_workers() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		job_ready.notify_all();
+
+		for (std::thread& t : threads) { t.join(); }
+		threads.clear();
+		workers.clear();
+	}
+
+	// Waits for moves and searches them until stopped.
+	template <typename Config>
+	void CombatAi<Config>::worker_loop(int worker_index, uint64_t generation) {
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				job_ready.wait(lock, [&] { return stopping || job_generation != generation; });
+				if (stopping) return;
+				generation = job_generation;
+			}
+
+			search(worker_index);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0) { job_done.notify_one(); }
+		}
+	}
+
+	// Runs rollouts until the deadline or the rollout cap.
+	template <typename Config>
+	void CombatAi<Config>::search(int worker_index) {
+		Worker& w = workers[worker_index];
+
+		root->fork(*w.engine);
+		w.engine->snapshot_state(w.root_state);
+		w.rng.seed(BattleRng::derive_seed(root_seed, static_cast<uint64_t>(worker_index)));
+
+		for (int c = 0; c < candidate_count; c++) {
+			w.visits[c] = 0;
+			w.score[c]  = 0.0f;
+		}
+
+		for (int total = 0;; total++) {
+			if (max_rollouts > 0 && rollouts_started.fetch_add(1, std::memory_order_relaxed) >= max_rollouts) break;
+			if (has_deadline && std::chrono::steady_clock::now() >= deadline) break;
+
+			const int c = select(w, worker_index, total);
+
+			// Hides the battle's real future rolls behind a fresh stream.
+			w.root_state.rng = w.rng.split();
+			w.engine->restore_state(w.root_state);
+
+			w.visits[c]++;
+			w.score[c] += rollout(w, candidates[c]);
+		}
+	}
+
+	// Gets the next candidate to roll out by UCB1. Untried candidates go first, each worker starting at a
+	// different one so a short search still covers every move.
+	template <typename Config>
+	int CombatAi<Config>::select(const Worker& w, int worker_index, int total) const {
+		for (int i = 0; i < candidate_count; i++) {
+			const int c = (worker_index + i) % candidate_count;
+			if (w.visits[c] == 0) return c;
+		}
+
+		const float log_total = std::log(static_cast<float>(total));
+
+		int   best       = 0;
+		float best_bound = -1.0f;
+		for (int c = 0; c < candidate_count; c++) {
+			const float bound = w.score[c] / w.visits[c] + AI_EXPLORATION * std::sqrt(log_total / w.visits[c]);
+			if (bound > best_bound) {
+				best       = c;
+				best_bound = bound;
+			}
+		}
+
+		return best;
+	}
+
+	// Plays a candidate and up to rollout_turns uniform random moves, then scores the battle.
+	template <typename Config>
+	float CombatAi<Config>::rollout(Worker& w, const Candidate& c) {
+		CombatEngine<Config>& engine = *w.engine;
+
+		engine.turn(c.skill_slot, c.target_pos);
+
+		// ROADMAP: a cheap heuristic policy (e.g. focus the weakest target) would make rollouts more informative.
+		for (int turn = 0; turn < settings.rollout_turns && engine.get_combat_state() == CombatState::RUNNING; turn++) {
+			const Intent& intent = engine.get_main_intent();
+			const int     other  = 1 - intent.owner_team_index;
+
+			// Picks a usable skill slot, falling back to the first one; an actor with none passes on slot 0.
+			int skill_slot = static_cast<int>(w.rng.next_below(SKILL_SLOTS));
+			if (!engine.has_skill(intent.owner_team_index, intent.owner_index, skill_slot)) { skill_slot = std::max(0, engine.first_skill(intent.owner_team_index, intent.owner_index)); }
+
+			int living[N];
+			int living_count = 0;
+			for (int pos = 0; pos < N; pos++) {
+				if (engine.is_alive(other, pos)) { living[living_count++] = pos; }
+			}
+
+			engine.turn(skill_slot, living[w.rng.next_below(living_count)]);
+		}
+
+		return score_battle(engine);
+	}
+
+	// Scores a battle for the searching side: 1 for a win, 0 for a loss, 0.5 for a draw.
+	// A battle still running is scored from the difference in remaining life share.
+	template <typename Config>
+	float CombatAi<Config>::score_battle(const CombatEngine<Config>& engine) const {
+		if (engine.get_combat_state() != CombatState::RUNNING) {
+			const int winner = engine.get_winner_team_index();
+			return (winner < 0) ? 0.5f : (winner == team_index) ? 1.0f : 0.0f;
+		}
+
+		float share[2];
+		for (int side = 0; side < 2; side++) {
+			const CharacterTable<N>& ct = engine.get_character_table(side);
+
+			float life = 0.0f;
+			float lp   = 0.0f;
+			for (int index = 0; index < N; index++) {
+				life += std::max(ct.life[index], 0.0f);
+				lp   += ct.lp[index];
+			}
+			share[side] = (lp > 0.0f) ? life / lp : 0.0f;
+		}
+
+		return 0.5f + 0.5f * (share[team_index] - share[1 - team_index]);
+	}
+
+	// --- Instantiations ---
+	template class CombatAi<Config5v5>;
+	template class CombatAi<Config5v5Program>;
+	template class CombatAi<Config1v20>;
+	template class CombatAi<Config30v30>;
+	template class CombatAi<Config5v5Fixed>;
+	template class CombatAi<Config1v20Fixed>;
+	template class CombatAi<Config30v30Fixed>;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+// CombatAi
+// --------
+// Native turn AI: chooses a skill slot and target position for the current actor of a CombatEngine.
+// - Scores every (usable skill slot, living target) pair with Monte Carlo rollouts: the move is played on a
+//   copy of the battle, then both sides play uniform random moves for up to rollout_turns turns.
+// - Rollouts restore a BattleState snapshot instead of re-copying the engine, and each rollout reseeds the
+//   battle's random stream, so the AI plays against the odds rather than the battle's actual future rolls.
+// - Rollouts are spread over UCB1 (explore the untried, exploit the promising) so the budget goes to the
+//   moves that can still change the decision.
+// - Search is root-parallel: each worker forks the engine once per move and keeps its own statistics; the
+//   results are summed once every worker has stopped. The caller's thread is worker 0, so a thread_count of 1
+//   never starts a thread.
+// - Workers stop at a steady_clock deadline (time_budget_us) or after max_rollouts rollouts in total. With
+//   only a rollout cap and one thread, choose() is deterministic for a given seed and battle state.
+// - Worker threads are started on first use and sleep on a condition variable between moves.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_state.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    // Represents the search limits of a CombatAi.
+    struct CombatAiSettings {
+        int      time_budget_us { 6000 }; // Wall-clock budget per move; 0 for none. Sized to fit a 60 fps frame.
+        int      max_rollouts   { 0 };    // Rollouts per move across all workers; 0 for none.
+        int      thread_count   { 0 };    // Workers including the caller; 0 for hardware threads, capped at AI_MAX_THREADS.
+        int      rollout_turns  { 48 };   // Turns played after the move before a running battle is scored.
+        uint64_t seed           { 1 };    // Root of the rollout streams, mixed with the battle's state hash.
+    };
+
+    // Represents a move chosen by a CombatAi.
+    struct CombatAiChoice {
+        int   skill_slot { 0 };
+        int   target_pos { 0 };
+        int   rollouts   { 0 };    // Rollouts spent on the whole search.
+        float value      { 0.5f }; // Mean rollout score of the move, from 0 (loss) to 1 (win).
+    };
+
+    // Represents the turn AI of battles shaped by a CombatConfig.
+    template <typename Config>
+    class CombatAi {
+    public:
+        static constexpr int   N                 = Config::TEAM_SIZE;
+        static constexpr int   MAX_CANDIDATES    = SKILL_SLOTS * N;
+        static constexpr int   AI_MAX_THREADS    = 4;    // Default worker cap, leaving cores to the main and render threads.
+        static constexpr int   AI_DEFAULT_BUDGET = 6000; // Budget in microseconds when neither limit is set.
+        static constexpr float AI_EXPLORATION    = 0.7f; // UCB1 exploration constant.
+
+        explicit CombatAi(const CombatAiSettings& settings = CombatAiSettings{});
+        ~CombatAi();
+
+        CombatAi(const CombatAi&)            = delete;
+        CombatAi& operator=(const CombatAi&) = delete;
+
+        // --- Entry Points ---
+        void           set_settings(const CombatAiSettings& settings); // Replaces the search limits; stops the workers if the thread count changes.
+        CombatAiChoice choose(const CombatEngine<Config>& engine);     // Chooses a move for the engine's current actor, blocking until the search stops.
+
+        // --- Queries ---
+        const CombatAiSettings& get_settings() const;     // Gets the search limits.
+        int                     get_thread_count() const; // Gets the number of workers, including the caller.
+
+    private:
+        // Represents a candidate move.
+        struct Candidate {
+            int skill_slot;
+            int target_pos;
+        };
+
+        // Represents one worker's copy of the battle and its statistics.
+        struct Worker {
+            std::unique_ptr<CombatEngine<Config>> engine;
+            typename CombatEngine<Config>::State  root_state;
+            BattleRng                             rng;
+            int                                   visits[MAX_CANDIDATES];
+            float                                 score[MAX_CANDIDATES];
+        };
+
+        // --- Settings ---
+        CombatAiSettings settings;
+
+        // --- Current Search (written by choose() before the workers wake) ---
+        const CombatEngine<Config>*           root { nullptr };
+        int                                   team_index { 0 };
+        Candidate                             candidates[MAX_CANDIDATES];
+        int                                   candidate_count { 0 };
+        uint64_t                              root_seed { 0 };
+        int                                   max_rollouts { 0 };
+        bool                                  has_deadline { false };
+        std::chrono::steady_clock::time_point deadline;
+        std::atomic<int>                      rollouts_started { 0 };
+
+        // --- Worker Pool ---
+        std::vector<Worker>      workers;          // Index 0 belongs to the caller.
+        std::vector<std::thread> threads;          // Runs workers 1 and up.
+        std::mutex               mutex;
+        std::condition_variable  job_ready;
+        std::condition_variable  job_done;
+        uint64_t                 job_generation { 0 };
+        int                      busy { 0 };       // Pool threads still searching the current move.
+        bool                     stopping { false };
+
+        // --- Internal logic ---
+        void  start_workers(int worker_count);                             // Allocates the workers and starts their threads.
+        void  stop_workers();                                              // Stops and joins the pool threads.
+        void  worker_loop(int worker_index, uint64_t generation);          // Waits for moves and searches them until stopped.
+        void  search(int worker_index);                                    // Runs rollouts until the deadline or the rollout cap.
+        int   select(const Worker& w, int worker_index, int total) const;  // Gets the next candidate to roll out by UCB1.
+        float rollout(Worker& w, const Candidate& c);                      // Plays a candidate and random moves, then scores the battle.
+        float score_battle(const CombatEngine<Config>& engine) const;      // Scores a battle for the searching side.
+    };
+}
\ No newline at end of file
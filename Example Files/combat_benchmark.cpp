@@ -0,0 +1,957 @@
+// Combat Benchmark
+// ----------------
+// Headless, Godot-free micro-benchmarks for the CombatEngine's hot paths.
+// - Measures the size of a BattleState, the hot and cold character tables, an Event, the BattleContext and the full
+//   CombatEngine, per CombatConfig.
+// - Times snapshot_state, restore_state, a plain BattleState copy, fork and a snapshot/turn/restore undo cycle.
+// - Times each turn phase alone (get_next_character, build_main_event_queue, get_passives, resolve_event and
+//   resolve_events), a whole turn and a turn order forecast, per CombatConfig and on both AtbClocks, over states
+//   taken from battles between creature library parties with one react passive per unit. Each case restores a
+//   recorded state first; that cost is measured separately and subtracted.
+// - Plays the same battles on both AtbClocks and reports how many kept the same turn order.
+// - Times the turns played from a state with both sides' EffectTables full against the same turns without effects,
+//   BENCH_EFFECT_TURNS per untimed restore, restoring a state with full tables, and adding and dispelling one effect,
+//   per CombatConfig; then the same with effect bits bound to stats, so the effects also rebuild effective stats.
+// - Times whole battles, setup included, in 1v20 and 30v30 and on the fixed clock, and whole 5v5 battles under each SkillDispatch mode (switch, function pointer and SkillProgram) and checks
+//   that all of them end in the same states. SkillPrograms come from --skills, or else from BENCH_DEMO_SKILLS.
+// - Times the resolve phase of DEMO_ATTACK and DEMO_CLEAVE alone, as a hand-written builder and as a SkillProgram.
+// - Runs the CombatKernels self-test first and times each kernel against its scalar kernel at 5 and 30 units;
+//   a self-test mismatch exits with 2 even with --no-budget. Then checks that register_passive refuses out-of-range
+//   indices and a passive past a full table, which also exits with 2.
+// - Each case runs BENCH_REPEATS times and reports the fastest, which filters out scheduler noise.
+// - Checks the results against the budgets below and exits with 2 if any is exceeded, so CI can gate on it.
+// - With --json, also writes the results to FILE. --compare reads two such files (an old build's, then a new one's)
+//   and exits with 2 if any case got slower by more than --threshold percent (default 10), so CI can compare builds.
+//
+// Usage: combat_benchmark [--iterations N] [--no-budget] [--skills FILE] [--json FILE]
+//        combat_benchmark --compare BASE NEW [--threshold PCT]
+// Build with the same flags as the battle simulator (-O2 -ffp-contract=off).
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/data/skills/active_event_builders.h"
+#include "pipelinepunch/data/skills/alias.h"
+#include "pipelinepunch/data/skills/skill_program.h"
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_stat.h"
+#include "pipelinepunch/systems/combat_system/kernels/combat_kernels.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_state.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+
+namespace pipelinepunch {
+
+    constexpr int    BENCH_REPEATS          = 5;     // Runs per case; the fastest is reported.
+    constexpr int    BENCH_STATE_RING       = 64;    // BattleStates cycled through, so copies are not elided.
+    constexpr int    BENCH_WARMUP_TURNS     = 6;     // Turns played before measuring, to reach a mid-battle state.
+    constexpr size_t BENCH_STATE_BYTES      = 8192;  // Budget: sizeof(BattleState) in 5v5, which a state copy and every journal snapshot slot take.
+    constexpr size_t BENCH_STATE_CORE_BYTES = 512;   // Budget: the same less its EffectTables, all that snapshot_state copies without effects.
+    constexpr size_t BENCH_HOT_TABLE_BYTES  = 320;   // Budget: sizeof(CharacterTable) in 5v5, i.e. five cache lines per side.
+    constexpr double BENCH_COPY_NS          = 100.0; // Budget: 5v5 snapshot_state or restore_state.
+    constexpr int    BENCH_BATTLE_DIVISOR   = 100;   // Battles per dispatch case, as a fraction of --iterations.
+    constexpr int    BENCH_MAX_TURNS        = 1000;  // Turn cap of a dispatch case battle.
+    constexpr int    BENCH_KERNEL_ROUNDS    = 20000; // Random inputs checked by the CombatKernels self-test.
+    constexpr int    BENCH_JSON_SCHEMA      = 1;     // Version of the --json format.
+    constexpr double BENCH_THRESHOLD_PCT    = 10.0;  // Default slowdown --compare flags as a regression.
+    constexpr double BENCH_NOISE_NS         = 0.5;   // Slowdowns smaller than this are never flagged, whatever the percentage.
+    constexpr double BENCH_NO_TIME          = -1.0;  // Result of a case whose setup took as long as the whole case: noise, not a time.
+    constexpr int    BENCH_FORECAST         = 16;    // Actors previewed by the forecast case, as a turn order bar shows.
+    constexpr int    BENCH_ORDER_BATTLES    = 1000;  // Battles played on both clocks by the turn order comparison.
+    constexpr int    BENCH_EFFECT_SPREAD    = 32;    // Effect durations of the effect cases, in quarter bars past the first bar.
+    constexpr int    BENCH_EFFECT_TURNS     = 8;     // Turns the effect turn cases play from each restored state.
+
+    // SkillProgram source of the demo skills (as in demo_skills.txt), so the program case runs without a file.
+    constexpr const char* BENCH_DEMO_SKILLS =
+        "skill 0 demo_attack\n" "target single\n" "power 200\n" "power_vs undead 400\n" "mul owner atk\n" "div target def\n" "damage\n" "end\n"
+        "skill 1 demo_cleave\n" "target all\n"    "power 100\n" "power_vs undead 200\n" "mul owner atk\n" "div target def\n" "damage\n" "end\n";
+
+    // Represents the benchmark's command-line configuration.
+    struct BenchConfig {
+        int         iterations { 200000 };
+        bool        budget     { true };
+        const char* skills     { nullptr }; // Skill file for the program case; nullptr uses BENCH_DEMO_SKILLS.
+        const char* json       { nullptr }; // File the results are written to.
+        const char* base       { nullptr }; // --compare: results of the old build.
+        const char* compare    { nullptr }; // --compare: results of the new build.
+        double      threshold  { BENCH_THRESHOLD_PCT };
+    };
+
+    // Represents a benchmark result.
+    struct BenchResult {
+        const char* mode;
+        const char* name;
+        double      ns_per_op;
+    };
+
+    // Represents a result read back from a --json file.
+    struct BenchRecord {
+        std::string mode;
+        std::string name;
+        double      ns_per_op;
+    };
+
+    // Keeps a value alive so the optimiser cannot drop the work that produced it.
+    static volatile uint64_t bench_sink = 0;
+
+    // Gets the fastest time per operation of a case over BENCH_REPEATS runs.
+    template <typename Body>
+    static double time_case(int iterations, Body&& body) {
+        double best = 1e300;
+
+        for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) { body(i); }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            best = std::min(best, seconds * 1e9 / iterations);
+        }
+
+        return best;
+    }
+
+    // Gets the time of a case timed with its setup, less the setup timed alone. Returns BENCH_NO_TIME if the setup
+    // took at least as long as the whole case, which then only measured noise.
+    static double less_setup(double total_ns, double setup_ns) {
+        return (total_ns > setup_ns) ? total_ns - setup_ns : BENCH_NO_TIME;
+    }
+
+    // Builds the runtime CharacterSheets of a party, cycling through the creature library.
+    template <size_t N>
+    static void build_party(int size, std::array<CharacterSheet, N>& sheets, std::array<const CharacterSheet*, N>& slots) {
+        const CreatureSheet* creature_library = get_creature_library();
+
+        for (size_t pos = 0; pos < N; pos++) {
+            if (static_cast<int>(pos) >= size) {
+                slots[pos] = nullptr;
+                continue;
+            }
+
+            const CreatureSheet& creature = creature_library[pos % CREATURE_LIBRARY_SIZE];
+            sheets[pos] = CharacterSheet{};
+            sheets[pos].creature_sheet = creature;
+            sheets[pos].stats          = creature.stats;
+            sheets[pos].skills         = creature.skills;
+            slots[pos] = &sheets[pos];
+        }
+    }
+
+    // Plays a turn with skill slot 0 against the first living opponent.
+    template <typename Config>
+    static void play_turn(CombatEngine<Config>& engine) {
+        const int other = 1 - engine.get_main_intent().owner_team_index;
+
+        int target_pos = 0;
+        while (target_pos < Config::TEAM_SIZE - 1 && !engine.is_alive(other, target_pos)) { target_pos++; }
+
+        engine.turn(0, target_pos);
+    }
+
+    // Runs the state benchmarks of one CombatConfig.
+    template <typename Config>
+    static void run_mode(const char* mode, int ally_count, const BenchConfig& config, std::vector<BenchResult>& results) {
+        constexpr int N = Config::TEAM_SIZE;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(ally_count, ally_sheets, ally_slots);
+        build_party(N, opponent_sheets, opponent_slots);
+
+        // Engines and state rings are large in the wide modes, so they live on the heap.
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        std::unique_ptr<CombatEngine<Config>> child(new CombatEngine<Config>());
+        std::vector<typename CombatEngine<Config>::State> states(BENCH_STATE_RING);
+
+        engine->setup_from_sheets(ally_slots, opponent_slots);
+        engine->set_seed(1);
+        engine->roll_initiative();
+        for (int turn = 0; turn < BENCH_WARMUP_TURNS && engine->get_combat_state() == CombatState::RUNNING; turn++) { play_turn(*engine); }
+
+        for (auto& state : states) { engine->snapshot_state(state); }
+
+        const int iterations = config.iterations;
+
+        std::printf("%-7s sizeof(BattleState)        %zu bytes\n", mode, sizeof(typename CombatEngine<Config>::State));
+        std::printf("%-7s sizeof(CharacterTable)     %zu bytes (hot, per side)\n", mode, sizeof(CharacterTable<N>));
+        std::printf("%-7s sizeof(CharacterColdTable) %zu bytes (cold, per side)\n", mode, sizeof(CharacterColdTable<N>));
+        std::printf("%-7s sizeof(Event)              %zu bytes\n", mode, sizeof(Event<N>));
+        std::printf("%-7s sizeof(BattleContext)      %zu bytes (event arena and queues)\n", mode, sizeof(BattleContext<Config>));
+        std::printf("%-7s sizeof(CombatEngine)       %zu bytes\n", mode, sizeof(CombatEngine<Config>));
+
+        results.push_back({ mode, "snapshot_state", time_case(iterations, [&](int i) {
+            engine->snapshot_state(states[i & (BENCH_STATE_RING - 1)]);
+        }) });
+
+        results.push_back({ mode, "restore_state", time_case(iterations, [&](int i) {
+            engine->restore_state(states[i & (BENCH_STATE_RING - 1)]);
+        }) });
+
+        results.push_back({ mode, "state_copy", time_case(iterations, [&](int i) {
+            states[(i + 1) & (BENCH_STATE_RING - 1)] = states[i & (BENCH_STATE_RING - 1)];
+        }) });
+
+        // Forks copy the whole engine, so they run fewer times.
+        results.push_back({ mode, "fork", time_case(std::max(1, iterations / 16), [&](int) {
+            engine->fork(*child);
+            bench_sink = bench_sink + static_cast<uint64_t>(child->get_turn_count());
+        }) });
+
+        // Undo as used by AI lookahead: save, play a turn, roll back.
+        typename CombatEngine<Config>::State saved;
+        results.push_back({ mode, "undo_turn", time_case(iterations, [&](int) {
+            engine->snapshot_state(saved);
+            if (engine->get_combat_state() == CombatState::RUNNING) { play_turn(*engine); }
+            engine->restore_state(saved);
+        }) });
+
+        bench_sink = bench_sink + engine->get_state_hash();
+    }
+
+    // Gives the benchmark the CombatEngine's private turn phases, so each can be timed on its own.
+    template <typename Config>
+    struct CombatEngineProbe {
+        static constexpr int N = Config::TEAM_SIZE;
+
+        // Sets the current actor's skill slot and target, as turn() does before building its events.
+        static void aim(CombatEngine<Config>& engine, int skill_slot, int target_pos) {
+            engine.main_intent.skill_slot = skill_slot;
+            engine.main_intent.target_pos = target_pos;
+        }
+
+        static void get_next_character(CombatEngine<Config>& engine)     { engine.get_next_character(engine.main_intent); }
+        static void build_main_event_queue(CombatEngine<Config>& engine) { engine.build_main_event_queue(engine.main_intent); }
+        static void resolve_event(CombatEngine<Config>& engine, Event<N>& e)  { engine.resolve_event(e); }
+        static void resolve_events(CombatEngine<Config>& engine, Event<N>& e) { engine.resolve_events(e); }
+
+        // Gets the passives an event triggers, into emptied reaction queues.
+        static void get_passives(CombatEngine<Config>& engine, Event<N>& e) {
+            engine.context.begin_cascade();
+            engine.get_passives(e);
+        }
+
+        // Gets the first event of the main_event_queue, or nullptr if the last build queued none.
+        static const Event<N>* main_event(const CombatEngine<Config>& engine) {
+            return engine.context.main_event_queue.count > 0 ? &engine.context.get_event(engine.context.main_event_queue, 0) : nullptr;
+        }
+    };
+
+    // Passive condition of the phase cases: the event's target is below half life.
+    template <int N>
+    static bool bench_target_wounded(const CharacterTable<N>&, const CharacterTable<N>& other_ct, const Intent& intent) {
+        return intent.target_pos >= 0 && intent.target_pos < N && other_ct.life_bar[other_ct.pos_to_index[intent.target_pos]] < 0.5f;
+    }
+
+    // Gets the target of play_turn: the first living opponent.
+    template <typename Config>
+    static int first_living_target(const CombatEngine<Config>& engine) {
+        const int other = 1 - engine.get_main_intent().owner_team_index;
+
+        int target_pos = 0;
+        while (target_pos < Config::TEAM_SIZE - 1 && !engine.is_alive(other, target_pos)) { target_pos++; }
+
+        return target_pos;
+    }
+
+    // Checks register_passive on one CombatConfig: filters outside [-1, N) and owners outside [0, N) or teams other
+    // than 0 and 1 are refused, a tier's table takes N passives per side, here all of them on one unit, and the next
+    // one is refused. Returns the number of failed checks.
+    template <typename Config>
+    static int check_passive_registration() {
+        constexpr int N = Config::TEAM_SIZE;
+
+        std::array<CharacterSheet, N>        sheets;
+        std::array<const CharacterSheet*, N> slots;
+        build_party(N, sheets, slots);
+
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        engine->setup_from_sheets(slots, slots);
+
+        Intent owner;
+        owner.owner_team_index = 0;
+        owner.owner_index      = 0;
+        owner.skill_slot       = 0;
+        owner.target_pos       = -1;
+
+        Intent bad_owner = owner;
+        bad_owner.owner_index = N;
+        Intent bad_team = owner;
+        bad_team.owner_team_index = 2;
+
+        int failures = 0;
+        if (engine->register_passive(PassiveTier::REACT, owner,     DAMAGE, N,  -1, bench_target_wounded<N>)) { failures++; }
+        if (engine->register_passive(PassiveTier::REACT, owner,     DAMAGE, -1, -2, bench_target_wounded<N>)) { failures++; }
+        if (engine->register_passive(PassiveTier::REACT, bad_owner, DAMAGE, -1, -1, bench_target_wounded<N>)) { failures++; }
+        if (engine->register_passive(PassiveTier::REACT, bad_team,  DAMAGE, -1, -1, bench_target_wounded<N>)) { failures++; }
+
+        for (int k = 0; k < N; k++) {
+            if (!engine->register_passive(PassiveTier::REACT, owner, DAMAGE, -1, k, bench_target_wounded<N>)) { failures++; }
+        }
+        if (engine->register_passive(PassiveTier::REACT, owner, DAMAGE, -1, 0, bench_target_wounded<N>)) { failures++; }
+        if (!engine->register_passive(PassiveTier::MODIFY, owner, DAMAGE, -1, 0, bench_target_wounded<N>)) { failures++; }
+
+        return failures;
+    }
+
+    // Times each turn phase of one CombatConfig over BENCH_STATE_RING states recorded from whole battles.
+    // - Every unit has a react passive watching for damage to itself, so get_passives runs its trigger index and
+    //   conditions. Demo skills have no PassiveEventBuilder, so the passives queue nothing and the battles are unchanged.
+    // - Each case restores a recorded state and copies its main event before running a phase, so every call sees a
+    //   real mid-battle state; the cost of that setup is timed alone and subtracted.
+    template <typename Config>
+    static void run_phases(const char* mode, int ally_count, const BenchConfig& config, std::vector<BenchResult>& results) {
+        constexpr int N = Config::TEAM_SIZE;
+        using Probe = CombatEngineProbe<Config>;
+        using State = typename CombatEngine<Config>::State;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(ally_count, ally_sheets, ally_slots);
+        build_party(N, opponent_sheets, opponent_slots);
+
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        std::vector<State>                    turn_states(BENCH_STATE_RING); // Before a turn's events are built.
+        std::vector<State>                    next_states(BENCH_STATE_RING); // After they resolved, before the next actor is picked.
+        std::vector<Event<N>>                 events(BENCH_STATE_RING);      // The turn's main event, as built.
+        std::vector<int>                      targets(BENCH_STATE_RING);
+
+        // Records the ring from consecutive battles, one state per turn. Every battle is set up again, as a new one
+        // starts from full life; restoring a state brings back the live masks of the passives it was taken with.
+        int recorded = 0;
+        for (uint64_t seed = 1; recorded < BENCH_STATE_RING; seed++) {
+            engine->setup_from_sheets(ally_slots, opponent_slots);
+            for (int team_index = 0; team_index < 2; team_index++) {
+                for (int index = 0; index < N; index++) {
+                    Intent owner;
+                    owner.owner_team_index = team_index;
+                    owner.owner_index      = index;
+                    owner.skill_slot       = 0;
+                    owner.target_pos       = -1;
+                    engine->register_passive(PassiveTier::REACT, owner, DAMAGE, -1, index, bench_target_wounded<N>);
+                }
+            }
+
+            engine->set_seed(seed);
+            engine->roll_initiative();
+
+            while (recorded < BENCH_STATE_RING && engine->get_combat_state() == CombatState::RUNNING && engine->get_turn_count() < BENCH_MAX_TURNS) {
+                const int target_pos = first_living_target(*engine);
+
+                State before;
+                engine->snapshot_state(before);
+                Probe::aim(*engine, 0, target_pos);
+                Probe::build_main_event_queue(*engine);
+
+                if (const Event<N>* e = Probe::main_event(*engine)) {
+                    turn_states[recorded] = before;
+                    events[recorded]      = *e;
+                    targets[recorded]     = target_pos;
+
+                    Probe::resolve_events(*engine, events[recorded]);
+                    engine->snapshot_state(next_states[recorded]);
+                    events[recorded] = *e;
+                    recorded++;
+                }
+
+                engine->restore_state(before);
+                engine->turn(0, target_pos);
+            }
+        }
+
+        const int iterations = config.iterations;
+        Event<N>  event;
+
+        // Times a phase after restoring ring state i and copying its event, minus the time of that setup alone.
+        auto time_phase = [&](const std::vector<State>& states, auto&& phase) {
+            auto setup = [&](int i) {
+                engine->restore_state(states[i & (BENCH_STATE_RING - 1)]);
+                event = events[i & (BENCH_STATE_RING - 1)];
+            };
+
+            const double setup_ns = time_case(iterations, [&](int i) { setup(i); bench_sink = bench_sink + static_cast<uint64_t>(event.intent.owner_index); });
+            const double total_ns = time_case(iterations, [&](int i) { setup(i); phase(i & (BENCH_STATE_RING - 1)); });
+            bench_sink = bench_sink + engine->get_state_hash();
+
+            return less_setup(total_ns, setup_ns);
+        };
+
+        results.push_back({ mode, "get_next_character", time_phase(next_states, [&](int) {
+            Probe::get_next_character(*engine);
+        }) });
+
+        results.push_back({ mode, "build_main_event_queue", time_phase(turn_states, [&](int k) {
+            Probe::aim(*engine, 0, targets[k]);
+            Probe::build_main_event_queue(*engine);
+        }) });
+
+        results.push_back({ mode, "get_passives", time_phase(turn_states, [&](int) {
+            Probe::get_passives(*engine, event);
+        }) });
+
+        results.push_back({ mode, "resolve_event", time_phase(turn_states, [&](int) {
+            Probe::resolve_event(*engine, event);
+        }) });
+
+        results.push_back({ mode, "resolve_events", time_phase(turn_states, [&](int) {
+            Probe::resolve_events(*engine, event);
+        }) });
+
+        results.push_back({ mode, "turn", time_phase(turn_states, [&](int k) {
+            engine->turn(0, targets[k]);
+        }) });
+
+        Intent forecast[BENCH_FORECAST];
+        results.push_back({ mode, "turn_order_forecast", time_phase(turn_states, [&](int) {
+            bench_sink = bench_sink + static_cast<uint64_t>(engine->get_turn_order_forecast(forecast, BENCH_FORECAST));
+        }) });
+    }
+
+    // Times the timed effect cases of one CombatConfig, from a battle's first turn without effects and the same state
+    // with both EffectTables filled to capacity. Effects are spread over each side's living units, with durations
+    // of one to BENCH_EFFECT_SPREAD / 4 more bars, so some expire in the timed turns while most stay on the wheel.
+    // The full cases run again with half the effect bits bound to stats, so the effects also move effective stats.
+    template <typename Config>
+    static void run_effects(const char* mode, int ally_count, const BenchConfig& config, std::vector<BenchResult>& results) {
+        constexpr int N = Config::TEAM_SIZE;
+        using Effects = typename CombatEngine<Config>::Effects;
+        using State   = typename CombatEngine<Config>::State;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(ally_count, ally_sheets, ally_slots);
+        build_party(N, opponent_sheets, opponent_slots);
+
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        std::unique_ptr<State>                plain(new State());
+        std::unique_ptr<State>                loaded(new State());
+
+        // Starts a battle from its first turn, as a raid's lone ally may not survive a warmup.
+        auto start_battle = [&]() {
+            engine->setup_from_sheets(ally_slots, opponent_slots);
+            engine->set_seed(1);
+            engine->roll_initiative();
+        };
+
+        // Fills both EffectTables, spreading effects over each side's living units.
+        auto fill_tables = [&]() {
+            for (int team_index = 0; team_index < 2; team_index++) {
+                int living[N];
+                int living_count = 0;
+                for (int index = 0; index < N; index++) {
+                    if (engine->get_character_table(team_index).life[index] > 0.0f) { living[living_count++] = index; }
+                }
+
+                for (int k = 0; living_count > 0 && k < Effects::MAX_EFFECTS; k++) {
+                    engine->add_effect(team_index, living[k % living_count], 1u << (k % 16), 0.25f, 1.0f + 0.25f * static_cast<float>(k % BENCH_EFFECT_SPREAD));
+                }
+            }
+        };
+
+        // Gives the first living ally a side's worth of effects, less one, that outlast the case.
+        auto load_holder = [&]() {
+            int holder = 0;
+            while (holder < N - 1 && engine->get_character_table(0).life[holder] <= 0.0f) { holder++; }
+            for (int k = 0; k < Effects::MAX_EFFECTS - 1; k++) { engine->add_effect(0, holder, 1u << (k % 16), 0.25f, 64.0f); }
+            return holder;
+        };
+
+        start_battle();
+        engine->snapshot_state(*plain);
+        fill_tables();
+        engine->snapshot_state(*loaded);
+
+        std::printf("%-7s effects per side           %d capacity (%d per unit), %d and %d live when full\n", mode, Effects::MAX_EFFECTS, Config::EFFECTS_PER_UNIT, engine->get_effect_table(0).count, engine->get_effect_table(1).count);
+
+        const int iterations = config.iterations;
+
+        // Times the turns played from a state, BENCH_EFFECT_TURNS per restore, with only the turns inside the clock.
+        // Gets the fastest time per turn played over BENCH_REPEATS runs, or BENCH_NO_TIME if no turn was legal.
+        auto time_turn = [&](const State& state) {
+            const int blocks = std::max(1, iterations / BENCH_EFFECT_TURNS);
+            double    best   = BENCH_NO_TIME;
+
+            for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+                double  seconds = 0.0;
+                int64_t played  = 0;
+
+                for (int block = 0; block < blocks; block++) {
+                    engine->restore_state(state);
+
+                    const auto start = std::chrono::steady_clock::now();
+                    for (int turn = 0; turn < BENCH_EFFECT_TURNS; turn++) { played += engine->turn(0, first_living_target(*engine)) ? 1 : 0; }
+                    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                }
+
+                if (played > 0 && (best < 0.0 || seconds * 1e9 / played < best)) { best = seconds * 1e9 / played; }
+            }
+            bench_sink = bench_sink + engine->get_state_hash();
+
+            return best;
+        };
+
+        results.push_back({ mode, "turn_no_effects", time_turn(*plain) });
+        results.push_back({ mode, "turn_full_effects", time_turn(*loaded) });
+
+        results.push_back({ mode, "restore_full_effects", time_case(iterations, [&](int) {
+            engine->restore_state(*loaded);
+        }) });
+
+        // One more effect on a unit of a full side's worth of effects, then dispelled by its own bit.
+        engine->restore_state(*plain);
+        int holder = load_holder();
+        results.push_back({ mode, "add_dispel_effect", time_case(iterations, [&](int) {
+            engine->add_effect(0, holder, 1u << 20, 0.25f, 1.0f);
+            bench_sink = bench_sink + static_cast<uint64_t>(engine->dispel_effects(0, holder, 1u << 20));
+        }) });
+
+        // Bits 0-7 and 20 raise stats from here on; bindings are made between battles.
+        for (int bit = 0; bit < 8; bit++) { engine->bind_effect_stat(1u << bit, static_cast<CombatStat>(bit % static_cast<int>(CombatStat::COUNT))); }
+        engine->bind_effect_stat(1u << 20, CombatStat::SPE);
+
+        start_battle();
+        engine->snapshot_state(*plain);
+        fill_tables();
+        engine->snapshot_state(*loaded);
+
+        results.push_back({ mode, "turn_stat_effects", time_turn(*loaded) });
+
+        // Alternates with the state without effects, so every restore rebuilds the stats of every holder.
+        results.push_back({ mode, "restore_stat_effects", time_case(iterations, [&](int i) {
+            engine->restore_state((i & 1) ? *plain : *loaded);
+        }) });
+
+        // A speed effect on the same holder, so both the add and the dispel rebuild its stats from its effects.
+        engine->restore_state(*plain);
+        holder = load_holder();
+        results.push_back({ mode, "add_dispel_stat_effect", time_case(iterations, [&](int) {
+            engine->add_effect(0, holder, 1u << 20, 0.25f, 1.0f);
+            bench_sink = bench_sink + static_cast<uint64_t>(engine->dispel_effects(0, holder, 1u << 20));
+        }) });
+    }
+
+    // Plays the same battles on a float-clock and a fixed-clock CombatConfig and counts those whose actors come in
+    // the same order, to show how often the two clocks disagree. Prints the count, and how many turns the other
+    // battles agreed for on average, and returns the count.
+    template <typename FloatConfig, typename FixedConfig>
+    static int compare_turn_orders(const char* mode, int ally_count, int battles) {
+        constexpr int N = FloatConfig::TEAM_SIZE;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(ally_count, ally_sheets, ally_slots);
+        build_party(N, opponent_sheets, opponent_slots);
+
+        std::unique_ptr<CombatEngine<FloatConfig>> float_engine(new CombatEngine<FloatConfig>());
+        std::unique_ptr<CombatEngine<FixedConfig>> fixed_engine(new CombatEngine<FixedConfig>());
+
+        int     same   = 0;
+        int64_t agreed = 0; // Turns played in the same order by the battles that diverged.
+        for (int i = 0; i < battles; i++) {
+            float_engine->setup_from_sheets(ally_slots, opponent_slots);
+            fixed_engine->setup_from_sheets(ally_slots, opponent_slots);
+            float_engine->set_seed(static_cast<uint64_t>(i) + 1);
+            fixed_engine->set_seed(static_cast<uint64_t>(i) + 1);
+            float_engine->roll_initiative();
+            fixed_engine->roll_initiative();
+
+            bool agree = true;
+            while (agree && float_engine->get_combat_state() == CombatState::RUNNING && float_engine->get_turn_count() < BENCH_MAX_TURNS) {
+                const Intent& a = float_engine->get_main_intent();
+                const Intent& b = fixed_engine->get_main_intent();
+                agree = fixed_engine->get_combat_state() == CombatState::RUNNING && a.owner_team_index == b.owner_team_index && a.owner_index == b.owner_index;
+                if (!agree) { agreed += float_engine->get_turn_count(); }
+
+                play_turn(*float_engine);
+                play_turn(*fixed_engine);
+            }
+            if (agree && float_engine->get_combat_state() == fixed_engine->get_combat_state()) { same++; }
+        }
+
+        std::printf("%-7s turn order, fixed vs float clock: %d of %d battles identical", mode, same, battles);
+        if (same < battles) { std::printf(", the others for %.1f turns on average", static_cast<double>(agreed) / (battles - same)); }
+        std::printf("\n");
+        return same;
+    }
+
+    // Times whole battles (setup included) of a CombatConfig, one seed per battle, and returns the sum of their final state hashes.
+    template <typename Config>
+    static uint64_t run_battles(const char* mode, const char* name, int ally_count, const BenchConfig& config, std::vector<BenchResult>& results, const SkillProgramLibrary* skill_programs = nullptr) {
+        constexpr int N = Config::TEAM_SIZE;
+
+        std::array<CharacterSheet, N>        ally_sheets;
+        std::array<CharacterSheet, N>        opponent_sheets;
+        std::array<const CharacterSheet*, N> ally_slots;
+        std::array<const CharacterSheet*, N> opponent_slots;
+        build_party(ally_count, ally_sheets, ally_slots);
+        build_party(N, opponent_sheets, opponent_slots);
+
+        std::unique_ptr<CombatEngine<Config>> engine(new CombatEngine<Config>());
+        engine->set_skill_programs(skill_programs);
+
+        const int battles = std::max(1, config.iterations / BENCH_BATTLE_DIVISOR);
+        uint64_t  digest  = 0;
+
+        results.push_back({ mode, name, time_case(battles, [&](int i) {
+            engine->setup_from_sheets(ally_slots, opponent_slots);
+            engine->set_seed(static_cast<uint64_t>(i) + 1);
+            engine->roll_initiative();
+            while (engine->get_combat_state() == CombatState::RUNNING && engine->get_turn_count() < BENCH_MAX_TURNS) { play_turn(*engine); }
+            digest += engine->get_state_hash();
+        }) });
+
+        return digest;
+    }
+
+    // Times the resolve phase of one skill in a mid-battle 5v5 state, through its builder and through its SkillProgram.
+    // Skills with no program are skipped.
+    static void run_resolve(const char* builder_name, const char* program_name, SkillEnum skill_enum, const BenchConfig& config, const SkillProgramLibrary& skill_programs, std::vector<BenchResult>& results) {
+        using Config = Config5v5Program;
+        constexpr int N = Config::TEAM_SIZE;
+
+        const SkillProgram* program = skill_programs.find(skill_enum);
+        if (!program) return;
+
+        std::array<CharacterSheet, N>        sheets;
+        std::array<const CharacterSheet*, N> slots;
+        build_party(N, sheets, slots);
+
+        std::unique_ptr<CombatEngine<Config>>  engine(new CombatEngine<Config>());
+        std::unique_ptr<BattleContext<Config>> context(new BattleContext<Config>());
+        engine->setup_from_sheets(slots, slots);
+        engine->set_seed(1);
+        engine->roll_initiative();
+        for (int turn = 0; turn < BENCH_WARMUP_TURNS && engine->get_combat_state() == CombatState::RUNNING; turn++) { play_turn(*engine); }
+
+        const Intent             intent   = engine->get_main_intent();
+        const CharacterTable<N>& owner_ct = engine->get_character_table(intent.owner_team_index);
+        const CharacterTable<N>& other_ct = engine->get_character_table(1 - intent.owner_team_index);
+
+        // Cycles the target position, so every lane's type and stats are read.
+        Intent   targeted[N];
+        Event<N> event {};
+        for (int pos = 0; pos < N; pos++) {
+            targeted[pos]            = intent;
+            targeted[pos].target_pos = pos;
+        }
+
+        results.push_back({ "5v5", builder_name, time_case(config.iterations, [&](int i) {
+            dispatch_active_event_builder<Config, SkillPhase::RESOLVE>(skill_enum, *context, owner_ct, other_ct, targeted[i % N], &event);
+            bench_sink = bench_sink + static_cast<uint64_t>(event.other_pos_damage[i % N]);
+        }) });
+
+        results.push_back({ "5v5", program_name, time_case(config.iterations, [&](int i) {
+            run_skill_program<Config, SkillPhase::RESOLVE>(*program, *context, owner_ct, other_ct, targeted[i % N], &event);
+            bench_sink = bench_sink + static_cast<uint64_t>(event.other_pos_damage[i % N]);
+        }) });
+    }
+
+    // Times the CombatKernels and their scalar kernels over count units of one side, in a mid-battle shape:
+    // one unit in five hit, the rest untouched.
+    template <int COUNT>
+    static void run_kernels(const char* mode, const BenchConfig& config, std::vector<BenchResult>& results) {
+        float   life[COUNT], life_bar[COUNT], lp[COUNT], damage[COUNT];
+        int32_t power[COUNT], divisor[COUNT], ratio[COUNT];
+        for (int i = 0; i < COUNT; i++) {
+            lp[i]       = 1000.0f + 10.0f * i;
+            life[i]     = lp[i];
+            life_bar[i] = 1.0f;
+            damage[i]   = (i % 5 == 0) ? 0.5f : 0.0f;
+            power[i]    = (i % 2 == 0) ? 100 : 200;
+            divisor[i]  = 30 + i;
+        }
+
+        // Refills life every 1024 calls, so the units never all die and the dying branch stays rare.
+        results.push_back({ mode, "apply_damage_simd", time_case(config.iterations, [&](int i) {
+            if ((i & 1023) == 0) { for (int u = 0; u < COUNT; u++) { life[u] = lp[u]; } }
+            bench_sink = bench_sink + apply_damage(life, life_bar, lp, damage, COUNT);
+        }) });
+
+        results.push_back({ mode, "apply_damage_scalar", time_case(config.iterations, [&](int i) {
+            if ((i & 1023) == 0) { for (int u = 0; u < COUNT; u++) { life[u] = lp[u]; } }
+            bench_sink = bench_sink + apply_damage_scalar(life, life_bar, lp, damage, 0, COUNT);
+        }) });
+
+        results.push_back({ mode, "scaled_ratio_simd", time_case(config.iterations, [&](int i) {
+            scaled_ratio(ratio, power, 40 + (i & 7), divisor, COUNT);
+            bench_sink = bench_sink + static_cast<uint64_t>(ratio[i % COUNT]);
+        }) });
+
+        results.push_back({ mode, "scaled_ratio_scalar", time_case(config.iterations, [&](int i) {
+            scaled_ratio_scalar(ratio, power, 40 + (i & 7), divisor, 0, COUNT);
+            bench_sink = bench_sink + static_cast<uint64_t>(ratio[i % COUNT]);
+        }) });
+    }
+
+    // Parses command-line arguments into a BenchConfig.
+    static bool parse_args(int argc, char** argv, BenchConfig& config) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (std::strcmp(arg, "--no-budget") == 0) {
+                config.budget = false;
+                continue;
+            }
+
+            if (!value) return false;
+
+            if (std::strcmp(arg, "--compare") == 0) {
+                if (i + 2 >= argc) return false;
+                config.base    = argv[i + 1];
+                config.compare = argv[i + 2];
+                i += 2;
+                continue;
+            }
+
+            if      (std::strcmp(arg, "--iterations") == 0) { config.iterations = std::max(1, std::atoi(value)); }
+            else if (std::strcmp(arg, "--skills")     == 0) { config.skills     = value; }
+            else if (std::strcmp(arg, "--json")       == 0) { config.json       = value; }
+            else if (std::strcmp(arg, "--threshold")  == 0) { config.threshold  = std::atof(value); }
+            else return false;
+
+            i++;
+        }
+
+        return config.threshold >= 0.0 && !(config.compare && config.json);
+    }
+
+    // Writes the results to a --json file, one result per line, leaving out cases that measured only noise, so
+    // --compare reports them as new or removed rather than as 0 ns. Returns false on a write error.
+    static bool write_json(const char* path, const BenchConfig& config, const std::vector<BenchResult>& results) {
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file) return false;
+
+        std::vector<const BenchResult*> timed;
+        for (const BenchResult& result : results) {
+            if (result.ns_per_op != BENCH_NO_TIME) { timed.push_back(&result); }
+        }
+
+        std::fprintf(file, "{\n  \"schema\": %d,\n  \"isa\": \"%s\",\n  \"iterations\": %d,\n  \"results\": [\n", BENCH_JSON_SCHEMA, COMBAT_KERNEL_ISA, config.iterations);
+        for (size_t i = 0; i < timed.size(); i++) {
+            std::fprintf(file, "    { \"mode\": \"%s\", \"name\": \"%s\", \"ns_per_op\": %.3f }%s\n", timed[i]->mode, timed[i]->name, timed[i]->ns_per_op, (i + 1 < timed.size()) ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+
+        return std::fclose(file) == 0;
+    }
+
+    // Reads the results of a file written by write_json. Returns false, after printing why, if it is not one.
+    static bool read_json(const char* path, std::vector<BenchRecord>& records) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            std::fprintf(stderr, "--compare: cannot open %s\n", path);
+            return false;
+        }
+
+        char line[256];
+        int  schema = 0;
+        while (std::fgets(line, sizeof(line), file)) {
+            char   mode[16];
+            char   name[48];
+            double ns_per_op = 0.0;
+
+            if (std::sscanf(line, " \"schema\": %d", &schema) == 1) continue;
+            if (std::sscanf(line, " { \"mode\": \"%15[^\"]\", \"name\": \"%47[^\"]\", \"ns_per_op\": %lf", mode, name, &ns_per_op) == 3) {
+                records.push_back({ mode, name, ns_per_op });
+            }
+        }
+        std::fclose(file);
+
+        if (schema != BENCH_JSON_SCHEMA) {
+            std::fprintf(stderr, "--compare: %s is not a combat_benchmark --json file of schema %d\n", path, BENCH_JSON_SCHEMA);
+            return false;
+        }
+        return true;
+    }
+
+    // Compares two --json files case by case. A case regresses if it got slower by more than the threshold
+    // percentage and by more than BENCH_NOISE_NS; a case at 0 ns in the base regresses on the second test alone.
+    // Returns the process exit status: 2 if any case regressed.
+    static int compare_results(const BenchConfig& config) {
+        std::vector<BenchRecord> base;
+        std::vector<BenchRecord> next;
+        if (!read_json(config.base, base) || !read_json(config.compare, next)) { return 1; }
+
+        int regressions = 0;
+        std::printf("%-7s %-24s %12s %12s %9s\n", "mode", "case", "base ns/op", "new ns/op", "change");
+
+        for (const BenchRecord& record : next) {
+            const BenchRecord* old = nullptr;
+            for (const BenchRecord& candidate : base) {
+                if (candidate.mode == record.mode && candidate.name == record.name) { old = &candidate; }
+            }
+
+            if (!old) {
+                std::printf("%-7s %-24s %12s %12.1f %9s\n", record.mode.c_str(), record.name.c_str(), "-", record.ns_per_op, "new");
+                continue;
+            }
+
+            const double slower    = record.ns_per_op - old->ns_per_op;
+            const double change    = (old->ns_per_op > 0.0) ? (record.ns_per_op / old->ns_per_op - 1.0) * 100.0 : 0.0;
+            const bool   regressed = slower > BENCH_NOISE_NS && (change > config.threshold || old->ns_per_op <= 0.0);
+            if (regressed) { regressions++; }
+
+            if (old->ns_per_op > 0.0) { std::printf("%-7s %-24s %12.1f %12.1f %+8.1f%%%s\n", record.mode.c_str(), record.name.c_str(), old->ns_per_op, record.ns_per_op, change, regressed ? "  REGRESSION" : ""); }
+            else                      { std::printf("%-7s %-24s %12.1f %12.1f %9s%s\n", record.mode.c_str(), record.name.c_str(), old->ns_per_op, record.ns_per_op, "from 0", regressed ? "  REGRESSION" : ""); }
+        }
+
+        for (const BenchRecord& record : base) {
+            bool kept = false;
+            for (const BenchRecord& candidate : next) { kept = kept || (candidate.mode == record.mode && candidate.name == record.name); }
+            if (!kept) { std::printf("%-7s %-24s %12.1f %12s %9s\n", record.mode.c_str(), record.name.c_str(), record.ns_per_op, "-", "removed"); }
+        }
+
+        std::printf("%d regressions over %.1f%%\n", regressions, config.threshold);
+        return regressions == 0 ? 0 : 2;
+    }
+
+    // Compiles the SkillPrograms of the program case from --skills or BENCH_DEMO_SKILLS, reporting any error.
+    static bool load_skill_programs(const BenchConfig& config, SkillProgramLibrary& library) {
+        if (!config.skills) { return library.compile(BENCH_DEMO_SKILLS); }
+
+        std::FILE* file = std::fopen(config.skills, "rb");
+        if (!file) {
+            std::fprintf(stderr, "--skills: cannot open %s\n", config.skills);
+            return false;
+        }
+
+        const bool loaded = library.load(file);
+        std::fclose(file);
+
+        if (!loaded) { std::fprintf(stderr, "--skills: %s:%d: %s\n", config.skills, library.error_line, library.error); }
+        return loaded;
+    }
+
+    // Runs every mode, prints the results and checks the budgets.
+    static int run_benchmark(const BenchConfig& config) {
+        std::vector<BenchResult> results;
+
+        // Vector kernels must match the scalar path before anything is timed; this holds with or without budgets.
+        const int kernel_mismatches = run_combat_kernel_self_test(1, BENCH_KERNEL_ROUNDS);
+        std::printf("kernels %s, self-test %d mismatches\n", COMBAT_KERNEL_ISA, kernel_mismatches);
+        if (kernel_mismatches != 0) { return 2; }
+
+        // Passive registration must refuse bad indices and full tables; this also holds with or without budgets.
+        const int passive_failures = check_passive_registration<Config5v5>() + check_passive_registration<Config1v20>() + check_passive_registration<Config30v30>();
+        std::printf("passive registration check %d failures\n", passive_failures);
+        if (passive_failures != 0) { return 2; }
+
+        std::unique_ptr<SkillProgramLibrary> skill_programs(new SkillProgramLibrary());
+        if (!load_skill_programs(config, *skill_programs)) { return 1; }
+
+        run_mode<Config5v5>  ("5v5",   Config5v5::TEAM_SIZE,   config, results);
+        run_mode<Config1v20> ("1v20",  1,                      config, results);
+        run_mode<Config30v30>("30v30", Config30v30::TEAM_SIZE, config, results);
+
+        run_phases<Config5v5>  ("5v5",   Config5v5::TEAM_SIZE,   config, results);
+        run_phases<Config1v20> ("1v20",  1,                      config, results);
+        run_phases<Config30v30>("30v30", Config30v30::TEAM_SIZE, config, results);
+
+        // The same phases on integer ticks; get_next_character and turn_order_forecast are the cases the clock changes.
+        run_phases<Config5v5Fixed>  ("5v5fx",   Config5v5::TEAM_SIZE,   config, results);
+        run_phases<Config1v20Fixed> ("1v20fx",  1,                      config, results);
+        run_phases<Config30v30Fixed>("30v30fx", Config30v30::TEAM_SIZE, config, results);
+
+        run_effects<Config5v5>       ("5v5",     Config5v5::TEAM_SIZE,   config, results);
+        run_effects<Config1v20>      ("1v20",    1,                      config, results);
+        run_effects<Config30v30>     ("30v30",   Config30v30::TEAM_SIZE, config, results);
+        run_effects<Config30v30Fixed>("30v30fx", Config30v30::TEAM_SIZE, config, results);
+
+        compare_turn_orders<Config5v5,   Config5v5Fixed>  ("5v5",   Config5v5::TEAM_SIZE,   BENCH_ORDER_BATTLES);
+        compare_turn_orders<Config1v20,  Config1v20Fixed> ("1v20",  1,                      BENCH_ORDER_BATTLES);
+        compare_turn_orders<Config30v30, Config30v30Fixed>("30v30", Config30v30::TEAM_SIZE, BENCH_ORDER_BATTLES);
+
+        const uint64_t switch_digest  = run_battles<Config5v5>       ("5v5", "battle_switch",  Config5v5::TEAM_SIZE, config, results);
+        const uint64_t pointer_digest = run_battles<Config5v5Pointer>("5v5", "battle_pointer", Config5v5::TEAM_SIZE, config, results);
+        const uint64_t program_digest = run_battles<Config5v5Program>("5v5", "battle_program", Config5v5::TEAM_SIZE, config, results, skill_programs.get());
+        bench_sink = bench_sink + run_battles<Config1v20> ("1v20",  "battle", 1,                      config, results);
+        bench_sink = bench_sink + run_battles<Config30v30>("30v30", "battle", Config30v30::TEAM_SIZE, config, results);
+        bench_sink = bench_sink + run_battles<Config5v5Fixed>  ("5v5fx",   "battle", Config5v5::TEAM_SIZE,   config, results);
+        bench_sink = bench_sink + run_battles<Config1v20Fixed> ("1v20fx",  "battle", 1,                      config, results);
+        bench_sink = bench_sink + run_battles<Config30v30Fixed>("30v30fx", "battle", Config30v30::TEAM_SIZE, config, results);
+
+        run_resolve("attack_builder", "attack_program", SkillEnum::DEMO_ATTACK, config, *skill_programs, results);
+        run_resolve("cleave_builder", "cleave_program", SkillEnum::DEMO_CLEAVE, config, *skill_programs, results);
+
+        run_kernels<Config5v5::TEAM_SIZE>  ("5v5",   config, results);
+        run_kernels<Config30v30::TEAM_SIZE>("30v30", config, results);
+
+        for (const BenchResult& result : results) {
+            if (result.ns_per_op == BENCH_NO_TIME) { std::printf("%-7s %-24s %10s (setup alone took as long; noise)\n", result.mode, result.name, "-"); }
+            else                                   { std::printf("%-7s %-24s %10.1f ns/op\n", result.mode, result.name, result.ns_per_op); }
+        }
+
+        if (config.json && !write_json(config.json, config, results)) {
+            std::fprintf(stderr, "--json: cannot write %s\n", config.json);
+            return 1;
+        }
+
+        // Every dispatch mode must play the same battles; this holds with or without budgets.
+        if (switch_digest != pointer_digest) {
+            std::printf("mismatch: SkillDispatch::SWITCH and SkillDispatch::POINTER battles ended in different states\n");
+            return 2;
+        }
+
+        // A custom skill file may change the skills on purpose, so only the demo programs must match the builders.
+        if (switch_digest != program_digest && !config.skills) {
+            std::printf("mismatch: SkillDispatch::SWITCH and SkillDispatch::PROGRAM battles ended in different states\n");
+            return 2;
+        }
+
+        if (!config.budget) { return 0; }
+
+        using State5v5 = CombatEngine<Config5v5>::State;
+        bool within_budget = sizeof(State5v5) <= BENCH_STATE_BYTES;
+        if (!within_budget) { std::printf("over budget: 5v5 BattleState exceeds %zu bytes\n", BENCH_STATE_BYTES); }
+
+        if (sizeof(State5v5) - sizeof(State5v5::effects) > BENCH_STATE_CORE_BYTES) {
+            std::printf("over budget: 5v5 BattleState exceeds %zu bytes without its EffectTables\n", BENCH_STATE_CORE_BYTES);
+            within_budget = false;
+        }
+
+        if (sizeof(CharacterTable<Config5v5::TEAM_SIZE>) > BENCH_HOT_TABLE_BYTES) {
+            std::printf("over budget: 5v5 CharacterTable exceeds %zu bytes\n", BENCH_HOT_TABLE_BYTES);
+            within_budget = false;
+        }
+
+        for (const BenchResult& result : results) {
+            const bool copy_case = std::strcmp(result.name, "snapshot_state") == 0 || std::strcmp(result.name, "restore_state") == 0;
+
+            if (copy_case && std::strcmp(result.mode, "5v5") == 0 && result.ns_per_op > BENCH_COPY_NS) {
+                std::printf("over budget: 5v5 %s takes more than %.0f ns\n", result.name, BENCH_COPY_NS);
+                within_budget = false;
+            }
+        }
+
+        return within_budget ? 0 : 2;
+    }
+}
+
+int main(int argc, char** argv) {
+    pipelinepunch::BenchConfig config;
+
+    if (!pipelinepunch::parse_args(argc, argv, config)) {
+        std::fprintf(stderr, "usage: combat_benchmark [--iterations N] [--no-budget] [--skills FILE] [--json FILE]\n       combat_benchmark --compare BASE NEW [--threshold PCT]\n");
+        return 1;
+    }
+
+    return config.compare ? pipelinepunch::compare_results(config) : pipelinepunch::run_benchmark(config);
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+// CombatConfig
+// ------------
+// Compile-time shape of a battle: the number of slots per side and the capacity of every event queue.
+// - Character/passive tables, events, queues, the BattleContext, the CombatEngine and the event builders are
+//   all instantiated per config, so every mode keeps the SoA layout and fixed-size, allocation-free storage.
+// - Loops run to TEAM_SIZE, a compile-time constant, so the 5v5 instantiation keeps fully unrollable loops.
+// - Uneven modes (e.g. 1v20 raids) size both sides to the larger one; the smaller side's extra slots stay empty.
+// - CASCADE_DEPTH and TURN_EVENT_BUDGET bound reaction chains, so a turn has a known worst-case cost.
+// - DISPATCH picks how ActiveEventBuilders are called; every shipped mode uses the compile-time switch, and
+//   Config5v5Pointer keeps the function-pointer path and Config5v5Program runs data-driven SkillPrograms.
+// - ATB_CLOCK picks how the AtbScheduler keeps time; every shipped mode uses doubles, and the *Fixed modes keep
+//   integer ticks so turn orders do not depend on the platform's float arithmetic.
+// - EFFECTS_PER_UNIT sizes each side's EffectTable, and with it the BattleState. Snapshots copy only live effects,
+//   so the capacity costs memory rather than copy time.
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/enums/skill_dispatch.h"
+
+namespace pipelinepunch {
+
+    inline constexpr int DEFAULT_EFFECTS_PER_UNIT = 32; // Timed effects per slot each side can hold, unless a config says otherwise.
+
+    // Represents the compile-time shape of a battle.
+    template <int TEAM_SIZE_,
+              int FAST_EVENTS_PLUS_ = 4, int FAST_EVENTS_ = 16,
+              int MAIN_EVENTS_      = 4,
+              int SLOW_EVENTS_PLUS_ = 4, int SLOW_EVENTS_ = 16,
+              int CASCADE_DEPTH_    = 3, int TURN_EVENT_BUDGET_ = 32,
+              SkillDispatch DISPATCH_ = SkillDispatch::SWITCH,
+              AtbClock ATB_CLOCK_     = AtbClock::FLOAT,
+              int EFFECTS_PER_UNIT_   = DEFAULT_EFFECTS_PER_UNIT>
+    struct CombatConfig {
+        static constexpr int TEAM_SIZE         = TEAM_SIZE_;         // Slots per side.
+        static constexpr int FAST_EVENTS_PLUS  = FAST_EVENTS_PLUS_;  // Capacity of the fast_event_queue_plus.
+        static constexpr int FAST_EVENTS       = FAST_EVENTS_;       // Capacity of the fast_event_queue.
+        static constexpr int MAIN_EVENTS       = MAIN_EVENTS_;       // Capacity of the main_event_queue.
+        static constexpr int SLOW_EVENTS_PLUS  = SLOW_EVENTS_PLUS_;  // Capacity of the slow_event_queue_plus.
+        static constexpr int SLOW_EVENTS       = SLOW_EVENTS_;       // Capacity of the slow_event_queue.
+        static constexpr int CASCADE_DEPTH     = CASCADE_DEPTH_;     // Deepest reaction that may trigger further passives.
+        static constexpr int TURN_EVENT_BUDGET = TURN_EVENT_BUDGET_; // Reaction events resolved per turn, at most.
+        static constexpr int EFFECTS_PER_UNIT  = EFFECTS_PER_UNIT_;  // Timed effects per slot each side can hold; any one unit may hold more.
+        static constexpr int EFFECT_CAPACITY   = EFFECTS_PER_UNIT_ * TEAM_SIZE_; // Timed effects each side can hold.
+
+        static constexpr SkillDispatch DISPATCH  = DISPATCH_;        // How ActiveEventBuilders are called.
+        static constexpr AtbClock      ATB_CLOCK = ATB_CLOCK_;       // How the AtbScheduler keeps time.
+
+        static_assert(TEAM_SIZE > 0 && TEAM_SIZE <= 32, "Target bitmasks hold one bit per party position.");
+        static_assert(CASCADE_DEPTH >= 0 && CASCADE_DEPTH < 255, "Event depths are stored in a uint8_t.");
+        static_assert(EFFECT_CAPACITY > 0 && EFFECT_CAPACITY < 0xFFFF, "Effect links are stored as uint16_t.");
+    };
+
+    // --- Modes ---
+    using Config5v5   = CombatConfig<5>;                           // Standard 5v5 battles.
+    using Config1v20  = CombatConfig<20, 4, 32, 4, 4, 32, 3, 64>;  // Boss raids: one ally against up to 20 opponents.
+    using Config30v30 = CombatConfig<30, 4, 64, 4, 4, 64, 3, 128>; // Large skirmishes.
+
+    // --- Dispatch Modes ---
+    using Config5v5Pointer = CombatConfig<5, 4, 16, 4, 4, 16, 3, 32, SkillDispatch::POINTER>; // 5v5 through builder function pointers.
+    using Config5v5Program = CombatConfig<5, 4, 16, 4, 4, 16, 3, 32, SkillDispatch::PROGRAM>; // 5v5 running SkillPrograms where loaded.
+
+    // --- Fixed-Point ATB Modes ---
+    using Config5v5Fixed   = CombatConfig<5,  4, 16, 4, 4, 16, 3, 32,  SkillDispatch::SWITCH, AtbClock::FIXED>; // 5v5 on integer ticks.
+    using Config1v20Fixed  = CombatConfig<20, 4, 32, 4, 4, 32, 3, 64,  SkillDispatch::SWITCH, AtbClock::FIXED>; // Raids on integer ticks.
+    using Config30v30Fixed = CombatConfig<30, 4, 64, 4, 4, 64, 3, 128, SkillDispatch::SWITCH, AtbClock::FIXED>; // Skirmishes on integer ticks.
+}
\ No newline at end of file
@@ -0,0 +1,996 @@
+// CombatEngine
+// ------------
+// The CombatEngine owns the Godot-free core of a battle shaped by a CombatConfig (5v5, 1v20, 30v30).
+// - Holds the Struct-of-Arrays character tables, passive tables, battle context and intents.
+// - Runs the heap-based AtbScheduler, builds event queues and resolves events in tiered priority order.
+// - Reaction cascades are bounded by the CombatConfig's depth limit and per-turn event budget.
+// - Optionally records into a caller-owned CombatJournal and can seek to any journaled turn.
+// - In builds with PIPELINEPUNCH_TRACE, times its turn phases into a caller-owned CombatTrace.
+// - Everything a turn changes can be saved and restored as a trivially-copyable BattleState.
+// - Has no engine dependencies, so it can be driven by the CombatSystem node or by headless tools.
+// - Shares no mutable state with other engines; builders receive this battle's BattleContext.
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "combat_engine.h"
+
+#include "pipelinepunch/data/libraries/skill_library.h"
+#include "pipelinepunch/data/skills/active_event_builders.h"
+#include "pipelinepunch/data/skills/skill_program.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_stat.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_state.h"
+#include "pipelinepunch/systems/combat_system/enums/passive_tier.h"
+#include "pipelinepunch/systems/combat_system/enums/skill_dispatch.h"
+#include "pipelinepunch/systems/combat_system/kernels/combat_kernels.h"
+#include "pipelinepunch/systems/combat_system/structs/atb_scheduler.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_state.h"
+#include "pipelinepunch/systems/combat_system/structs/cascade_stats.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_journal.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_trace.h"
+#include "pipelinepunch/systems/combat_system/structs/event.h"
+#include "pipelinepunch/systems/combat_system/structs/event_queue.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
+#include "pipelinepunch/systems/combat_system/structs/stat_table.h"
+
+namespace pipelinepunch {
+
+	// --- Entry Points ---
+	// Registers both sides from per-position sheets (nullptr for an empty slot).
+	template <typename Config>
+	void CombatEngine<Config>::setup_from_sheets(const std::array<const CharacterSheet*, N>& ally_sheets, const std::array<const CharacterSheet*, N>& opponent_sheets) {
+		// Initialises a side's hot, cold and stat runtime tables from per-position CharacterSheets.
+		auto fill_side = [](CharacterTable<N> &ct, CharacterColdTable<N> &cold, StatTable<N> &st, const std::array<const CharacterSheet*, N>& sheets) {
+			for (int pos = 0; pos < N; pos++) {
+				const CharacterSheet *cs = sheets[pos];
+				if (!cs) {
+					// Empty slots hold no life, so the scheduler and state checks skip them.
+					ct.pos_to_index[pos]      = static_cast<int8_t>(pos);
+					ct.index_to_pos[pos]      = static_cast<int8_t>(pos);
+					ct.type[pos]              = TypeEnum{};
+					ct.life[pos]              = 0.f;
+					ct.life_bar[pos]          = 1.f;
+					ct.turn_bar[pos]          = 0.f;
+					ct.dmg_in[pos]            = 0.f;
+					ct.dmg_out[pos]           = 0.f;
+					ct.lp[pos]                = 0.f;
+					ct.effects[pos]           = 0;
+					cold.skills[pos]          = Skills{};
+					cold.character_sheet[pos] = CharacterSheet{};
+					st.set_base(pos, nullptr);
+					continue;
+				}
+
+				// Maps SoA index to party position.
+				ct.pos_to_index[pos] = static_cast<int8_t>(pos);
+				ct.index_to_pos[pos] = static_cast<int8_t>(pos);
+
+				// Snapshots base stats and the fields read during resolution into the hot table.
+				Stats  stats     = cs->stats;
+
+				ct.type[pos]     = cs->creature_sheet.type;
+				ct.life[pos]     = stats.lp;
+				ct.life_bar[pos] = 1.0f;
+				ct.turn_bar[pos] = 0.0f;
+				ct.dmg_in[pos]   = 1.0f;
+				ct.dmg_out[pos]  = 1.0f;
+				ct.lp[pos]       = stats.lp;
+				ct.atk[pos]      = stats.atk;
+				ct.def[pos]      = stats.def;
+				ct.mag[pos]      = stats.mag;
+				ct.crt[pos]      = stats.crt;
+				ct.spe[pos]      = stats.spe;
+				ct.effects[pos]  = 0; // Timed effects start with the battle; see add_effect().
+
+				// Base stats, from which the effective columns above are rebuilt when modifiers change.
+				st.set_base(pos, &stats);
+
+				// Cold data: skill slots and the full CharacterSheet, read by the UI and tools only.
+				cold.skills[pos]          = cs->skills;
+				cold.character_sheet[pos] = *cs;
+			}
+		};
+
+		// Resolves the builders of a side's skills for this CombatConfig from their SkillEnums.
+		// With SkillDispatch::PROGRAM, a slot also gets the SkillProgram of its SkillEnum if one is loaded. SkillEnum ids past
+		// the skill library have no builder, so a loaded program is the only thing that makes such a slot usable.
+		auto resolve_builders = [this](int team_index, const std::array<const CharacterSheet*, N>& sheets) {
+			for (int pos = 0; pos < N; pos++) {
+				const CharacterSheet *cs = sheets[pos];
+
+				for (int slot = 0; slot < SKILL_SLOTS; slot++) {
+					const bool has_skill  = cs && cs->skills.active_event_builder[slot];
+					const bool data_skill = cs && static_cast<int>(cs->skills.skill_enum[slot]) >= SKILL_LIBRARY_SIZE;
+					const bool programmed = Config::DISPATCH == SkillDispatch::PROGRAM && skill_programs && (has_skill || data_skill);
+
+					active_skill[team_index][pos][slot]          = has_skill ? cs->skills.skill_enum[slot] : NO_SKILL;
+					active_program[team_index][pos][slot]        = programmed ? skill_programs->find(cs->skills.skill_enum[slot]) : nullptr;
+					active_event_builder[team_index][pos][slot]  = has_skill ? get_active_event_builder<Config>(cs->skills.skill_enum[slot])  : nullptr;
+					passive_event_builder[team_index][pos][slot] = has_skill ? get_passive_event_builder<Config>(cs->skills.skill_enum[slot]) : nullptr;
+				}
+			}
+		};
+
+		fill_side(ally_character_table, ally_cold_table, ally_stat_table, ally_sheets);
+		fill_side(opponent_character_table, opponent_cold_table, opponent_stat_table, opponent_sheets);
+		resolve_builders(0, ally_sheets);
+		resolve_builders(1, opponent_sheets);
+
+		// Passives and standing stat modifiers are registered per battle through register_passive() and add_stat_modifier().
+		for (int team_index = 0; team_index < 2; team_index++) {
+			get_passive_table(team_index, PassiveTier::NEGATE).clear();
+			get_passive_table(team_index, PassiveTier::INTERCEPT).clear();
+			get_passive_table(team_index, PassiveTier::REACT).clear();
+			get_passive_table(team_index, PassiveTier::MODIFY).clear();
+		}
+		ally_stat_table.clear_modifiers();
+		opponent_stat_table.clear_modifiers();
+
+		combat_state      = CombatState::IDLE;
+		winner_team_index = -1;
+		turn_count        = 0;
+	}
+
+	// Initialises life and turn bars, then selects the first actor.
+	template <typename Config>
+	void CombatEngine<Config>::roll_initiative() {
+		for (int index = 0; index < N; index++) {
+			// Allies
+			ally_character_table.life_bar[index]     = 1.0f;
+			ally_character_table.turn_bar[index]     = 0.0f;
+
+			// Opponents
+			opponent_character_table.life_bar[index] = 1.0f;
+			opponent_character_table.turn_bar[index] = 0.0f;
+		}
+
+		winner_team_index    = -1;
+		turn_count           = 0;
+		turn_cascade_stats   = CascadeStats{};
+		battle_cascade_stats = CascadeStats{};
+		rng.seed(seed);
+
+		// Timed effects and stat modifier changes belong to one battle, so every unit starts from its base stats and
+		// standing modifiers, and is then scheduled at that speed. The scheduler's clock restarts at zero.
+		const float* const owner_life[2] = { ally_character_table.life, opponent_character_table.life };
+		for (int team_index = 0; team_index < 2; team_index++) {
+			CharacterTable<N>& ct      = (team_index == 0) ? ally_character_table : opponent_character_table;
+			Effects&           effects = (team_index == 0) ? ally_effect_table    : opponent_effect_table;
+			StatTable<N>&      stats   = (team_index == 0) ? ally_stat_table      : opponent_stat_table;
+
+			effects.clear(0);
+			for (int index = 0; index < N; index++) {
+				ct.effects[index]    = 0;
+				stats.version[index] = 0;
+				stats.rebuild(index, effects, stat_bindings, owner_life, ct);
+			}
+		}
+		scheduler.reset(ally_character_table, opponent_character_table);
+
+		PIPELINEPUNCH_TRACE_CALL(trace, begin(seed));
+
+		start_combat();
+		state_check();
+
+		if (combat_state == CombatState::RUNNING) { get_next_character(main_intent); }
+
+		if (journal) {
+			journal->begin(seed);
+			snapshot_state(journal->next_snapshot().state);
+		}
+	}
+
+	// Handles a single turn: resolve the chosen skill/target, then advance to the next actor.
+	// Returns false, changing nothing, if the slot or target is out of range or the slot is not usable (has_skill).
+	// An actor with no usable slot at all passes: its turn resolves no skill, but its turn bar is spent.
+	template <typename Config>
+	bool CombatEngine<Config>::turn(int skill_slot, int target_pos) {
+		if (combat_state != CombatState::RUNNING) { return false; }
+		if (skill_slot < 0 || skill_slot >= SKILL_SLOTS || target_pos < 0 || target_pos >= N) { return false; }
+
+		const bool passes = !has_skill(main_intent.owner_team_index, main_intent.owner_index, skill_slot);
+		if (passes && first_skill(main_intent.owner_team_index, main_intent.owner_index) >= 0) { return false; }
+
+		PIPELINEPUNCH_TRACE_SCOPE(turn_scope, trace, TracePhase::TURN, turn_count, 0);
+
+		main_intent.skill_slot = skill_slot;
+		main_intent.target_pos = target_pos;
+
+		if (journal) { journal->record_turn(static_cast<uint32_t>(turn_count), main_intent); }
+
+		if (passes) {
+			// A pass resolves nothing but still spends the actor's turn bar, so the clock moves on and cooldowns run out.
+			context.begin_turn();
+			CharacterTable<N>& owner_ct = (main_intent.owner_team_index == 0) ? ally_character_table : opponent_character_table;
+			owner_ct.turn_bar[main_intent.owner_index] = 0.0f;
+			scheduler.consume_turn(main_intent.owner_team_index, main_intent.owner_index);
+		} else {
+			build_main_event_queue(main_intent);
+		}
+		PIPELINEPUNCH_TRACE_CALL(trace, note_queue(TraceQueue::MAIN, context.main_event_queue.count));
+
+		turn_cascade_stats = CascadeStats{};
+		turn_cascade_stats.overflow_drops += context.main_event_queue.dropped;
+
+		for (int i = 0; i < context.main_event_queue.count; i++) {
+			resolve_events(context.get_event(context.main_event_queue, i));
+		}
+
+		battle_cascade_stats.accumulate(turn_cascade_stats);
+		PIPELINEPUNCH_TRACE_CALL(trace, end_turn());
+
+		turn_count++;
+		state_check();
+
+		// After resolving the turn (and any reactions), hands control to the next actor.
+		if (combat_state == CombatState::RUNNING) { get_next_character(main_intent); }
+
+		if (journal && turn_count % Journal::SNAPSHOT_INTERVAL == 0) { snapshot_state(journal->next_snapshot().state); }
+
+		return true;
+	}
+
+	// Sets the seed of the battle's random stream, applied by roll_initiative.
+	// The same seed and the same sequence of turn() intents always reproduce the same battle.
+	template <typename Config>
+	void CombatEngine<Config>::set_seed(uint64_t seed_value) { seed = seed_value; }
+
+	// Registers a passive of a living unit in its side's table for the given tier, updating the trigger index.
+	// caster_index and target_index are SoA indices to observe, or -1 for any. Returns false if the table is full
+	// (PassiveTable holds N passives per tier and side) or an index is out of range.
+	template <typename Config>
+	bool CombatEngine<Config>::register_passive(PassiveTier tier, const Intent& owner_intent, uint32_t effect_bitmask, int caster_index, int target_index, PassiveCondition<N> condition) {
+		if (owner_intent.owner_team_index != 0 && owner_intent.owner_team_index != 1) { return false; }
+
+		PassiveTable<N>& pt = get_passive_table(owner_intent.owner_team_index, tier);
+		return pt.add(owner_intent, effect_bitmask, caster_index, target_index, condition);
+	}
+
+	// Attaches a journal recorded from the next roll_initiative on (nullptr to stop recording).
+	// The journal is owned by the caller, so engines without one pay a single branch per record point.
+	template <typename Config>
+	void CombatEngine<Config>::set_journal(Journal* journal_value) { journal = journal_value; }
+
+	// Attaches a trace recorded from the next roll_initiative on (nullptr to stop recording).
+	// Builds without PIPELINEPUNCH_TRACE compile the trace points out, so the trace stays empty.
+	template <typename Config>
+	void CombatEngine<Config>::set_trace(CombatTrace* trace_value) { trace = trace_value; }
+
+	// Attaches a caller-owned SkillProgramLibrary, read by the next setup_from_sheets (nullptr to detach).
+	// Only engines whose CombatConfig selects SkillDispatch::PROGRAM run the programs.
+	template <typename Config>
+	void CombatEngine<Config>::set_skill_programs(const SkillProgramLibrary* library) { skill_programs = library; }
+
+	// Restores the battle at a journaled turn: restores the closest snapshot at or before it, then replays
+	// only the recorded intents and effect records after that snapshot. The engine must have been set up with the same parties.
+	// Recording is paused while replaying. Returns false if no held snapshot covers the turn or the replay diverges.
+	template <typename Config>
+	bool CombatEngine<Config>::seek(const Journal& source, int target_turn) {
+		const JournalSnapshot<N, Config::ATB_CLOCK, Config::EFFECT_CAPACITY>* snapshot = source.find_snapshot(target_turn);
+		if (!snapshot) { return false; }
+
+		Journal*          recording = journal;
+		CombatTrace*      tracing   = trace;
+		journal = nullptr;
+		trace   = nullptr;
+
+		seed = source.seed;
+		restore_state(snapshot->state);
+
+		bool in_sync = true;
+		for (uint64_t sequence = snapshot->sequence; in_sync && turn_count < target_turn && sequence < source.record_count; sequence++) {
+			const JournalRecord<N>& r = source.record(sequence);
+			if (r.type == JournalRecordType::SEED || r.type == JournalRecordType::EVENT) continue;
+
+			// Effects added between turns are applied where they were recorded; one the battle refuses means it diverged.
+			if (r.type != JournalRecordType::TURN) {
+				in_sync = apply_effect_record(r);
+				continue;
+			}
+
+			in_sync = combat_state == CombatState::RUNNING
+			       && r.owner_team_index == main_intent.owner_team_index
+			       && r.owner_index      == main_intent.owner_index;
+			if (in_sync) { turn(r.skill_slot, r.target_pos); }
+		}
+
+		journal = recording;
+		trace   = tracing;
+
+		return in_sync && turn_count == target_turn;
+	}
+
+	// Copies the mutable battle state into a BattleState, for lookahead, undo or journal snapshots.
+	// Stats, builders and passive registrations come from setup and are not part of it.
+	template <typename Config>
+	void CombatEngine<Config>::snapshot_state(State& state) const {
+		state.combat_state         = combat_state;
+		state.winner_team_index    = winner_team_index;
+		state.turn_count           = turn_count;
+		state.main_intent          = main_intent;
+		state.rng                  = rng;
+		state.scheduler            = scheduler;
+		state.battle_cascade_stats = battle_cascade_stats;
+
+		for (int team_index = 0; team_index < 2; team_index++) {
+			const CharacterTable<N>& ct = get_character_table(team_index);
+
+			std::memcpy(state.life[team_index],     ct.life,     sizeof(ct.life));
+			std::memcpy(state.life_bar[team_index], ct.life_bar, sizeof(ct.life_bar));
+			std::memcpy(state.turn_bar[team_index], ct.turn_bar, sizeof(ct.turn_bar));
+
+			state.passive_live[team_index][0] = get_passive_table(team_index, PassiveTier::NEGATE).trigger_index.live;
+			state.passive_live[team_index][1] = get_passive_table(team_index, PassiveTier::INTERCEPT).trigger_index.live;
+			state.passive_live[team_index][2] = get_passive_table(team_index, PassiveTier::REACT).trigger_index.live;
+			state.passive_live[team_index][3] = get_passive_table(team_index, PassiveTier::MODIFY).trigger_index.live;
+
+			const StatTable<N>& stats = (team_index == 0) ? ally_stat_table : opponent_stat_table;
+			std::memcpy(state.stat_version[team_index], stats.version, sizeof(stats.version));
+
+			const Effects& effects = (team_index == 0) ? ally_effect_table : opponent_effect_table;
+			effects.copy_to(state.effects[team_index]);
+		}
+	}
+
+	// Restores the mutable battle state from a BattleState taken from this engine or an engine set up with the same parties.
+	template <typename Config>
+	void CombatEngine<Config>::restore_state(const State& state) {
+		combat_state         = state.combat_state;
+		winner_team_index    = state.winner_team_index;
+		turn_count           = state.turn_count;
+		main_intent          = state.main_intent;
+		rng                  = state.rng;
+		scheduler            = state.scheduler;
+		battle_cascade_stats = state.battle_cascade_stats;
+		turn_cascade_stats   = CascadeStats{};
+
+		for (int team_index = 0; team_index < 2; team_index++) {
+			CharacterTable<N>& ct = (team_index == 0) ? ally_character_table : opponent_character_table;
+
+			std::memcpy(ct.life,     state.life[team_index],     sizeof(ct.life));
+			std::memcpy(ct.life_bar, state.life_bar[team_index], sizeof(ct.life_bar));
+			std::memcpy(ct.turn_bar, state.turn_bar[team_index], sizeof(ct.turn_bar));
+
+			get_passive_table(team_index, PassiveTier::NEGATE).trigger_index.live    = state.passive_live[team_index][0];
+			get_passive_table(team_index, PassiveTier::INTERCEPT).trigger_index.live = state.passive_live[team_index][1];
+			get_passive_table(team_index, PassiveTier::REACT).trigger_index.live     = state.passive_live[team_index][2];
+			get_passive_table(team_index, PassiveTier::MODIFY).trigger_index.live    = state.passive_live[team_index][3];
+
+			StatTable<N>& stats = (team_index == 0) ? ally_stat_table : opponent_stat_table;
+			std::memcpy(stats.version, state.stat_version[team_index], sizeof(stats.version));
+
+			Effects& effects = (team_index == 0) ? ally_effect_table : opponent_effect_table;
+			state.effects[team_index].copy_to(effects);
+			effects.sync_effects(ct);
+		}
+
+		// Rebuilds the effective stats of units whose modifiers changed in the restored battle or in the one it
+		// replaces, once both sides' lives are back. The scheduler was restored with the matching speeds. Battles
+		// without modifier changes, the common case, skip the loop on a single OR of every version and built byte.
+		uint8_t changed = 0;
+		for (int index = 0; index < N; index++) {
+			changed |= ally_stat_table.version[index] | ally_stat_table.built[index] | opponent_stat_table.version[index] | opponent_stat_table.built[index];
+		}
+		if (!changed) { return; }
+
+		const float* const owner_life[2] = { ally_character_table.life, opponent_character_table.life };
+		for (int team_index = 0; team_index < 2; team_index++) {
+			CharacterTable<N>& ct      = (team_index == 0) ? ally_character_table : opponent_character_table;
+			StatTable<N>&      stats   = (team_index == 0) ? ally_stat_table      : opponent_stat_table;
+			const Effects&     effects = (team_index == 0) ? ally_effect_table    : opponent_effect_table;
+
+			for (int index = 0; index < N; index++) {
+				if (stats.version[index] | stats.built[index]) { stats.rebuild(index, effects, stat_bindings, owner_life, ct); }
+			}
+		}
+	}
+
+	// Copies this battle, setup included, into another engine, which can then advance independently.
+	// The child records into no journal or trace. Later branches only need snapshot_state/restore_state.
+	template <typename Config>
+	void CombatEngine<Config>::fork(CombatEngine& child) const {
+		child         = *this;
+		child.journal = nullptr;
+		child.trace   = nullptr;
+	}
+
+	// Adds a timed effect to a living unit of a running battle, lasting a number of its turn bars at its current
+	// speed; later speed changes do not move the expiry. Effects added between turns are part of the BattleState, so
+	// snapshots and forks keep them, and the journal records them, so a seek or a replay applies them again.
+	// Returns false if the team or index is out of range, the unit is dead or its side's EffectTable is full.
+	template <typename Config>
+	bool CombatEngine<Config>::add_effect(int team_index, int index, uint32_t effect_bits, float magnitude, float bars) {
+		if (!is_unit(team_index, index) || !place_effect(team_index, index, effect_bits, magnitude, bars)) { return false; }
+
+		if (journal) { journal->record_effect(static_cast<uint32_t>(turn_count), team_index, index, effect_bits, magnitude, bars); }
+		return true;
+	}
+
+	// Removes a unit's timed effects that have any bit of a mask. Returns the number removed (0 if the team or index is
+	// out of range). A dispel that removed effects from a running battle is journaled.
+	template <typename Config>
+	int CombatEngine<Config>::dispel_effects(int team_index, int index, uint32_t mask) {
+		if (!is_unit(team_index, index)) { return 0; }
+
+		const int removed = remove_effects(team_index, index, mask);
+
+		if (removed && journal && combat_state == CombatState::RUNNING) { journal->record_dispel(static_cast<uint32_t>(turn_count), team_index, index, mask); }
+		return removed;
+	}
+
+	// Puts a unit's skill slot on cooldown for its next turns, replacing any cooldown the slot had.
+	// The effect runs until half a bar before the first free turn, so rounding never blocks that turn as well.
+	// A change to a running battle is journaled as one COOLDOWN record. Returns false if the team, index or skill slot
+	// is out of range, or the cooldown could not be added.
+	template <typename Config>
+	bool CombatEngine<Config>::start_cooldown(int team_index, int index, int skill_slot, int turns) {
+		if (!is_unit(team_index, index) || skill_slot < 0 || skill_slot >= SKILL_SLOTS) { return false; }
+
+		const int   removed = remove_effects(team_index, index, cooldown_bit(skill_slot));
+		const float bars    = (1.0f - scheduler.get_turn_bar(team_index, index)) + static_cast<float>(turns) - 0.5f;
+		const bool  placed  = turns > 0 && place_effect(team_index, index, cooldown_bit(skill_slot), 0.0f, bars);
+
+		if ((removed || placed) && journal && combat_state == CombatState::RUNNING) { journal->record_cooldown(static_cast<uint32_t>(turn_count), team_index, index, skill_slot, turns); }
+		return turns <= 0 || placed;
+	}
+
+	// Applies a journaled EFFECT, DISPEL or COOLDOWN record again, through the same entry point that wrote it, so an
+	// attached journal records it again. Returns false for any other record type, for a duration no honest journal
+	// holds (records may come from untrusted files), or if the engine refuses it (a DISPEL that removes nothing too).
+	template <typename Config>
+	bool CombatEngine<Config>::apply_effect_record(const JournalRecord<N>& record) {
+		if (!(std::fabs(record.effect_duration) <= JournalRecord<N>::MAX_DURATION)) { return false; }
+
+		switch (record.type) {
+			case JournalRecordType::EFFECT:   return add_effect(record.owner_team_index, record.owner_index, record.effect_bits, record.effect_magnitude, record.effect_duration);
+			case JournalRecordType::DISPEL:   return dispel_effects(record.owner_team_index, record.owner_index, record.effect_bits) > 0;
+			case JournalRecordType::COOLDOWN: return start_cooldown(record.owner_team_index, record.owner_index, record.skill_slot, static_cast<int>(record.effect_duration));
+			default:                          return false;
+		}
+	}
+
+	// Makes a timed effect bit raise a stat by the magnitude of each effect carrying it, as a fraction of the stat
+	// (0.2 for +20%, -0.2 for -20%), on both sides. Binding a bit again moves it to another stat. Bindings are rules
+	// of the game: they are kept by setup_from_sheets, and a BattleState is only valid under the bindings it was taken
+	// with. Returns false while a battle is running, or unless effect_bit is one bit outside the cooldown bits.
+	template <typename Config>
+	bool CombatEngine<Config>::bind_effect_stat(uint32_t effect_bit, CombatStat stat) {
+		if (combat_state == CombatState::RUNNING) { return false; }
+		if (effect_bit == 0 || (effect_bit & (effect_bit - 1)) || (effect_bit & COOLDOWN_BITS) || stat >= CombatStat::COUNT) { return false; }
+
+		stat_bindings.stat[PassiveTriggerIndex<N>::count_trailing_zeros(effect_bit)] = stat;
+		stat_bindings.bits |= effect_bit;
+		return true;
+	}
+
+	// Grants a unit a standing stat modifier from a living unit's passive (its own, or an aura over allies or foes):
+	// flat is added to the base and scale is added as a fraction on top, for as long as the owner lives. Like
+	// passives, modifiers are registered per battle and are not part of the BattleState. Returns false if the owner or
+	// target team or index or the stat is out of range, the owner is dead or the target side has no room left.
+	template <typename Config>
+	bool CombatEngine<Config>::add_stat_modifier(const Intent& owner_intent, int target_team_index, int target_index, CombatStat stat, float flat, float scale) {
+		if (!is_unit(owner_intent.owner_team_index, owner_intent.owner_index) || !is_unit(target_team_index, target_index)) { return false; }
+		if (stat >= CombatStat::COUNT) { return false; }
+		if (get_character_table(owner_intent.owner_team_index).life[owner_intent.owner_index] <= 0.0f) { return false; }
+
+		StatTable<N>& stats = (target_team_index == 0) ? ally_stat_table : opponent_stat_table;
+		if (!stats.add_modifier(owner_intent.owner_team_index, owner_intent.owner_index, target_index, stat, flat, scale)) { return false; }
+
+		refresh_stats(target_team_index, target_index);
+		return true;
+	}
+
+	// --- Queries ---
+	// Gets the current CombatState.
+	template <typename Config>
+	CombatState CombatEngine<Config>::get_combat_state() const { return combat_state; }
+
+	// Gets the winning team index, or -1 while running or on a draw.
+	template <typename Config>
+	int CombatEngine<Config>::get_winner_team_index() const { return winner_team_index; }
+
+	// Gets the number of turns resolved since roll_initiative.
+	template <typename Config>
+	int CombatEngine<Config>::get_turn_count() const { return turn_count; }
+
+	// Gets the intent of the current actor.
+	template <typename Config>
+	const Intent& CombatEngine<Config>::get_main_intent() const { return main_intent; }
+
+	// Gets a side's character table.
+	template <typename Config>
+	const CharacterTable<CombatEngine<Config>::N>& CombatEngine<Config>::get_character_table(int team_index) const {
+		return (team_index == 0) ? ally_character_table : opponent_character_table;
+	}
+
+	// Gets a side's cold table (skill slots and full CharacterSheets), for the UI and tools.
+	template <typename Config>
+	const CharacterColdTable<CombatEngine<Config>::N>& CombatEngine<Config>::get_cold_table(int team_index) const {
+		return (team_index == 0) ? ally_cold_table : opponent_cold_table;
+	}
+
+	// Checks whether a unit has a usable skill in a slot that is not on cooldown.
+	template <typename Config>
+	bool CombatEngine<Config>::has_skill(int team_index, int index, int skill_slot) const {
+		if (is_on_cooldown(team_index, index, skill_slot)) return false;
+		return active_event_builder[team_index][index][skill_slot] != nullptr || active_program[team_index][index][skill_slot] != nullptr;
+	}
+
+	// Gets a unit's first usable skill slot (has_skill), or -1 if it has none.
+	template <typename Config>
+	int CombatEngine<Config>::first_skill(int team_index, int index) const {
+		for (int skill_slot = 0; skill_slot < SKILL_SLOTS; skill_slot++) {
+			if (has_skill(team_index, index, skill_slot)) return skill_slot;
+		}
+		return -1;
+	}
+
+	// Checks whether a unit's skill slot is on cooldown.
+	template <typename Config>
+	bool CombatEngine<Config>::is_on_cooldown(int team_index, int index, int skill_slot) const {
+		return (get_character_table(team_index).effects[index] & cooldown_bit(skill_slot)) != 0;
+	}
+
+	// Gets the number of changes to a unit's stat modifiers since roll_initiative, wrapping from 255 to 1, so a stat
+	// display can redraw only when it moves. Restoring a BattleState restores the count.
+	template <typename Config>
+	uint32_t CombatEngine<Config>::get_stat_version(int team_index, int index) const {
+		return (team_index == 0) ? ally_stat_table.version[index] : opponent_stat_table.version[index];
+	}
+
+	// Gets a side's timed effects.
+	template <typename Config>
+	const typename CombatEngine<Config>::Effects& CombatEngine<Config>::get_effect_table(int team_index) const {
+		return (team_index == 0) ? ally_effect_table : opponent_effect_table;
+	}
+
+	// Checks whether the unit at a party position can still act.
+	template <typename Config>
+	bool CombatEngine<Config>::is_alive(int team_index, int pos) const {
+		const CharacterTable<N>& ct = get_character_table(team_index);
+		return ct.life[ct.pos_to_index[pos]] > 0.0f;
+	}
+
+	// Gets the seed of the battle's random stream.
+	template <typename Config>
+	uint64_t CombatEngine<Config>::get_seed() const { return seed; }
+
+	// Gets the reaction cascade counters of the last turn.
+	template <typename Config>
+	const CascadeStats& CombatEngine<Config>::get_turn_cascade_stats() const { return turn_cascade_stats; }
+
+	// Gets the reaction cascade counters accumulated since roll_initiative.
+	template <typename Config>
+	const CascadeStats& CombatEngine<Config>::get_battle_cascade_stats() const { return battle_cascade_stats; }
+
+	// Previews up to max_count actors after the current one, without touching the battle or its random stream.
+	// Returns the number of actors written to out.
+	template <typename Config>
+	int CombatEngine<Config>::get_turn_order_forecast(Intent* out, int max_count) const {
+		if (combat_state != CombatState::RUNNING) { return 0; }
+		return scheduler.forecast(out, max_count, main_intent, rng, ally_character_table, opponent_character_table);
+	}
+
+	// Gets a platform-independent hash of the live battle state, for replay verification.
+	// Floats are hashed by bit pattern, so any divergence between two runs changes the hash.
+	template <typename Config>
+	uint64_t CombatEngine<Config>::get_state_hash() const {
+		uint64_t hash = 0xCBF29CE484222325ull;
+
+		// Folds a 32-bit word into the FNV-1a hash.
+		auto mix = [&hash](uint32_t word) {
+			for (int byte = 0; byte < 4; byte++) {
+				hash ^= (word >> (byte * 8)) & 0xFFu;
+				hash *= 0x100000001B3ull;
+			}
+		};
+
+		// Folds a float into the hash by bit pattern.
+		auto mix_float = [&mix](float value) {
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			mix(bits);
+		};
+
+		for (int team_index = 0; team_index < 2; team_index++) {
+			const CharacterTable<N>& ct = get_character_table(team_index);
+			for (int index = 0; index < N; index++) {
+				mix_float(ct.life[index]);
+				mix_float(ct.turn_bar[index]);
+
+				// Effect masks only count while set, so battles without timed effects keep their hashes.
+				if (ct.effects[index]) {
+					mix(static_cast<uint32_t>(index));
+					mix(ct.effects[index]);
+				}
+			}
+		}
+
+		mix(static_cast<uint32_t>(turn_count));
+		mix(static_cast<uint32_t>(main_intent.owner_team_index));
+		mix(static_cast<uint32_t>(main_intent.owner_index));
+		mix(static_cast<uint32_t>(rng.state));
+		mix(static_cast<uint32_t>(rng.state >> 32));
+
+		return hash;
+	}
+
+	// --- Internal logic ---
+	// Sets CombatState to RUNNING
+	template <typename Config>
+	void CombatEngine<Config>::start_combat() { combat_state = CombatState::RUNNING; }
+
+	// Sets CombatState to ENDED
+	template <typename Config>
+	void CombatEngine<Config>::stop_combat() { combat_state = CombatState::ENDED; }
+
+	// Gets a side's passive table for a tier.
+	template <typename Config>
+	PassiveTable<CombatEngine<Config>::N>& CombatEngine<Config>::get_passive_table(int team_index, PassiveTier tier) {
+		return const_cast<PassiveTable<N>&>(static_cast<const CombatEngine&>(*this).get_passive_table(team_index, tier));
+	}
+
+	// Gets a side's passive table for a tier.
+	template <typename Config>
+	const PassiveTable<CombatEngine<Config>::N>& CombatEngine<Config>::get_passive_table(int team_index, PassiveTier tier) const {
+		switch (tier) {
+			case PassiveTier::NEGATE:    return (team_index == 0) ? ally_negate_table    : opponent_negate_table;
+			case PassiveTier::INTERCEPT: return (team_index == 0) ? ally_intercept_table : opponent_intercept_table;
+			case PassiveTier::REACT:     return (team_index == 0) ? ally_react_table     : opponent_react_table;
+			default:                     return (team_index == 0) ? ally_modify_table    : opponent_modify_table;
+		}
+	}
+
+	// Drops a dead unit's passives from every tier's trigger index, its timed effects and the standing stat modifiers
+	// it granted, rebuilding the stats of their targets.
+	template <typename Config>
+	void CombatEngine<Config>::on_unit_died(int team_index, int index) {
+		get_passive_table(team_index, PassiveTier::NEGATE).on_owner_died(index);
+		get_passive_table(team_index, PassiveTier::INTERCEPT).on_owner_died(index);
+		get_passive_table(team_index, PassiveTier::REACT).on_owner_died(index);
+		get_passive_table(team_index, PassiveTier::MODIFY).on_owner_died(index);
+		remove_effects(team_index, index, ~0u);
+
+		for (uint32_t targets = ally_stat_table.owner_targets[team_index][index]; targets; targets &= targets - 1) {
+			refresh_stats(0, PassiveTriggerIndex<N>::count_trailing_zeros(targets));
+		}
+		for (uint32_t targets = opponent_stat_table.owner_targets[team_index][index]; targets; targets &= targets - 1) {
+			refresh_stats(1, PassiveTriggerIndex<N>::count_trailing_zeros(targets));
+		}
+	}
+
+	// Rebuilds a unit's effective stats after a change to its modifiers, counting the change in its version.
+	// In a running battle, a new speed moves the unit's ready time and keeps its turn bar's progress.
+	template <typename Config>
+	void CombatEngine<Config>::refresh_stats(int team_index, int index) {
+		CharacterTable<N>& ct      = (team_index == 0) ? ally_character_table : opponent_character_table;
+		StatTable<N>&      stats   = (team_index == 0) ? ally_stat_table      : opponent_stat_table;
+		const Effects&     effects = (team_index == 0) ? ally_effect_table    : opponent_effect_table;
+
+		const float* const owner_life[2] = { ally_character_table.life, opponent_character_table.life };
+		const float        previous_spe  = ct.spe[index];
+
+		stats.bump_version(index);
+		stats.rebuild(index, effects, stat_bindings, owner_life, ct);
+
+		if (combat_state == CombatState::RUNNING && ct.spe[index] != previous_spe) { scheduler.set_speed(team_index, index, ct.spe[index]); }
+	}
+
+	// Checks whether a team and SoA index name a slot of this config, for entry points taking them from callers.
+	template <typename Config>
+	bool CombatEngine<Config>::is_unit(int team_index, int index) { return (team_index == 0 || team_index == 1) && index >= 0 && index < N; }
+
+	// Adds a timed effect to a living unit of a running battle without journaling it. Returns false if the unit is
+	// dead or its side's EffectTable is full.
+	template <typename Config>
+	bool CombatEngine<Config>::place_effect(int team_index, int index, uint32_t effect_bits, float magnitude, float bars) {
+		CharacterTable<N>& ct = (team_index == 0) ? ally_character_table : opponent_character_table;
+		if (combat_state != CombatState::RUNNING || ct.life[index] <= 0.0f) { return false; }
+
+		const typename Effects::Time expire_time = scheduler.clock + scheduler.get_bar_time(team_index, index, bars);
+		Effects& effects = (team_index == 0) ? ally_effect_table : opponent_effect_table;
+		if (!effects.add(index, effect_bits, magnitude, expire_time, ct)) { return false; }
+
+		if (effect_bits & stat_bindings.bits) { refresh_stats(team_index, index); }
+		return true;
+	}
+
+	// Removes a unit's timed effects that have any bit of a mask without journaling them, returning the number removed.
+	// A unit holding any stat-bound effect has its stats rebuilt, as a removed effect may carry a bound bit outside the mask.
+	template <typename Config>
+	int CombatEngine<Config>::remove_effects(int team_index, int index, uint32_t mask) {
+		CharacterTable<N>& ct      = (team_index == 0) ? ally_character_table : opponent_character_table;
+		Effects&           effects = (team_index == 0) ? ally_effect_table    : opponent_effect_table;
+
+		const bool had_stat_effects = (ct.effects[index] & stat_bindings.bits) != 0;
+		const int  removed          = effects.dispel(index, mask, ct);
+
+		if (removed && had_stat_effects) { refresh_stats(team_index, index); }
+		return removed;
+	}
+
+	// Ends combat once a side has no living units.
+	template <typename Config>
+	void CombatEngine<Config>::state_check() {
+		auto has_living = [](const CharacterTable<N>& character_table) {
+			for (int index = 0; index < N; index++) {
+				if (character_table.life[index] > 0.0f) return true;
+			}
+			return false;
+		};
+
+		const bool allies_alive    = has_living(ally_character_table);
+		const bool opponents_alive = has_living(opponent_character_table);
+
+		if (allies_alive && opponents_alive) { return; }
+
+		winner_team_index = allies_alive ? 0 : (opponents_alive ? 1 : -1);
+		stop_combat();
+	}
+
+	// Gets the next character.
+	// - Picks the fastest actor among all full bars, advancing the scheduler's clock only if no living unit has one.
+	// - Ties are broken by the battle's random stream between actors with equal speed.
+	// - Expires the timed effects that ran out by the new clock time, before the actor's turn, and rebuilds the stats
+	//   of units that lost a stat-bound effect.
+	// - Writes the derived turn bars back into both character tables for the GUI and the state hash.
+	template <typename Config>
+	Intent CombatEngine<Config>::get_next_character(Intent& intent) {
+		PIPELINEPUNCH_TRACE_SCOPE(advance_scope, trace, TracePhase::SCHEDULER_ADVANCE, turn_count, 0);
+
+		intent = scheduler.next(rng, ally_character_table, opponent_character_table);
+		const uint32_t ally_changed     = ally_effect_table.advance(scheduler.clock, stat_bindings.bits, ally_character_table);
+		const uint32_t opponent_changed = opponent_effect_table.advance(scheduler.clock, stat_bindings.bits, opponent_character_table);
+		for (uint32_t bits = ally_changed; bits; bits &= bits - 1)     { refresh_stats(0, PassiveTriggerIndex<N>::count_trailing_zeros(bits)); }
+		for (uint32_t bits = opponent_changed; bits; bits &= bits - 1) { refresh_stats(1, PassiveTriggerIndex<N>::count_trailing_zeros(bits)); }
+		scheduler.sync_turn_bars(ally_character_table, opponent_character_table);
+
+		return intent;
+	}
+
+	// Builds the main_event_queue from the active actor's chosen intent.
+	template <typename Config>
+	void CombatEngine<Config>::build_main_event_queue(const Intent& intent) {
+		PIPELINEPUNCH_TRACE_SCOPE(build_scope, trace, TracePhase::BUILD_INTENT, turn_count, 0);
+
+		context.begin_turn();
+
+		CharacterTable<N>& owner_ct = (intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
+		CharacterTable<N>& other_ct = (intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
+
+		run_active_event_builder<SkillPhase::CREATE>(intent, owner_ct, other_ct, nullptr);
+	}
+
+	// Gets relevant passives that trigger from an event, queueing their reactions one cascade level deeper.
+	// Each tier's PassiveTriggerIndex narrows the table to passives observing the event's effects and caster/target,
+	// so only those pay for their condition call; cost grows with matching passives, not registered ones.
+	template <typename Config>
+	void CombatEngine<Config>::get_passives(Event<N>& e) {
+		PIPELINEPUNCH_TRACE_SCOPE(lookup_scope, trace, TracePhase::PASSIVE_LOOKUP, turn_count, e.depth);
+		PIPELINEPUNCH_TRACE_CALL(trace, counters.passive_lookups++);
+
+		int          owner_team_index = e.intent.owner_team_index;
+		const Intent event_intent     = e.intent.unpack();
+
+		const CharacterTable<N>& owner_ct = (owner_team_index == 0) ? ally_character_table     : opponent_character_table;
+		const CharacterTable<N>& other_ct = (owner_team_index == 0) ? opponent_character_table : ally_character_table;
+		const PassiveTable<N>&   other_nt = (owner_team_index == 0) ? opponent_negate_table    : ally_negate_table;
+		const PassiveTable<N>&   other_it = (owner_team_index == 0) ? opponent_intercept_table : ally_intercept_table;
+		const PassiveTable<N>&   other_rt = (owner_team_index == 0) ? opponent_react_table     : ally_react_table;
+
+		const int caster_index = e.intent.owner_index;
+		const int target_index = (e.intent.target_pos >= 0 && e.intent.target_pos < N) ? other_ct.pos_to_index[e.intent.target_pos] : -1;
+
+		// Gets the indexed candidates of a table that also pass their extra condition.
+		auto matching = [&](const PassiveTable<N>& pt)->uint32_t {
+			uint32_t candidates = pt.trigger_index.match(e.effect_bitmask, caster_index, target_index);
+			PIPELINEPUNCH_TRACE_CALL(trace, counters.passives_scanned += CombatTrace::count_bits(pt.trigger_index.live));
+			PIPELINEPUNCH_TRACE_CALL(trace, counters.condition_calls  += CombatTrace::count_bits(candidates));
+
+			for (uint32_t bits = candidates; bits; bits &= bits - 1) {
+				const int i = PassiveTriggerIndex<N>::count_trailing_zeros(bits);
+				if (!pt.condition[i](owner_ct, other_ct, event_intent)) { candidates &= ~(1u << i); }
+			}
+
+			return candidates;
+		};
+
+		// Picks the fastest matching passive of a table. Ties resolve to the first registered passive.
+		auto pick_fastest = [&](const PassiveTable<N>& pt, Intent& candidate)->bool {
+			const uint32_t candidates    = matching(pt);
+			float          highest_speed = -1.0f;
+
+			for (uint32_t bits = candidates; bits; bits &= bits - 1) {
+				const int   i   = PassiveTriggerIndex<N>::count_trailing_zeros(bits);
+				const float spe = other_ct.spe[pt.intent[i].owner_index];
+
+				if (spe > highest_speed) {
+					highest_speed = spe;
+					candidate     = pt.intent[i];
+				}
+			}
+
+			return candidates != 0;
+		};
+
+		// Builds a passive response for the given intent and stamps the depth of the events it queued.
+		auto build_passive = [&](Intent intent) {
+			CharacterTable<N>& owner_character_table = (intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
+			CharacterTable<N>& other_character_table = (intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
+
+			auto builder = passive_event_builder[intent.owner_team_index][intent.owner_index][intent.skill_slot];
+			if (!builder) { return; }
+
+			// Whatever the builder queued sits in the arena after this mark, in whichever tier it went to.
+			const int first = context.arena.mark();
+
+			builder(context, owner_character_table, other_character_table, intent);
+
+			const uint8_t depth = static_cast<uint8_t>(e.depth + 1);
+			for (int i = first; i < context.arena.mark(); i++) { context.arena.event[i].depth = depth; }
+		};
+
+		// Check passives.
+		Intent candidate;
+
+		// The fastest negate passive, if any, marks the event as negated.
+		if (other_nt.count > 0 && pick_fastest(other_nt, candidate)) { e.is_negated = true; }
+
+		// The fastest intercept passive may modify or insert events.
+		if (other_it.count > 0 && pick_fastest(other_it, candidate)) { build_passive(candidate); }
+
+		// Every matching react passive responds to the event.
+		if (other_rt.count > 0) {
+			for (uint32_t bits = matching(other_rt); bits; bits &= bits - 1) {
+				build_passive(other_rt.intent[PassiveTriggerIndex<N>::count_trailing_zeros(bits)]);
+			}
+		}
+	}
+
+	// Resolves a main event and its reaction cascade in tiered priority order.
+	// - The next event always comes from the highest tier with unresolved events: fast_event_queue_plus,
+	//   fast_event_queue, the main event itself, slow_event_queue_plus, then slow_event_queue.
+	// - Passives are checked before an event resolves, so they can negate it; their reactions are appended to
+	//   the queues of this cascade and picked up by the same loop, without recursion or allocation.
+	// - Reactions at Config::CASCADE_DEPTH resolve without looking for further passives.
+	// - Once Config::TURN_EVENT_BUDGET reactions have resolved this turn, the rest are dropped; main events
+	//   always resolve, so a turn costs at most MAIN_EVENTS + TURN_EVENT_BUDGET events.
+	template <typename Config>
+	void CombatEngine<Config>::resolve_events(Event<N>& main_event) {
+		// Clear per-main-event reaction queues, freeing the previous cascade's events.
+		context.begin_cascade();
+
+		get_passives(main_event);
+
+		int  fast_plus_cursor = 0;
+		int  fast_cursor      = 0;
+		int  slow_plus_cursor = 0;
+		int  slow_cursor      = 0;
+		bool main_resolved    = false;
+
+		while (true) {
+			Event<N>*                   e = nullptr;
+			[[maybe_unused]] TracePhase tier;
+
+			if      (fast_plus_cursor < context.fast_event_queue_plus.count) { e = &context.get_event(context.fast_event_queue_plus, fast_plus_cursor++); tier = TracePhase::RESOLVE_FAST_PLUS; }
+			else if (fast_cursor      < context.fast_event_queue.count)      { e = &context.get_event(context.fast_event_queue, fast_cursor++);           tier = TracePhase::RESOLVE_FAST; }
+			else if (!main_resolved) {
+				PIPELINEPUNCH_TRACE_SCOPE(main_scope, trace, TracePhase::RESOLVE_MAIN, turn_count, 0);
+				PIPELINEPUNCH_TRACE_CALL(trace, count_event());
+
+				resolve_event(main_event);
+				main_resolved = true;
+
+				// Consume the active unit's turn bar.
+				CharacterTable<N>& owner_ct = (main_event.intent.owner_team_index == 0) ? ally_character_table : opponent_character_table;
+				owner_ct.turn_bar[main_intent.owner_index] = 0.0f;
+				scheduler.consume_turn(main_event.intent.owner_team_index, main_intent.owner_index);
+				continue;
+			}
+			else if (slow_plus_cursor < context.slow_event_queue_plus.count) { e = &context.get_event(context.slow_event_queue_plus, slow_plus_cursor++); tier = TracePhase::RESOLVE_SLOW_PLUS; }
+			else if (slow_cursor      < context.slow_event_queue.count)      { e = &context.get_event(context.slow_event_queue, slow_cursor++);           tier = TracePhase::RESOLVE_SLOW; }
+			else break;
+
+			if (turn_cascade_stats.reactions_resolved >= static_cast<uint32_t>(Config::TURN_EVENT_BUDGET)) {
+				turn_cascade_stats.budget_drops++;
+				continue;
+			}
+
+			PIPELINEPUNCH_TRACE_SCOPE(reaction_scope, trace, tier, turn_count, e->depth);
+			PIPELINEPUNCH_TRACE_CALL(trace, count_event());
+
+			turn_cascade_stats.reactions_resolved++;
+			if (e->depth > turn_cascade_stats.max_depth) { turn_cascade_stats.max_depth = e->depth; }
+
+			if (e->depth < Config::CASCADE_DEPTH) { get_passives(*e); }
+			else                                  { turn_cascade_stats.depth_cutoffs++; }
+
+			resolve_event(*e);
+		}
+
+		turn_cascade_stats.overflow_drops += context.fast_event_queue_plus.dropped + context.fast_event_queue.dropped
+		                                   + context.slow_event_queue_plus.dropped + context.slow_event_queue.dropped;
+
+		PIPELINEPUNCH_TRACE_CALL(trace, note_queue(TraceQueue::FAST_PLUS, context.fast_event_queue_plus.count));
+		PIPELINEPUNCH_TRACE_CALL(trace, note_queue(TraceQueue::FAST,      context.fast_event_queue.count));
+		PIPELINEPUNCH_TRACE_CALL(trace, note_queue(TraceQueue::SLOW_PLUS, context.slow_event_queue_plus.count));
+		PIPELINEPUNCH_TRACE_CALL(trace, note_queue(TraceQueue::SLOW,      context.slow_event_queue.count));
+	}
+
+	// Runs one phase of the intent's ActiveEventBuilder, reached as the CombatConfig's SkillDispatch selects.
+	template <typename Config>
+	template <SkillPhase PHASE>
+	void CombatEngine<Config>::run_active_event_builder(const Intent& intent, const CharacterTable<N>& owner_ct, const CharacterTable<N>& other_ct, Event<N>* e) {
+		if constexpr (Config::DISPATCH == SkillDispatch::POINTER) {
+			auto builder = active_event_builder[intent.owner_team_index][intent.owner_index][intent.skill_slot];
+			if (builder) { builder(context, owner_ct, other_ct, intent, e); }
+		} else {
+			if constexpr (Config::DISPATCH == SkillDispatch::PROGRAM) {
+				const SkillProgram* program = active_program[intent.owner_team_index][intent.owner_index][intent.skill_slot];
+				if (program) {
+					run_skill_program<Config, PHASE>(*program, context, owner_ct, other_ct, intent, e);
+					return;
+				}
+			}
+
+			const SkillEnum skill_enum = active_skill[intent.owner_team_index][intent.owner_index][intent.skill_slot];
+			dispatch_active_event_builder<Config, PHASE>(skill_enum, context, owner_ct, other_ct, intent, e);
+		}
+	}
+
+	// Resolves an event.
+	template <typename Config>
+	void CombatEngine<Config>::resolve_event(Event<N>& e) {
+		if (e.is_negated) { return; }
+
+		CharacterTable<N>& owner_ct = (e.intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
+		CharacterTable<N>& other_ct = (e.intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
+
+		// Main events get their values from phase 2 of their ActiveEventBuilder, in the slot phase 1 filled;
+		// reactions arrive filled by their PassiveEventBuilder.
+		if (e.depth == 0) { run_active_event_builder<SkillPhase::RESOLVE>(e.intent.unpack(), owner_ct, other_ct, &e); }
+
+		// ROADMAP: MODIFY-tier passives adjusting the event's values (get_modifiers) run here, before the multipliers.
+
+		// Scales the event's damage by its owner's outgoing and each receiver's incoming damage multiplier. Both are
+		// effective stats, so modifiers cost one load per unit here and are never recomputed per event.
+		const float dmg_out = owner_ct.dmg_out[e.intent.owner_index];
+		for (int pos = 0; pos < N; pos++) {
+			e.other_pos_damage[pos] *= dmg_out * other_ct.dmg_in[other_ct.pos_to_index[pos]];
+			e.owner_pos_damage[pos] *= dmg_out * owner_ct.dmg_in[owner_ct.pos_to_index[pos]];
+		}
+
+		if (journal) { journal->record_event(static_cast<uint32_t>(turn_count), e.intent.unpack(), e.depth, e.owner_pos_damage, e.other_pos_damage); }
+
+		// Applies damage from the resolved Event into both character tables.
+		// Damage is moved from party positions to SoA order, so apply_damage runs over the tables' columns directly.
+		// Life values are clamped between 0 and max LP, and life_bar values between 0 and 1.
+		float other_damage[N];
+		float owner_damage[N];
+		for (int pos = 0; pos < N; pos++) {
+			other_damage[other_ct.pos_to_index[pos]] = e.other_pos_damage[pos];
+			owner_damage[owner_ct.pos_to_index[pos]] = e.owner_pos_damage[pos];
+		}
+
+		const uint32_t other_died = apply_damage(other_ct.life, other_ct.life_bar, other_ct.lp, other_damage, N);
+		const uint32_t owner_died = apply_damage(owner_ct.life, owner_ct.life_bar, owner_ct.lp, owner_damage, N);
+
+		for (uint32_t bits = other_died; bits; bits &= bits - 1) { on_unit_died(1 - e.intent.owner_team_index, PassiveTriggerIndex<N>::count_trailing_zeros(bits)); }
+		for (uint32_t bits = owner_died; bits; bits &= bits - 1) { on_unit_died(e.intent.owner_team_index,     PassiveTriggerIndex<N>::count_trailing_zeros(bits)); }
+	}
+
+	// --- Instantiations ---
+	template class CombatEngine<Config5v5>;
+	template class CombatEngine<Config5v5Pointer>;
+	template class CombatEngine<Config5v5Program>;
+	template class CombatEngine<Config1v20>;
+	template class CombatEngine<Config30v30>;
+	template class CombatEngine<Config5v5Fixed>;
+	template class CombatEngine<Config1v20Fixed>;
+	template class CombatEngine<Config30v30Fixed>;
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+
+// CombatEngine
+// ------------
+// The CombatEngine owns the Godot-free core of a battle shaped by a CombatConfig (5v5, 1v20, 30v30).
+// - Holds the Struct-of-Arrays character tables, passive tables, battle context and intents.
+// - Runs the heap-based AtbScheduler, builds event queues and resolves events in tiered priority order.
+// - Reaction cascades are bounded by the CombatConfig's depth limit and per-turn event budget.
+// - Optionally records into a caller-owned CombatJournal and can seek to any journaled turn.
+// - In builds with PIPELINEPUNCH_TRACE, times its turn phases into a caller-owned CombatTrace.
+// - Keeps each side's timed effects (buffs, debuffs, cooldowns) in an EffectTable, expired on the scheduler's clock
+//   as each actor is picked; a skill slot on cooldown is not usable.
+// - Keeps the character tables' stat columns at their effective values: a StatTable per side rebuilds a unit only
+//   when a bound effect, a standing modifier or its owner's death changes it, never per event.
+// - Everything a turn changes can be saved and restored as a trivially-copyable BattleState.
+// - Has no engine dependencies, so it can be driven by the CombatSystem node or by headless tools.
+// - Shares no mutable state with other engines; builders receive this battle's BattleContext.
+// - ActiveEventBuilders are reached through a compile-time switch over SkillEnum, or through per-slot function
+//   pointers when the CombatConfig selects SkillDispatch::POINTER (kept for benchmarks). SkillDispatch::PROGRAM runs
+//   data-driven SkillPrograms from a caller-owned SkillProgramLibrary where it has one.
+// - Each mode is a separate instantiation with fixed-size tables and queues; loops run to the
+//   compile-time TEAM_SIZE, so the 5v5 engine keeps fully unrollable loops.
+
+#include <array>
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/enums/combat_state.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_stat.h"
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/data/skills/skill_program.h"
+#include "pipelinepunch/systems/combat_system/enums/passive_tier.h"
+#include "pipelinepunch/systems/combat_system/enums/skill_dispatch.h"
+#include "pipelinepunch/systems/combat_system/structs/atb_scheduler.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_state.h"
+#include "pipelinepunch/systems/combat_system/structs/cascade_stats.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_journal.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_trace.h"
+#include "pipelinepunch/systems/combat_system/structs/effect_table.h"
+#include "pipelinepunch/systems/combat_system/structs/event.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
+#include "pipelinepunch/systems/combat_system/structs/stat_table.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    template <typename Config>
+    struct CombatEngineProbe; // Defined by the benchmarks, to time the private turn phases one at a time.
+
+    // Represents the combat engine for a single battle.
+    template <typename Config>
+    class CombatEngine {
+        friend struct CombatEngineProbe<Config>;
+
+    public:
+        static constexpr int N = Config::TEAM_SIZE; // Slots per side.
+
+        using State   = BattleState<N, Config::ATB_CLOCK, Config::EFFECT_CAPACITY>;   // Mutable battle state of this config.
+        using Journal = CombatJournal<N, Config::ATB_CLOCK, Config::EFFECT_CAPACITY>; // Journal this config records into.
+        using Effects = EffectTable<N, Config::ATB_CLOCK, Config::EFFECT_CAPACITY>;   // Timed effects of one side.
+
+        // --- Entry Points ---
+        void setup_from_sheets(const std::array<const CharacterSheet*, N>& ally_sheets,      // Registers both sides from per-position sheets (nullptr for an empty slot).
+                               const std::array<const CharacterSheet*, N>& opponent_sheets);
+        void roll_initiative();                                                              // Initialises life and turn bars, then selects the first actor.
+        bool turn(int skill_slot, int target_pos);                                           // Handles a single turn: resolve the chosen skill/target, then advance to the next actor (false for an illegal move).
+        void set_seed(uint64_t seed);                                                        // Sets the seed of the battle's random stream, applied by roll_initiative.
+        bool register_passive(PassiveTier tier, const Intent& owner_intent,                  // Registers a unit's passive for a tier and indexes its triggers (after setup_from_sheets).
+                              uint32_t effect_bitmask, int caster_index, int target_index,
+                              PassiveCondition<N> condition);
+        void set_journal(Journal* journal);                                                  // Attaches a journal recorded from the next roll_initiative on (nullptr to stop recording).
+        void set_trace(CombatTrace* trace);                                                  // Attaches a trace recorded from the next roll_initiative on, in PIPELINEPUNCH_TRACE builds (nullptr to stop).
+        void set_skill_programs(const SkillProgramLibrary* library);                         // Attaches SkillPrograms read by the next setup_from_sheets (SkillDispatch::PROGRAM only).
+        bool seek(const Journal& source, int target_turn);                                   // Restores the battle at a journaled turn from the closest snapshot (after setup_from_sheets with the same parties).
+        void snapshot_state(State& state) const;                                             // Copies the mutable battle state, for lookahead, undo or journal snapshots.
+        void restore_state(const State& state);                                              // Restores the mutable battle state from a snapshot of an engine with the same parties.
+        void fork(CombatEngine& child) const;                                                // Copies this battle, setup included, into another engine that advances independently.
+        bool add_effect(int team_index, int index, uint32_t effect_bits,                     // Adds a timed effect to a unit, lasting a number of its turn bars (while running).
+                        float magnitude, float bars);
+        int  dispel_effects(int team_index, int index, uint32_t mask);                       // Removes a unit's timed effects that have any bit of a mask.
+        bool start_cooldown(int team_index, int index, int skill_slot, int turns);           // Puts a unit's skill slot on cooldown for its next turns (0 clears it).
+        bool apply_effect_record(const JournalRecord<N>& record);                            // Applies a journaled EFFECT, DISPEL or COOLDOWN record again (false if refused).
+        bool bind_effect_stat(uint32_t effect_bit, CombatStat stat);                         // Makes a timed effect bit raise a stat by its effects' magnitudes, as fractions (between battles).
+        bool add_stat_modifier(const Intent& owner_intent, int target_team_index,            // Grants a unit a standing stat modifier while its owner lives (after setup_from_sheets).
+                               int target_index, CombatStat stat, float flat, float scale);
+
+        // --- Queries ---
+        CombatState                  get_combat_state() const;                 // Gets the current CombatState.
+        int                          get_winner_team_index() const;            // Gets the winning team index, or -1 while running or on a draw.
+        int                          get_turn_count() const;                   // Gets the number of turns resolved since roll_initiative.
+        const Intent&                get_main_intent() const;                  // Gets the intent of the current actor.
+        const CharacterTable<N>&     get_character_table(int team_index) const; // Gets a side's hot character table.
+        const CharacterColdTable<N>& get_cold_table(int team_index) const;     // Gets a side's cold table (skill slots and full CharacterSheets).
+        const Effects&               get_effect_table(int team_index) const;   // Gets a side's timed effects.
+        bool                         has_skill(int team_index, int index,      // Checks whether a unit has a usable skill in a slot, off cooldown.
+                                               int skill_slot) const;
+        int                          first_skill(int team_index,               // Gets a unit's first usable skill slot, or -1 if it has none.
+                                                 int index) const;
+        bool                         is_on_cooldown(int team_index, int index, // Checks whether a unit's skill slot is on cooldown.
+                                                    int skill_slot) const;
+        bool                         is_alive(int team_index, int pos) const;  // Checks whether the unit at a party position can still act.
+        uint32_t                     get_stat_version(int team_index,          // Gets the number of changes to a unit's stat modifiers since roll_initiative (wrapping).
+                                                      int index) const;
+        uint64_t                     get_seed() const;                         // Gets the seed of the battle's random stream.
+        uint64_t                     get_state_hash() const;                   // Gets a platform-independent hash of the live battle state, for replay verification.
+        int                          get_turn_order_forecast(Intent* out,      // Previews up to max_count actors after the current one, without touching the battle.
+                                                             int max_count) const;
+        const CascadeStats&          get_turn_cascade_stats() const;           // Gets the reaction cascade counters of the last turn.
+        const CascadeStats&          get_battle_cascade_stats() const;         // Gets the reaction cascade counters accumulated since roll_initiative.
+
+    private:
+        // --- Runtime CombatState ---
+        CombatState combat_state { CombatState::IDLE };
+        int         winner_team_index { -1 };
+        int         turn_count { 0 };
+        uint64_t    seed { 0 };
+        BattleRng   rng;
+
+        // --- Runtime ATB Scheduler ---
+        AtbScheduler<N, Config::ATB_CLOCK> scheduler;
+
+        // --- Runtime Character Tables (hot columns) ---
+        CharacterTable<N> ally_character_table;
+        CharacterTable<N> opponent_character_table;
+
+        // --- Runtime Cold Tables (read by the UI and tools only) ---
+        CharacterColdTable<N> ally_cold_table;
+        CharacterColdTable<N> opponent_cold_table;
+
+        // --- Runtime Effect Tables (timed effects, expired by the scheduler's clock) ---
+        Effects ally_effect_table;
+        Effects opponent_effect_table;
+
+        // --- Runtime Stat Tables (base stats and standing modifiers behind the effective stat columns) ---
+        StatTable<N> ally_stat_table;
+        StatTable<N> opponent_stat_table;
+        StatBindings stat_bindings;
+
+        // --- Runtime Passive Tables ---
+        PassiveTable<N> ally_negate_table;
+        PassiveTable<N> ally_intercept_table;
+        PassiveTable<N> ally_react_table;
+        PassiveTable<N> ally_modify_table;
+        PassiveTable<N> opponent_negate_table;
+        PassiveTable<N> opponent_intercept_table;
+        PassiveTable<N> opponent_react_table;
+        PassiveTable<N> opponent_modify_table;
+
+        // --- Runtime Battle Context ---
+        BattleContext<Config> context;
+        CascadeStats          turn_cascade_stats;
+        CascadeStats          battle_cascade_stats;
+
+        // --- Runtime Journal (caller-owned, optional) ---
+        Journal* journal { nullptr };
+
+        // --- Runtime Trace (caller-owned, optional; only recorded in PIPELINEPUNCH_TRACE builds) ---
+        CombatTrace* trace { nullptr };
+
+        // --- Runtime Skill Programs (caller-owned, optional) ---
+        const SkillProgramLibrary* skill_programs { nullptr };
+
+        // --- Runtime Skill Builders (resolved for this config, indexed by team, SoA index and slot) ---
+        SkillEnum                    active_skill[2][N][SKILL_SLOTS];         // Read by SkillDispatch::SWITCH.
+        const SkillProgram*          active_program[2][N][SKILL_SLOTS];       // Read by SkillDispatch::PROGRAM.
+        ActiveEventBuilderT<Config>  active_event_builder[2][N][SKILL_SLOTS];
+        PassiveEventBuilderT<Config> passive_event_builder[2][N][SKILL_SLOTS];
+
+        // --- Runtime Intents ---
+        Intent main_intent;
+        Intent negate_intent;
+        Intent intercept_intent;
+
+        // --- Internal logic ---
+        void     start_combat();                               // Sets CombatState to RUNNING
+        void     stop_combat();                                // Sets CombatState to ENDED
+        void     state_check();                                // Ends combat once a side has no living units.
+        static bool is_unit(int team_index, int index);        // Checks whether a team and SoA index name a slot of this config.
+        Intent   get_next_character(Intent& intent);           // Gets the next character.
+        void     build_main_event_queue(const Intent& intent); // Builds the main_event_queue from the active actor's chosen intent.
+        void     get_passives(Event<N>& e);                    // Gets relevant passives that trigger from an event, queueing their reactions.
+        void     on_unit_died(int team_index, int index);      // Drops a dead unit's passives from the trigger indices, its timed effects and its stat modifiers.
+        void     refresh_stats(int team_index, int index);     // Rebuilds a unit's effective stats after its modifiers changed, and moves its scheduled speed.
+        bool     place_effect(int team_index, int index,       // Adds a timed effect without journaling it.
+                              uint32_t effect_bits, float magnitude, float bars);
+        int      remove_effects(int team_index, int index,     // Removes a unit's timed effects by mask without journaling them.
+                                uint32_t mask);
+        PassiveTable<N>& get_passive_table(int team_index,     // Gets a side's passive table for a tier.
+                                           PassiveTier tier);
+        const PassiveTable<N>& get_passive_table(int team_index, PassiveTier tier) const;
+        void     resolve_events(Event<N>& main_event);         // Resolves a main event and its bounded reaction cascade in priority order.
+        void     resolve_event(Event<N>& e);                   // Resolves an event.
+        template <SkillPhase PHASE>
+        void     run_active_event_builder(const Intent& intent,         // Runs one phase of the intent's ActiveEventBuilder, as SkillDispatch selects.
+                                          const CharacterTable<N>& owner_ct,
+                                          const CharacterTable<N>& other_ct, Event<N>* e);
+    };
+}
\ No newline at end of file
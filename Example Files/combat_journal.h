@@ -0,0 +1,299 @@
+#pragma once
+
+// CombatJournal
+// -------------
+// Append-only binary journal of a battle, kept in fixed-size in-memory rings and flushed to disk on demand.
+// - Records are fixed-size: a SEED record opens the battle, a TURN record stores each Intent passed to turn(),
+//   and an EVENT record stores the damage arrays of each resolved event. EFFECT, DISPEL and COOLDOWN records store
+//   the timed effects a caller added, dispelled or put on a skill slot between turns, so a replay applies them too.
+// - Every SNAPSHOT_INTERVAL turns the CombatEngine stores its BattleState in a JournalSnapshot, so a replay
+//   viewer can seek to turn N by restoring the closest earlier snapshot and replaying only the turns and effect
+//   records after it.
+// - Both rings are inline arrays with power-of-two capacities; recording is a copy into the next slot and never
+//   allocates. Once a ring wraps, its oldest entries are overwritten.
+// - flush() appends every entry written since the previous flush to a file; load() reads such a file back.
+//
+// File layout: a JournalFileHeader, then chunks of { uint32 kind, uint32 count } followed by count records
+// (kind 1) or count snapshots (kind 2). Records and snapshots are written in their in-memory layout, so
+// files are only portable between builds with the same TEAM_SIZE, AtbClock, effect capacity, endianness and
+// struct layout; the header stores them so a mismatched reader fails instead of misreading.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_state.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the kind of a journal record.
+    enum class JournalRecordType : uint8_t {
+        SEED,     // Start of a battle; seed holds the battle's seed.
+        TURN,     // An Intent passed to turn().
+        EVENT,    // A resolved event's damage arrays.
+        EFFECT,   // A timed effect passed to add_effect().
+        DISPEL,   // A mask passed to dispel_effects() that removed effects.
+        COOLDOWN  // A cooldown passed to start_cooldown().
+    };
+
+    // Represents one fixed-size journal entry for a battle with N slots per side.
+    template <int N>
+    struct JournalRecord {
+        static constexpr float MAX_DURATION = 65536.0f; // Longest effect or cooldown a replay applies, in bars or turns.
+
+        JournalRecordType type;
+        int8_t            owner_team_index;
+        int8_t            owner_index;
+        int8_t            skill_slot;
+        int8_t            target_pos;
+        uint8_t           depth;               // Cascade depth of an EVENT record.
+        uint8_t           reserved[2];
+        uint32_t          turn;                // Turn count when the record was written.
+        uint32_t          effect_bits;         // Effect bits of an EFFECT record, mask of a DISPEL record.
+        uint64_t          seed;                // Battle seed of a SEED record.
+        float             effect_magnitude;    // Magnitude of an EFFECT record.
+        float             effect_duration;     // Turn bars of an EFFECT record, turns of a COOLDOWN record.
+        float             owner_pos_damage[N]; // Damage dealt to the owner's side, by party position.
+        float             other_pos_damage[N]; // Damage dealt to the other side, by party position.
+    };
+
+    // Represents the state of a battle at the start of a turn, with its position in the journal.
+    template <int N, AtbClock CLOCK = AtbClock::FLOAT, int EFFECTS = DEFAULT_EFFECTS_PER_UNIT * N>
+    struct JournalSnapshot {
+        uint64_t              sequence; // Records written before the snapshot; replay resumes from here.
+        BattleState<N, CLOCK, EFFECTS> state;
+    };
+
+    // Represents the header written at the start of a journal file.
+    struct JournalFileHeader {
+        static constexpr uint32_t MAGIC   = 0x4A505050u; // "PPPJ"
+        static constexpr uint32_t VERSION = 6;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t team_size;
+        uint32_t record_size;
+        uint32_t snapshot_size;
+        uint32_t snapshot_interval;
+        uint32_t atb_clock;         // AtbClock of the battle, whose turn order a replay must follow.
+        uint32_t reserved;
+        uint64_t seed;
+    };
+
+    // Represents the journal of one battle with N slots per side, scheduled on CLOCK, with up to EFFECTS timed
+    // effects per side.
+    template <int N, AtbClock CLOCK = AtbClock::FLOAT, int EFFECTS = DEFAULT_EFFECTS_PER_UNIT * N, int RECORDS = 1024, int SNAPSHOTS = 64>
+    struct CombatJournal {
+        static_assert((RECORDS & (RECORDS - 1)) == 0 && (SNAPSHOTS & (SNAPSHOTS - 1)) == 0, "Ring capacities must be powers of two.");
+
+        static constexpr int      SNAPSHOT_INTERVAL = 16; // Turns between snapshots.
+        static constexpr uint32_t CHUNK_RECORDS     = 1;
+        static constexpr uint32_t CHUNK_SNAPSHOTS   = 2;
+
+        uint64_t seed { 0 };
+        uint64_t record_count { 0 };    // Records written since begin(), including overwritten ones.
+        uint64_t snapshot_count { 0 };  // Snapshots written since begin(), including overwritten ones.
+        uint64_t flushed_records { 0 };
+        uint64_t flushed_snapshots { 0 };
+        uint64_t lost_records { 0 };    // Records overwritten before they were flushed.
+        bool     header_flushed { false };
+
+        JournalRecord<N>   records[RECORDS];
+        JournalSnapshot<N, CLOCK, EFFECTS> snapshots[SNAPSHOTS];
+
+        // --- Recording ---
+        // Starts the journal of a new battle, dropping everything recorded before.
+        void begin(uint64_t battle_seed) {
+            seed              = battle_seed;
+            record_count      = 0;
+            snapshot_count    = 0;
+            flushed_records   = 0;
+            flushed_snapshots = 0;
+            lost_records      = 0;
+            header_flushed    = false;
+
+            JournalRecord<N>& r = next_record(JournalRecordType::SEED, 0);
+            r.seed = battle_seed;
+        }
+
+        // Records an Intent passed to turn().
+        void record_turn(uint32_t turn, const Intent& intent) {
+            JournalRecord<N>& r = next_record(JournalRecordType::TURN, turn);
+            r.owner_team_index  = static_cast<int8_t>(intent.owner_team_index);
+            r.owner_index       = static_cast<int8_t>(intent.owner_index);
+            r.skill_slot        = static_cast<int8_t>(intent.skill_slot);
+            r.target_pos        = static_cast<int8_t>(intent.target_pos);
+        }
+
+        // Records the damage arrays of a resolved event.
+        void record_event(uint32_t turn, const Intent& intent, uint8_t depth, const float* owner_pos_damage, const float* other_pos_damage) {
+            JournalRecord<N>& r = next_record(JournalRecordType::EVENT, turn);
+            r.owner_team_index  = static_cast<int8_t>(intent.owner_team_index);
+            r.owner_index       = static_cast<int8_t>(intent.owner_index);
+            r.skill_slot        = static_cast<int8_t>(intent.skill_slot);
+            r.target_pos        = static_cast<int8_t>(intent.target_pos);
+            r.depth             = depth;
+
+            for (int pos = 0; pos < N; pos++) {
+                r.owner_pos_damage[pos] = owner_pos_damage[pos];
+                r.other_pos_damage[pos] = other_pos_damage[pos];
+            }
+        }
+
+        // Records a timed effect added to a unit; the unit goes in the owner fields, as in the other effect records.
+        void record_effect(uint32_t turn, int team_index, int index, uint32_t effect_bits, float magnitude, float bars) {
+            JournalRecord<N>& r = next_record(JournalRecordType::EFFECT, turn);
+            r.owner_team_index  = static_cast<int8_t>(team_index);
+            r.owner_index       = static_cast<int8_t>(index);
+            r.effect_bits       = effect_bits;
+            r.effect_magnitude  = magnitude;
+            r.effect_duration   = bars;
+        }
+
+        // Records a mask that dispelled a unit's timed effects.
+        void record_dispel(uint32_t turn, int team_index, int index, uint32_t mask) {
+            JournalRecord<N>& r = next_record(JournalRecordType::DISPEL, turn);
+            r.owner_team_index  = static_cast<int8_t>(team_index);
+            r.owner_index       = static_cast<int8_t>(index);
+            r.effect_bits       = mask;
+        }
+
+        // Records a cooldown put on a unit's skill slot.
+        void record_cooldown(uint32_t turn, int team_index, int index, int skill_slot, int turns) {
+            JournalRecord<N>& r = next_record(JournalRecordType::COOLDOWN, turn);
+            r.owner_team_index  = static_cast<int8_t>(team_index);
+            r.owner_index       = static_cast<int8_t>(index);
+            r.skill_slot        = static_cast<int8_t>(skill_slot);
+            r.effect_duration   = static_cast<float>(turns);
+        }
+
+        // Gets the slot of the next snapshot; the caller fills it. The sequence is set here.
+        JournalSnapshot<N, CLOCK, EFFECTS>& next_snapshot() {
+            JournalSnapshot<N, CLOCK, EFFECTS>& s = snapshots[snapshot_count++ & (SNAPSHOTS - 1)];
+            s.sequence = record_count;
+            return s;
+        }
+
+        // --- Queries ---
+        // Gets the sequence number of the oldest record still held in memory.
+        uint64_t first_record() const { return (record_count > RECORDS) ? record_count - RECORDS : 0; }
+
+        // Gets a record by sequence number; it must lie in [first_record(), record_count).
+        const JournalRecord<N>& record(uint64_t sequence) const { return records[sequence & (RECORDS - 1)]; }
+
+        // Gets the latest held snapshot taken at or before a turn whose replay records are still held, or nullptr.
+        const JournalSnapshot<N, CLOCK, EFFECTS>* find_snapshot(int turn) const {
+            const uint64_t first = (snapshot_count > SNAPSHOTS) ? snapshot_count - SNAPSHOTS : 0;
+
+            for (uint64_t i = snapshot_count; i > first; i--) {
+                const JournalSnapshot<N, CLOCK, EFFECTS>& s = snapshots[(i - 1) & (SNAPSHOTS - 1)];
+                if (s.state.turn_count <= turn && s.sequence >= first_record()) { return &s; }
+            }
+
+            return nullptr;
+        }
+
+        // --- Disk ---
+        // Appends every record and snapshot written since the previous flush to a file opened for binary writing.
+        // Returns false on a write error.
+        bool flush(std::FILE* file) {
+            if (!header_flushed) {
+                const JournalFileHeader header {
+                    JournalFileHeader::MAGIC, JournalFileHeader::VERSION, static_cast<uint32_t>(N),
+                    static_cast<uint32_t>(sizeof(JournalRecord<N>)), static_cast<uint32_t>(sizeof(JournalSnapshot<N, CLOCK, EFFECTS>)),
+                    static_cast<uint32_t>(SNAPSHOT_INTERVAL), static_cast<uint32_t>(CLOCK), 0, seed
+                };
+                if (std::fwrite(&header, sizeof(header), 1, file) != 1) return false;
+                header_flushed = true;
+            }
+
+            if (flushed_records < first_record()) {
+                lost_records    += first_record() - flushed_records;
+                flushed_records  = first_record();
+            }
+
+            const uint64_t first_snapshot = (snapshot_count > SNAPSHOTS) ? snapshot_count - SNAPSHOTS : 0;
+            if (flushed_snapshots < first_snapshot) { flushed_snapshots = first_snapshot; }
+
+            if (!write_chunk(file, CHUNK_RECORDS, records, RECORDS, flushed_records, record_count)) return false;
+            if (!write_chunk(file, CHUNK_SNAPSHOTS, snapshots, SNAPSHOTS, flushed_snapshots, snapshot_count)) return false;
+
+            flushed_records   = record_count;
+            flushed_snapshots = snapshot_count;
+
+            return std::fflush(file) == 0;
+        }
+
+        // Reads the first battle of a journal file into the rings, keeping the newest entries if it does not fit.
+        // Returns false if the file is not a journal of this TEAM_SIZE, AtbClock and layout.
+        bool load(std::FILE* file) {
+            JournalFileHeader header;
+            if (std::fread(&header, sizeof(header), 1, file) != 1) return false;
+            if (header.magic != JournalFileHeader::MAGIC || header.version != JournalFileHeader::VERSION) return false;
+            if (header.team_size != static_cast<uint32_t>(N) || header.record_size != sizeof(JournalRecord<N>) || header.snapshot_size != sizeof(JournalSnapshot<N, CLOCK, EFFECTS>)) return false;
+            if (header.atb_clock != static_cast<uint32_t>(CLOCK)) return false;
+
+            seed              = header.seed;
+            record_count      = 0;
+            snapshot_count    = 0;
+            lost_records      = 0;
+            header_flushed    = true;
+
+            uint32_t chunk[2];
+            while (std::fread(chunk, sizeof(chunk), 1, file) == 1) {
+                for (uint32_t i = 0; i < chunk[1]; i++) {
+                    bool ok = false;
+
+                    if (chunk[0] == CHUNK_RECORDS) {
+                        JournalRecord<N> r;
+                        ok = std::fread(&r, sizeof(r), 1, file) == 1;
+                        // A second SEED record starts the next battle of an appended file.
+                        if (ok && r.type == JournalRecordType::SEED && record_count > 0) { return finish_load(); }
+                        if (ok) { records[record_count++ & (RECORDS - 1)] = r; }
+                    } else if (chunk[0] == CHUNK_SNAPSHOTS) {
+                        JournalSnapshot<N, CLOCK, EFFECTS>& s = snapshots[snapshot_count & (SNAPSHOTS - 1)];
+                        ok = std::fread(&s, sizeof(s), 1, file) == 1;
+                        if (ok) { snapshot_count++; }
+                    }
+
+                    if (!ok) return false;
+                }
+            }
+
+            return finish_load();
+        }
+
+    private:
+        // Gets the next record slot, cleared, overwriting the oldest once the ring is full.
+        JournalRecord<N>& next_record(JournalRecordType type, uint32_t turn) {
+            JournalRecord<N>& r = records[record_count++ & (RECORDS - 1)];
+            r      = JournalRecord<N>{};
+            r.type = type;
+            r.turn = turn;
+            return r;
+        }
+
+        // Writes the ring entries [from, to) as one chunk.
+        template <typename T>
+        static bool write_chunk(std::FILE* file, uint32_t kind, const T* ring, int capacity, uint64_t from, uint64_t to) {
+            if (from == to) return true;
+
+            const uint32_t chunk[2] = { kind, static_cast<uint32_t>(to - from) };
+            if (std::fwrite(chunk, sizeof(chunk), 1, file) != 1) return false;
+
+            for (uint64_t i = from; i < to; i++) {
+                if (std::fwrite(&ring[i & (capacity - 1)], sizeof(T), 1, file) != 1) return false;
+            }
+
+            return true;
+        }
+
+        // Marks everything loaded as already flushed.
+        bool finish_load() {
+            flushed_records   = record_count;
+            flushed_snapshots = snapshot_count;
+            return record_count > 0;
+        }
+    };
+}
\ No newline at end of file
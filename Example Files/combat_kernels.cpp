@@ -0,0 +1,82 @@
+// CombatKernels
+// -------------
+// Self-test of the vector kernels against their scalar kernels.
+// - Inputs come from a seeded BattleRng, salted with edge cases: exact kills, overkill, zero and negative damage,
+//   units already at 0 or -0 life, life above lp, NaN life and zero divisors.
+// - Results are compared bitwise, so a kernel that rounds, clamps or signs zero differently is caught.
+
+#include "combat_kernels.h"
+
+#include <cstring>
+#include <limits>
+
+#include "pipelinepunch/systems/combat_system/structs/battle_rng.h"
+
+namespace pipelinepunch {
+
+    // Gets a random float between 0 and range, in steps of 1/8 so sums and clamps land on exact values often.
+    static float random_amount(BattleRng& rng, uint32_t range) { return static_cast<float>(rng.next_below(range * 8)) / 8.0f; }
+
+    // Checks every vector kernel against its scalar kernel on seeded random and edge-case input.
+    // Returns the number of mismatching results; always 0 in a scalar build.
+    int run_combat_kernel_self_test(uint64_t seed, int rounds) {
+        constexpr int MAX = COMBAT_KERNEL_MAX_UNITS;
+
+        BattleRng rng;
+        rng.seed(seed);
+
+        int mismatches = 0;
+
+        for (int round = 0; round < rounds; round++) {
+            const int count = 1 + static_cast<int>(rng.next_below(MAX));
+
+            // --- apply_damage ---
+            float life[MAX], life_bar[MAX], lp[MAX], damage[MAX];
+            for (int i = 0; i < count; i++) {
+                lp[i]       = 1.0f + random_amount(rng, 4000);
+                life[i]     = random_amount(rng, static_cast<uint32_t>(lp[i]));
+                life_bar[i] = life[i] / lp[i];
+                damage[i]   = random_amount(rng, 2000) - 200.0f;
+
+                switch (rng.next_below(10)) {
+                    case 0:  damage[i] = life[i];                                  break; // Exact kill.
+                    case 1:  damage[i] = 0.0f;                                     break;
+                    case 2:  life[i]   = 0.0f;                                     break;
+                    case 3:  life[i]   = -0.0f;                                    break;
+                    case 4:  life[i]   = lp[i] + 50.0f;                            break; // Clamped back to lp if hit lightly.
+                    case 5:  life[i]   = std::numeric_limits<float>::quiet_NaN();  break;
+                    case 6:  lp[i]     = 0.0f;                                     break; // Empty slot: life_bar divides by 0.
+                    default:                                                       break;
+                }
+            }
+
+            float scalar_life[MAX], scalar_life_bar[MAX];
+            std::memcpy(scalar_life,     life,     sizeof(float) * count);
+            std::memcpy(scalar_life_bar, life_bar, sizeof(float) * count);
+
+            const uint32_t died        = apply_damage(life, life_bar, lp, damage, count);
+            const uint32_t scalar_died = apply_damage_scalar(scalar_life, scalar_life_bar, lp, damage, 0, count);
+
+            if (died != scalar_died)                                             { mismatches++; }
+            if (std::memcmp(life,     scalar_life,     sizeof(float) * count))  { mismatches++; }
+            if (std::memcmp(life_bar, scalar_life_bar, sizeof(float) * count))  { mismatches++; }
+
+            // --- scaled_ratio ---
+            // Products stay inside int32, where the scalar kernel's integer arithmetic is defined.
+            int32_t power[MAX], divisor[MAX], out[MAX], scalar_out[MAX];
+            const int32_t scale = static_cast<int32_t>(rng.next_below(2001));
+            for (int i = 0; i < count; i++) {
+                power[i]   = static_cast<int32_t>(rng.next_below(2001)) - 1000;
+                divisor[i] = static_cast<int32_t>(rng.next_below(601)) - 300;
+                if (rng.next_below(8) == 0) { divisor[i] = 0; }
+            }
+
+            scaled_ratio(out, power, scale, divisor, count);
+            scaled_ratio_scalar(scalar_out, power, scale, divisor, 0, count);
+
+            if (std::memcmp(out, scalar_out, sizeof(int32_t) * count)) { mismatches++; }
+        }
+
+        return mismatches;
+    }
+}
\ No newline at end of file
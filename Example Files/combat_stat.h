@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace pipelinepunch {
+
+    // Represents a stat that modifiers can change, in the column order of a StatTable.
+    enum class CombatStat : uint8_t {
+        ATK,
+        DEF,
+        MAG,
+        CRT,
+        SPE,
+        DMG_IN,  // Incoming damage multiplier.
+        DMG_OUT, // Outgoing damage multiplier.
+        COUNT
+    };
+}
\ No newline at end of file
@@ -1,36 +1,60 @@
 // CombatSystem
 // ------------
 // The CombatSystem owns the combat functionality for a 5v5 battle.
-// - Holds Struct-of-Arrays character tables for both sides, which allow efficient processing
-//   of more complex events than in many similar games.
-// - Builds event queues and resolves events and reactions based on a tiered priority system.
-// - Handles current actor states and advances an ATB-style turn bar to select the next actor.
+// - Reads both parties from the Character and Party inventories.
+// - Delegates all combat logic to a Godot-free CombatEngine, which holds Struct-of-Arrays
+//   character tables for both sides, builds and resolves tiered event queues and advances
+//   an ATB-style turn bar to select the next actor.
+// - Each node owns its own engine, so any number of battles can be live at once.
+// - Journals every battle into an in-memory CombatJournal that can be flushed to disk and seeked for replays.
+// - In PIPELINEPUNCH_TRACE builds, traces every battle's turn phases into a CombatTrace whose counters the UI can
+//   read and whose spans export to a Chrome trace file.
+// - Plays AI-controlled turns with a CombatAi whose per-move search budget keeps a move within a frame.
+// - Keeps the GUI snapshot in persistent packed buffers, updated only where values changed, with a version,
+//   a dirty mask and a gui_snapshot_changed signal so the UI never has to poll per frame.
+// - Maps a CreaturePack on request and serves its names to the UI, so its string table is only paged in when shown.
 // - Exposes a minimal API for the Godot UI.
 
+#include <algorithm>
 #include <array>
-#include <limits>
+#include <cstdio>
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include "combat_system.h"
 
 #include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/data/libraries/skill_library.h"
 #include "pipelinepunch/inventory/character_inventory.h"
 #include "pipelinepunch/inventory/party_inventory.h"
-#include "pipelinepunch/systems/combat_system/enums/combat_state.h"
+#include "pipelinepunch/systems/combat_system/combat_ai.h"
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
 #include "pipelinepunch/systems/combat_system/structs/character_table.h"
-#include "pipelinepunch/systems/combat_system/structs/event.h"
-#include "pipelinepunch/systems/combat_system/structs/event_queue.h"
-#include "pipelinepunch/systems/combat_system/structs/intent.h"
-#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
 
 namespace pipelinepunch {
 	
-	// --- Singleton Access ---
-	// Defines the CombatSystem instance.
-	CombatSystem::CombatSystem() { instance = this; }
+	// Allocates the persistent GUI buffers once, so later syncs write into them in place.
+	CombatSystem::CombatSystem() {
+		static const char* const GUI_KEYS[2][GUI_COLUMNS] = {
+			{ "allies_life",    "allies_life_bar",    "allies_turn_bar" },
+			{ "opponents_life", "opponents_life_bar", "opponents_turn_bar" }
+		};
+
+		for (int team_index = 0; team_index < 2; team_index++) {
+			for (int column = 0; column < GUI_COLUMNS; column++) {
+				gui_keys[team_index][column] = GUI_KEYS[team_index][column];
+				gui_columns[team_index][column].resize(TEAM_SIZE);
+				gui_columns[team_index][column].fill(0.0f);
+				gui_snapshot[gui_keys[team_index][column]] = gui_columns[team_index][column];
+			}
 
-	// Gets the CombatSystem instance.
-	CombatSystem* CombatSystem::get_instance() { return instance; }
+			creature_ids[team_index].resize(TEAM_SIZE);
+			creature_ids[team_index].fill(0);
+		}
+
+		creature_ids_snapshot["allies_creature_id"]    = creature_ids[0];
+		creature_ids_snapshot["opponents_creature_id"] = creature_ids[1];
+	}
 
 	// --- Godot Entry Points ---
 	// Registers parties in the combat system.
@@ -41,170 +65,77 @@ namespace pipelinepunch {
 		const Party &ally_party     = party_inventory->get_party(ally_arena_id);
 		const Party &opponent_party = party_inventory->get_party(opponent_arena_id);
 
-		// Initialises a side's runtime character table from a Party definition.
-		auto fill_side = [character_inventory](CharacterTable<5> &ct, const Party &party) {
-			for (int pos = 0; pos < 5; pos++) {
-				int creature_id = party.slots[pos];
-				CharacterSheet *cs = character_inventory->get_character_sheet(creature_id);
-				if (!cs) {
-					ct.pos_to_index[pos] = pos;
-					ct.index_to_pos[pos] = pos;
-					ct.life_bar[pos]     = 1.f;
-					ct.turn_bar[pos]     = 0.f;
-					ct.dmg_in[pos]       = 0.f;
-					ct.dmg_out[pos]      = 0.f;
-					continue;
-				}
-
-				// Maps SoA index to party position.
-				ct.pos_to_index[pos] = pos;
-				ct.index_to_pos[pos] = pos;
-
-				// Snapshots base stats into the runtime table.
-				Stats  stats     = cs->stats;
-				Skills skills    = cs->skills;
-
-				ct.life[pos]     = stats.lp;
-				ct.life_bar[pos] = 1.0f;
-				ct.turn_bar[pos] = 0.0f;
-				ct.dmg_in[pos]   = 1.0f;
-				ct.dmg_out[pos]  = 1.0f;
-				ct.lp[pos]       = stats.lp;
-				ct.atk[pos]      = stats.atk;
-				ct.def[pos]      = stats.def;
-				ct.mag[pos]      = stats.mag;
-				ct.crt[pos]      = stats.crt;
-				ct.spe[pos]      = stats.spe;
-
-				// Addons
-				ct.skills[pos]   = skills;
-				
-				// ROADMAP: Buffs     buffs     = cs->buffs;
-				// ROADMAP: Cooldowns cooldowns = cs->cooldowns;
-				// ROADMAP: ct.buffs[pos]       = buffs;
-				// ROADMAP: ct.cooldowns[pos]   = cooldowns;
-
-				// CharacterSheet
-				ct.character_sheet[pos] = *cs;
-			}
+		// Resolves a Party definition into per-position CharacterSheets.
+		auto resolve_sheets = [character_inventory](const Party &party) {
+			std::array<const CharacterSheet*, TEAM_SIZE> sheets;
+			for (int pos = 0; pos < TEAM_SIZE; pos++) { sheets[pos] = character_inventory->get_character_sheet(party.slots[pos]); }
+			return sheets;
 		};
 
-		fill_side(ally_character_table, ally_party);
-		fill_side(opponent_character_table, opponent_party);
+		engine.setup_from_sheets(resolve_sheets(ally_party), resolve_sheets(opponent_party));
+
+		// Refreshes the creature ids; the dictionary lets go of the arrays first so they are written in place.
+		creature_ids_snapshot.clear();
+		for (int team_index = 0; team_index < 2; team_index++) {
+			const CharacterColdTable<TEAM_SIZE> &cold_table = engine.get_cold_table(team_index);
+			int32_t *ids = creature_ids[team_index].ptrw();
+
+			for (int pos = 0; pos < TEAM_SIZE; pos++) { ids[pos] = cold_table.character_sheet[pos].creature_sheet.creature_id; }
+		}
+		creature_ids_snapshot["allies_creature_id"]    = creature_ids[0];
+		creature_ids_snapshot["opponents_creature_id"] = creature_ids[1];
+
+		sync_gui_snapshot();
 	}
 
 	// Initialises life and turn bars, then selects the first actor.
+	// Without an explicit seed, a fresh one is drawn so get_seed() can still replay the battle.
 	void CombatSystem::roll_initiative() {
-        for (int index = 0; index < 5; index++) {
-			// Allies
-			ally_character_table.life_bar[index]     = 1.0f;
-			ally_character_table.turn_bar[index]     = 0.0f;
-
-			// Opponents
-			opponent_character_table.life_bar[index] = 1.0f;
-			opponent_character_table.turn_bar[index] = 0.0f;
+		if (!seed_is_set) {
+			const uint64_t high = static_cast<uint32_t>(godot::UtilityFunctions::randi());
+			const uint64_t low  = static_cast<uint32_t>(godot::UtilityFunctions::randi());
+			engine.set_seed((high << 32) | low);
 		}
 
-		start_combat();
-		get_next_character(main_intent);
-
-		// ROADMAP: while (is_running()) { CombatSystem::turn(); }
-		// ROADMAP: stop_combat();
+		seed_is_set = false;
+		engine.set_journal(&journal);
+		engine.set_trace(&trace);
+		engine.roll_initiative();
+		sync_gui_snapshot();
 	}
 
 	// Handles a single player-controlled turn: choose skill/target, resolve, then advance to the next actor.
-	void CombatSystem::turn(int skill_slot, int target_pos) {
-		main_intent.skill_slot = skill_slot;
-		main_intent.target_pos = target_pos;
-
-		build_main_event_queue(main_intent);
-
-		for (int i = 0; i < main_event_queue.count; i++) {
-			Event& event = main_event_queue.event[i];
-			// get_passives(event);
-			resolve_events(event);
-		}
+	// Returns false, changing nothing, for a slot that is empty or on cooldown or a target out of range.
+	bool CombatSystem::turn(int skill_slot, int target_pos) {
+		if (!engine.turn(skill_slot, target_pos)) return false;
 
-		// ROADMAP: state_check();
-		// ROADMAP: end_combat();
-		
-		// After resolving the turn (and any reactions), hands control to the next actor.
-		get_next_character(main_intent);
+		sync_gui_snapshot();
+		return true;
 	}
 
 	// Gets all creature_ids for the GUI.
-	godot::Dictionary CombatSystem::get_creature_ids() const {
-		// Allies
-		godot::PackedInt32Array allies_creature_id;
-		allies_creature_id.resize(5);
-
-		for (int pos = 0; pos < 5; pos++) {
-			allies_creature_id[pos] = ally_character_table.character_sheet[pos].creature_sheet.creature_id;
-		}
-
-		// Opponents
-		godot::PackedInt32Array opponents_creature_id;
-		opponents_creature_id.resize(5);
-
-		for (int pos = 0; pos < 5; pos++) {
-			opponents_creature_id[pos] = opponent_character_table.character_sheet[pos].creature_sheet.creature_id;
-		}
-
-		// Defines dictionary.
-		godot::Dictionary d;
-		d["allies_creature_id"]    = allies_creature_id;
-		d["opponents_creature_id"] = opponents_creature_id;
-
-		return d;
-	};
+	// Returns the persistent dictionary refreshed by setup_from_parties, so repeated calls copy nothing.
+	godot::Dictionary CombatSystem::get_creature_ids() const { return creature_ids_snapshot; }
 
 	// Gets a snapshot of all combat-relevant values needed by the UI.
-	godot::Dictionary CombatSystem::get_gui_snapshot() const {
-		// Allies
-		godot::PackedFloat32Array allies_life;
-		godot::PackedFloat32Array allies_life_bar;
-		godot::PackedFloat32Array allies_turn_bar;
-		allies_life.resize(5);
-		allies_life_bar.resize(5);
-		allies_turn_bar.resize(5);
-
-		for (int pos = 0; pos < 5; pos++) {
-			int index = ally_character_table.pos_to_index[pos];
-			allies_life[pos]     = ally_character_table.life[index];
-			allies_life_bar[pos] = ally_character_table.life_bar[index];
-			allies_turn_bar[pos] = ally_character_table.turn_bar[index];
-		}
+	// Returns the persistent dictionary kept in sync after every battle change, then clears the dirty mask,
+	// so a frame with no change costs one call and no allocation.
+	godot::Dictionary CombatSystem::get_gui_snapshot() {
+		gui_dirty_mask = 0;
+		return gui_snapshot;
+	}
 
-		// Opponents
-		godot::PackedFloat32Array opponents_life;
-		godot::PackedFloat32Array opponents_life_bar;
-		godot::PackedFloat32Array opponents_turn_bar;
-		opponents_life.resize(5);
-		opponents_life_bar.resize(5);
-		opponents_turn_bar.resize(5);
-
-		for (int pos = 0; pos < 5; pos++) {
-			int index = opponent_character_table.pos_to_index[pos];
-			opponents_life[pos]     = opponent_character_table.life[index];
-			opponents_life_bar[pos] = opponent_character_table.life_bar[index];
-			opponents_turn_bar[pos] = opponent_character_table.turn_bar[index];
-		}
+	// Gets the version of the GUI snapshot, incremented whenever a value in it changes.
+	int64_t CombatSystem::get_gui_version() const { return gui_version; }
 
-		// Defines the GUI dictionary.
-		godot::Dictionary d;
-		d["allies_life"]        = allies_life;
-		d["allies_life_bar"]    = allies_life_bar;
-		d["allies_turn_bar"]    = allies_turn_bar;
-		d["opponents_life"]     = opponents_life;
-		d["opponents_life_bar"] = opponents_life_bar;
-		d["opponents_turn_bar"] = opponents_turn_bar;
-
-		return d;
-	};
+	// Gets the values changed since the last get_gui_snapshot, one bit per value:
+	// bit (column * 2 + team_index) * TEAM_SIZE + pos, with columns life, life_bar and turn_bar.
+	int64_t CombatSystem::get_gui_dirty_mask() const { return static_cast<int64_t>(gui_dirty_mask); }
 
 	// Gets turn owners team index and position.
 	godot::Dictionary CombatSystem::get_current_turn_owner() const {
-		const CharacterTable<5> &ct = (main_intent.owner_team_index == 0) ? ally_character_table : opponent_character_table;
+		const Intent            &main_intent = engine.get_main_intent();
+		const CharacterTable<TEAM_SIZE> &ct          = engine.get_character_table(main_intent.owner_team_index);
 		int pos = ct.index_to_pos[main_intent.owner_index];
 
 		godot::Dictionary d;
@@ -214,294 +145,237 @@ namespace pipelinepunch {
 		return d;
 	};
 
-	// --- Event pushing ---
-	// ROADMAP: To be made private.
-	// Pushes an event to the fast_event_queue_plus.
-	void CombatSystem::push_fast_event_plus(const Event& e) { fast_event_queue_plus.add_event(e); }
-
-	// Pushes an event to the fast_event_queue.
-	void CombatSystem::push_fast_event(const Event& e) { fast_event_queue.add_event(e); }
-	
-	// Pushes an event to the main_event_queue.
-	void CombatSystem::push_main_event(const Event& e) { main_event_queue.add_event(e); }
+	// Gets up to count upcoming actors after the current one, for the turn-order strip.
+	// Each entry holds a team index and position; the preview assumes no deaths or speed changes.
+	godot::Array CombatSystem::get_turn_order_forecast(int count) const {
+		std::array<Intent, MAX_TURN_ORDER_FORECAST> forecast;
+		const int written = engine.get_turn_order_forecast(forecast.data(), std::min(count, MAX_TURN_ORDER_FORECAST));
 
-	// Pushes an event to the slow_event_queue_plus.
-	void CombatSystem::push_slow_event_plus(const Event& e) { slow_event_queue_plus.add_event(e); }
+		godot::Array a;
+		for (int i = 0; i < written; i++) {
+			const CharacterTable<TEAM_SIZE> &ct = engine.get_character_table(forecast[i].owner_team_index);
 
-	// Pushes an event to the slow_event_queue.
-	void CombatSystem::push_slow_event(const Event& e) { slow_event_queue.add_event(e); }
+			godot::Dictionary d;
+			d["team_index"] = forecast[i].owner_team_index;
+			d["pos"]        = ct.index_to_pos[forecast[i].owner_index];
+			a.push_back(d);
+		}
 
-	// --- Godot Bindings ---
-	// Binds C++ methods with Godot Engine.
-	void CombatSystem::_bind_methods() {
-		godot::ClassDB::bind_method(godot::D_METHOD("setup_from_parties"), &CombatSystem::setup_from_parties);
-		godot::ClassDB::bind_method(godot::D_METHOD("roll_initiative"), &CombatSystem::roll_initiative);
-		godot::ClassDB::bind_method(godot::D_METHOD("get_creature_ids"), &CombatSystem::get_creature_ids);
-		godot::ClassDB::bind_method(godot::D_METHOD("get_gui_snapshot"), &CombatSystem::get_gui_snapshot);
-		godot::ClassDB::bind_method(godot::D_METHOD("get_current_turn_owner"), &CombatSystem::get_current_turn_owner);
-		godot::ClassDB::bind_method(godot::D_METHOD("turn", "skill_slot", "target_pos"), &CombatSystem::turn);
+		return a;
 	}
 
-	// --- Internal logic ---
-	// Sets CombatState to RUNNING
-	void CombatSystem::start_combat() { combat_state = CombatState::RUNNING; }
-
-	// Sets CombatState to ENDED
-	void CombatSystem::stop_combat() { combat_state = CombatState::ENDED; }
-
-	// Gets the next character.
-	// - Advances both sides turn bars by the smallest step needed to give at least one actor a full bar.
-	// - Picks the fastest actor among all full bars.
-    // - Ties are broken randomly between actors with equal speed.
-	Intent CombatSystem::get_next_character(Intent& intent) {
-		std::array<Intent, 8> candidates;
-		int   candidates_count = 0;
-		float highest_speed    = -1.0f;
-		bool  found_full       = false;
-		float min_step         = std::numeric_limits<float>::infinity();
-
-		// Records any units already ready to act, and track the smallest step needed to give at least one actor a full bar.
-		auto scan = [&](const CharacterTable<5>& character_table, int team_index){
-			for (int pos = 0; pos < 5; pos++) {
-				int   index    = character_table.pos_to_index[pos];
-				float turn_bar = character_table.turn_bar[index];
-				float spe      = character_table.spe[index];
-
-				if (turn_bar >= 1.0f) {
-					found_full = true;
-
-					if (spe > highest_speed) {
-						highest_speed = spe;
-						candidates[0] = { team_index, index };
-						candidates_count = 1;
-					} else if (spe == highest_speed) {
-						candidates[candidates_count++] = { team_index, index };
-					}
-				} else {
-					float step = (1.0f - turn_bar) / spe;
-					if (step < min_step) { min_step = step; }
-				}
-			}
-		};
-
-		// Advances every unit's bar by the global minimum step.
-		auto fill = [&](CharacterTable<5>& character_table){
-			for (int pos = 0; pos < 5; pos++) {
-				int index = character_table.pos_to_index[pos];
-				character_table.turn_bar[index] += min_step * character_table.spe[index];
-			}
-		};
+	// Sets the seed used by the next roll_initiative, for reproducible battles.
+	void CombatSystem::set_seed(int64_t seed) {
+		engine.set_seed(static_cast<uint64_t>(seed));
+		seed_is_set = true;
+	}
 
-		// Records all units whose bar is now full.
-		auto rescan = [&](const CharacterTable<5>& character_table, int team_index){
-			for (int pos = 0; pos < 5; pos++) {
-				int   index    = character_table.pos_to_index[pos];
-				float turn_bar = character_table.turn_bar[index];
-				float spe      = character_table.spe[index];
-
-				if (turn_bar >= 1.0f) {
-					if (spe > highest_speed) {
-						highest_speed = spe;
-						candidates[0] = { team_index, index };
-						candidates_count = 1;
-					} else if (spe == highest_speed) {
-						candidates[candidates_count++] = { team_index, index };
-					}
-				}
-			}
-		};
+	// Gets the seed of the current battle, for replays.
+	int64_t CombatSystem::get_seed() const { return static_cast<int64_t>(engine.get_seed()); }
 
-		scan(ally_character_table,     0);
-		scan(opponent_character_table, 1);
+	// Appends the journal entries recorded since the last flush to a file (res:// and user:// paths are supported).
+	bool CombatSystem::flush_journal(const godot::String& path) {
+		const godot::String global_path = godot::ProjectSettings::get_singleton()->globalize_path(path);
 
-		if (!found_full) {
-			fill(ally_character_table    );
-			fill(opponent_character_table);
+		std::FILE* file = std::fopen(global_path.utf8().get_data(), "ab");
+		if (!file) { return false; }
 
-			rescan(ally_character_table,     0);
-			rescan(opponent_character_table, 1);
-		}
+		const bool ok = journal.flush(file);
+		std::fclose(file);
 
-		intent = candidates[godot::UtilityFunctions::randi() % candidates_count];
-
-		return intent;
+		return ok;
 	}
 
-    // Builds the main_event_queue from the active actor's chosen intent.
-	void CombatSystem::build_main_event_queue(const Intent& intent) {
-		main_event_queue.clear();
-		
-		CharacterTable<5>& owner_ct = (intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
-		CharacterTable<5>& other_ct = (intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
+	// Restores the battle at a journaled turn, for the replay viewer.
+	// Recording stops until the next roll_initiative, so the journal keeps the original battle.
+	bool CombatSystem::seek_to_turn(int turn) {
+		engine.set_journal(nullptr);
+		const bool ok = engine.seek(journal, turn);
+		sync_gui_snapshot();
 
-		auto builder = owner_ct.character_sheet[intent.owner_index].skills.active_event_builder[intent.skill_slot];
-		builder(owner_ct, other_ct, intent, nullptr);
+		return ok;
 	}
 
-	// Gets relevant passives that trigger from the current main event.
-	void CombatSystem::get_passives(Event& e) {
-		// Determines if a passive is a valid response to an event.
-		auto passive_is_valid = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, const Event& e, int i)->bool {
-			const int owner_index = pt.intent[i].owner_index;
+	// Gets the current battle's trace counters, with whether tracing is compiled in and the spans held and lost.
+	godot::Dictionary CombatSystem::get_trace_counters() const {
+		const TraceCounters& c = trace.counters;
 
-			if (other_ct.life[owner_index] < 0 || other_ct.index_to_pos[owner_index] < 0) return false;
-			if ((pt.observed_effect_bitmask[i] & e.effect_bitmask) == 0) return false;
+		godot::Dictionary d;
+		d["enabled"]              = COMBAT_TRACE_ENABLED;
+		d["turns"]                = static_cast<int64_t>(c.turns);
+		d["events_resolved"]      = static_cast<int64_t>(c.events_resolved);
+		d["max_events_per_turn"]  = static_cast<int64_t>(c.max_events_per_turn);
+		d["main_high_water"]      = static_cast<int64_t>(c.queue_high_water[static_cast<int>(TraceQueue::MAIN)]);
+		d["fast_plus_high_water"] = static_cast<int64_t>(c.queue_high_water[static_cast<int>(TraceQueue::FAST_PLUS)]);
+		d["fast_high_water"]      = static_cast<int64_t>(c.queue_high_water[static_cast<int>(TraceQueue::FAST)]);
+		d["slow_plus_high_water"] = static_cast<int64_t>(c.queue_high_water[static_cast<int>(TraceQueue::SLOW_PLUS)]);
+		d["slow_high_water"]      = static_cast<int64_t>(c.queue_high_water[static_cast<int>(TraceQueue::SLOW)]);
+		d["passive_lookups"]      = static_cast<int64_t>(c.passive_lookups);
+		d["passives_scanned"]     = static_cast<int64_t>(c.passives_scanned);
+		d["condition_calls"]      = static_cast<int64_t>(c.condition_calls);
+		d["spans"]                = static_cast<int64_t>(trace.span_count - trace.first_span());
+		d["spans_lost"]           = static_cast<int64_t>(trace.first_span());
 
-			const int  oci          = pt.observed_caster_index[i];
-			const int  oti          = pt.observed_target_index[i];
-			const bool caster_match = (oci == -1) || (oci == e.intent.owner_index);
-			const bool target_match = (oti == -1) || (oti == other_ct.pos_to_index[e.intent.target_pos]);
+		return d;
+	}
 
-			if (!(caster_match || target_match)) return false;
-			if (!pt.condition[i](owner_ct, other_ct, e.intent)) return false;
+	// Writes the current battle's trace as Chrome trace event JSON (res:// and user:// paths are supported), for
+	// chrome://tracing or ui.perfetto.dev. Fails in builds without PIPELINEPUNCH_TRACE, which record nothing.
+	bool CombatSystem::export_trace(const godot::String& path) {
+		if (!COMBAT_TRACE_ENABLED) {
+			godot::UtilityFunctions::push_error("export_trace: built without PIPELINEPUNCH_TRACE");
+			return false;
+		}
 
-			return true;
-		};
+		const godot::String global_path = godot::ProjectSettings::get_singleton()->globalize_path(path);
 
-		// Scans and returns the fastest valid passive in response to an event.
-		auto scan_fastest = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, const Event& e, Intent& candidate)->bool {
-			std::array<Intent, 8> candidates;
-			int                   candidates_count = 0;
-			float                 highest_speed    = -1.0f;
-
-			for (int i = 0; i < pt.count; i++) {
-				if (passive_is_valid(owner_ct, other_ct, pt, e, i)){
-					const float spe = other_ct.spe[pt.intent[i].owner_index];
-
-					if (spe > highest_speed) {
-						highest_speed = spe;
-						candidates[0] = pt.intent[i];
-						candidates_count = 1;
-					} else if (spe == highest_speed) {
-						candidates[candidates_count++] = pt.intent[i];
-					}
-				}
-			}
+		std::FILE* file = std::fopen(global_path.utf8().get_data(), "wb");
+		if (!file) { return false; }
 
-			if (candidates_count == 0) return false;
+		const bool ok = trace.write_chrome_trace(file);
+		return (std::fclose(file) == 0) && ok;
+	}
 
-			return true;
-		};
+	// Gets the CombatAi's skill slot and target position for the current actor, with the rollouts spent and
+	// the move's estimated win chance. Blocks for up to the search budget (see set_ai_budget_ms).
+	godot::Dictionary CombatSystem::choose_ai_turn() {
+		const CombatAiChoice choice = ai.choose(engine);
 
-		// Scans and returns all valid passives in response to an event.
-		auto scan_all = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, Event& e, std::array<Intent, 8>& candidates, int& candidates_count)->bool {
-			for (int i = 0; i < pt.count; i++) {
-				if (passive_is_valid(owner_ct, other_ct, pt, e, i)) { candidates[candidates_count++] = pt.intent[i]; }
-			}
+		godot::Dictionary d;
+		d["skill_slot"] = choice.skill_slot;
+		d["target_pos"] = choice.target_pos;
+		d["rollouts"]   = choice.rollouts;
+		d["value"]      = choice.value;
 
-			return candidates_count > 0;
-		};
-		
-		// Builds a passive response for the given intent.
-		auto build_passive = [&](Intent& intent) {
-			CharacterTable<5>& owner_character_table = (intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
-			CharacterTable<5>& other_character_table = (intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
-
-			auto builder = owner_character_table.skills[intent.owner_index].passive_event_builder[intent.skill_slot];
-			builder(owner_character_table, other_character_table, intent);		
-		};
+		return d;
+	}
 
-		// Finds and applies the fastest negate passive, if any, marking the event as negated.
-		auto get_negate = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, Event& e)->bool {
-			Intent candidate;
+	// Handles a single AI-controlled turn for the current actor: search, resolve, then advance to the next actor.
+	void CombatSystem::ai_turn() {
+		if (engine.get_combat_state() != CombatState::RUNNING) { return; }
 
-			if (!scan_fastest(owner_ct, other_ct, pt, e, candidate)) return false;
+		const CombatAiChoice choice = ai.choose(engine);
+		engine.turn(choice.skill_slot, choice.target_pos);
+		sync_gui_snapshot();
+	}
 
-			e.is_negated = true;
+	// --- Internal logic ---
+	// Copies the values that changed since the last sync into the persistent GUI buffers, bumps the version and
+	// emits gui_snapshot_changed with their dirty bits. Does nothing, and emits nothing, if no value changed.
+	void CombatSystem::sync_gui_snapshot() {
+		uint32_t changed = 0;
 
-			return true;
-		};
-		
-		// Finds and applies the fastest intercept passive, allowing it to modify or insert events.
-		auto get_intercept = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, Event& e)->bool {			
-			Intent candidate;
+		for (int team_index = 0; team_index < 2; team_index++) {
+			const CharacterTable<TEAM_SIZE> &ct = engine.get_character_table(team_index);
+			const float *values[GUI_COLUMNS] = { ct.life, ct.life_bar, ct.turn_bar };
 
-			if (!scan_fastest(owner_ct, other_ct, pt, e, candidate)) return false;
+			for (int column = 0; column < GUI_COLUMNS; column++) {
+				const float *shown = gui_columns[team_index][column].ptr();
+				const int    shift = (column * 2 + team_index) * TEAM_SIZE;
 
-			build_passive(candidate);
+				for (int pos = 0; pos < TEAM_SIZE; pos++) {
+					if (values[column][ct.pos_to_index[pos]] != shown[pos]) { changed |= 1u << (shift + pos); }
+				}
+			}
+		}
 
-			return true;
-		};
-		
-		// Collects and applies all reacting passives that respond to this event.
-		auto get_reacts = [&](const CharacterTable<5>& owner_ct, const CharacterTable<5>& other_ct, const PassiveTable<5>& pt, Event& e)->bool {
-			std::array<Intent, 8> candidates;
-			int                   candidates_count = 0;
+		if (changed == 0) { return; }
 
-			if (!scan_all(owner_ct, other_ct, pt, e, candidates, candidates_count)) return false;
-			for (int i = 0; i < candidates_count; i++) { build_passive(candidates[i]); }
+		for (int team_index = 0; team_index < 2; team_index++) {
+			const CharacterTable<TEAM_SIZE> &ct = engine.get_character_table(team_index);
+			const float *values[GUI_COLUMNS] = { ct.life, ct.life_bar, ct.turn_bar };
 
-			return true;
-		};
+			for (int column = 0; column < GUI_COLUMNS; column++) {
+				const int shift = (column * 2 + team_index) * TEAM_SIZE;
+				if (((changed >> shift) & ((1u << TEAM_SIZE) - 1)) == 0) continue;
 
-		int owner_team_index = e.intent.owner_team_index;
+				// Drops the dictionary's reference first, so the write stays in place unless the UI kept the array.
+				godot::PackedFloat32Array &buffer = gui_columns[team_index][column];
+				gui_snapshot[gui_keys[team_index][column]] = godot::Variant();
 
-		const CharacterTable<5>& owner_ct = (owner_team_index == 0) ? ally_character_table     : opponent_character_table;
-		const CharacterTable<5>& other_ct = (owner_team_index == 0) ? opponent_character_table : ally_character_table;
-		const PassiveTable<5>&   other_nt = (owner_team_index == 0) ? opponent_negate_table    : ally_negate_table;
-		const PassiveTable<5>&   other_it = (owner_team_index == 0) ? opponent_intercept_table : ally_intercept_table;
-		const PassiveTable<5>&   other_rt = (owner_team_index == 0) ? opponent_react_table     : ally_react_table;
+				float *shown = buffer.ptrw();
+				for (int pos = 0; pos < TEAM_SIZE; pos++) { shown[pos] = values[column][ct.pos_to_index[pos]]; }
 
-		// Clear per-event reaction queues.
-		fast_event_queue_plus.clear();
-		fast_event_queue.clear();
-		slow_event_queue_plus.clear();
-		slow_event_queue.clear();
+				gui_snapshot[gui_keys[team_index][column]] = buffer;
+			}
+		}
 
-		// Check passives.
-		get_negate   (owner_ct, other_ct, other_nt, e);
-		get_intercept(owner_ct, other_ct, other_it, e);
-		get_reacts   (owner_ct, other_ct, other_rt, e);
+		gui_dirty_mask |= changed;
+		gui_version++;
+		emit_signal("gui_snapshot_changed", gui_version, static_cast<int64_t>(changed));
 	}
 
-	// Resolves all events in per-main-event queues in priority order.
-	void CombatSystem::resolve_events(Event& main_event) {
-		// ROADMAP: for (int i = 0; i < fast_event_queue_plus.count; i++) { resolve_event(fast_event_queue_plus.event[i]); }
-		// ROADMAP: for (int i = 0; i < fast_event_queue.count;      i++) { resolve_event(fast_event_queue.event[i]); }
+	// Sets the CombatAi's search budget per move. Mid-range phones should stay well under a frame (about 6 ms).
+	void CombatSystem::set_ai_budget_ms(int budget_ms) {
+		CombatAiSettings settings = ai.get_settings();
+		settings.time_budget_us   = std::max(1, budget_ms) * 1000;
+		ai.set_settings(settings);
+	}
+
+	// Maps a CreaturePack, which then serves every creature lookup by id; call before any party is set up.
+	// The pack is memory-mapped, so it must be a plain file (user:// or next to the executable), not inside a .pck.
+	bool CombatSystem::load_creature_pack(const godot::String& path) {
+		const godot::String global_path = godot::ProjectSettings::get_singleton()->globalize_path(path);
 
-		resolve_event(main_event);
-		
-		// Consume the active unit's turn bar.
-		CharacterTable<5>& owner_ct = (main_event.intent.owner_team_index == 0) ? ally_character_table : opponent_character_table;
-		owner_ct.turn_bar[main_intent.owner_index] = 0.0f;
+		if (!pipelinepunch::load_creature_pack(global_path.utf8().get_data())) {
+			godot::UtilityFunctions::push_error("load_creature_pack: ", path, ": ", get_creature_pack_error());
+			return false;
+		}
 
-		// ROADMAP: for (int i = 0; i < slow_event_queue_plus.count; i++) { resolve_event(slow_event_queue_plus.event[i]); }
-		// ROADMAP: for (int i = 0; i < slow_event_queue.count;      i++) { resolve_event(slow_event_queue.event[i]); }
+		return true;
 	}
 
-	// Resolves an event.
-	void CombatSystem::resolve_event(Event& e) {
-		if (e.is_negated) { return; }
+	// Gets a creature's name from the loaded CreaturePack, or an empty String if none is loaded or the id is unknown.
+	// The first name read maps the pack's string table.
+	godot::String CombatSystem::get_creature_name(int creature_id) const {
+		const CreaturePack* pack = get_creature_pack();
+		return pack ? godot::String::utf8(pack->get_creature_name(creature_id)) : godot::String();
+	}
 
-		CharacterTable<5>& owner_ct = (e.intent.owner_team_index == 0) ? ally_character_table     : opponent_character_table;
-		CharacterTable<5>& other_ct = (e.intent.owner_team_index == 0) ? opponent_character_table : ally_character_table;
+	// Gets a skill's name, from the loaded CreaturePack if there is one and from the skill library otherwise.
+	godot::String CombatSystem::get_skill_name(int skill_enum) const {
+		if (skill_enum < 0 || skill_enum >= SKILL_LIBRARY_SIZE) { return godot::String(); }
 
-		auto builder = owner_ct.skills[e.intent.owner_index].active_event_builder[e.intent.skill_slot];
-		builder(owner_ct, other_ct, e.intent, &e);
+		const CreaturePack* pack = get_creature_pack();
+		return godot::String::utf8(pack ? pack->get_skill_name(static_cast<SkillEnum>(skill_enum)) : get_skill(static_cast<SkillEnum>(skill_enum)).name);
+	}
 
-		// ROADMAP: get_modifiers(owner_ct, other_ct, &e);
+	// Gets a skill's description, from the loaded CreaturePack if there is one and from the skill library otherwise.
+	godot::String CombatSystem::get_skill_description(int skill_enum) const {
+		if (skill_enum < 0 || skill_enum >= SKILL_LIBRARY_SIZE) { return godot::String(); }
 
-		// Applies damage from the resolved Event into both character tables.
-        // Life values are clamped between 0 and max LP, and life_bar values between 0 and 1.
-		for (int pos = 0; pos < 5; pos++) {
-			int index = other_ct.pos_to_index[pos];
-			if (e.other_pos_damage[pos] > 0) {
-				float life = other_ct.life[index] - e.other_pos_damage[pos];
-				if (life < 0.0f) life = 0.0f;
-				if (life > other_ct.lp[index]) life = other_ct.lp[index];
+		const CreaturePack* pack = get_creature_pack();
+		return godot::String::utf8(pack ? pack->get_skill_description(static_cast<SkillEnum>(skill_enum)) : get_skill(static_cast<SkillEnum>(skill_enum)).description);
+	}
 
-				other_ct.life[index]     = life;
-				other_ct.life_bar[index] = life / other_ct.lp[index];
-			}
-			index = owner_ct.pos_to_index[pos];
-			if (e.owner_pos_damage[pos] > 0) {
-				float life = owner_ct.life[index] - e.owner_pos_damage[pos];
-				if (life < 0.0f) life = 0.0f;
-				if (life > owner_ct.lp[index]) life = owner_ct.lp[index];
-
-				owner_ct.life[index]     = life;
-				owner_ct.life_bar[index] = life / owner_ct.lp[index];
-			}
-		}
+	// --- Godot Bindings ---
+	// Binds C++ methods with Godot Engine.
+	void CombatSystem::_bind_methods() {
+		godot::ClassDB::bind_method(godot::D_METHOD("setup_from_parties"), &CombatSystem::setup_from_parties);
+		godot::ClassDB::bind_method(godot::D_METHOD("roll_initiative"), &CombatSystem::roll_initiative);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_creature_ids"), &CombatSystem::get_creature_ids);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_gui_snapshot"), &CombatSystem::get_gui_snapshot);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_gui_version"), &CombatSystem::get_gui_version);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_gui_dirty_mask"), &CombatSystem::get_gui_dirty_mask);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_current_turn_owner"), &CombatSystem::get_current_turn_owner);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_turn_order_forecast", "count"), &CombatSystem::get_turn_order_forecast);
+		godot::ClassDB::bind_method(godot::D_METHOD("turn", "skill_slot", "target_pos"), &CombatSystem::turn);
+		godot::ClassDB::bind_method(godot::D_METHOD("set_seed", "seed"), &CombatSystem::set_seed);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_seed"), &CombatSystem::get_seed);
+		godot::ClassDB::bind_method(godot::D_METHOD("flush_journal", "path"), &CombatSystem::flush_journal);
+		godot::ClassDB::bind_method(godot::D_METHOD("seek_to_turn", "turn"), &CombatSystem::seek_to_turn);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_trace_counters"), &CombatSystem::get_trace_counters);
+		godot::ClassDB::bind_method(godot::D_METHOD("export_trace", "path"), &CombatSystem::export_trace);
+		godot::ClassDB::bind_method(godot::D_METHOD("choose_ai_turn"), &CombatSystem::choose_ai_turn);
+		godot::ClassDB::bind_method(godot::D_METHOD("ai_turn"), &CombatSystem::ai_turn);
+		godot::ClassDB::bind_method(godot::D_METHOD("set_ai_budget_ms", "budget_ms"), &CombatSystem::set_ai_budget_ms);
+		godot::ClassDB::bind_method(godot::D_METHOD("load_creature_pack", "path"), &CombatSystem::load_creature_pack);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_creature_name", "creature_id"), &CombatSystem::get_creature_name);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_skill_name", "skill_enum"), &CombatSystem::get_skill_name);
+		godot::ClassDB::bind_method(godot::D_METHOD("get_skill_description", "skill_enum"), &CombatSystem::get_skill_description);
+
+		ADD_SIGNAL(godot::MethodInfo("gui_snapshot_changed",
+			godot::PropertyInfo(godot::Variant::INT, "version"),
+			godot::PropertyInfo(godot::Variant::INT, "dirty_mask")));
 	}
 }
\ No newline at end of file
@@ -3,22 +3,32 @@
 // CombatSystem
 // ------------
 // The CombatSystem owns the combat functionality for a 5v5 battle.
-// - Holds Struct-of-Arrays character tables for both sides, which allow efficient processing
-//   of more complex events than in many similar games.
-// - Builds event queues and resolves events and reactions based on a tiered priority system.
-// - Handles current actor states and advances an ATB-style turn bar to select the next actor.
+// - Reads both parties from the Character and Party inventories.
+// - Delegates all combat logic to a Godot-free CombatEngine, which holds Struct-of-Arrays
+//   character tables for both sides, builds and resolves tiered event queues and advances
+//   an ATB-style turn bar to select the next actor.
+// - Each node owns its own engine, so any number of battles can be live at once.
+// - Journals every battle into an in-memory CombatJournal that can be flushed to disk and seeked for replays.
+// - In PIPELINEPUNCH_TRACE builds, traces every battle's turn phases into a CombatTrace whose counters the UI can
+//   read and whose spans export to a Chrome trace file.
+// - Plays AI-controlled turns with a CombatAi whose per-move search budget keeps a move within a frame.
+// - Keeps the GUI snapshot in persistent packed buffers, updated only where values changed, with a version,
+//   a dirty mask and a gui_snapshot_changed signal so the UI never has to poll per frame.
+// - Maps a CreaturePack on request and serves its names to the UI, so its string table is only paged in when shown.
 // - Exposes a minimal API for the Godot UI.
 
-#include <array>
-
+#include <cstdint>
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/string.hpp>
 
-#include "pipelinepunch/systems/combat_system/enums/combat_state.h"
-#include "pipelinepunch/systems/combat_system/structs/character_table.h"
-#include "pipelinepunch/systems/combat_system/structs/event.h"
-#include "pipelinepunch/systems/combat_system/structs/event_queue.h"
-#include "pipelinepunch/systems/combat_system/structs/intent.h"
-#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
+#include "pipelinepunch/systems/combat_system/combat_ai.h"
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_journal.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_trace.h"
 
 namespace pipelinepunch {
     
@@ -27,69 +37,60 @@ namespace pipelinepunch {
         GDCLASS(CombatSystem, godot::Node)
 
     public:
-        // --- Singleton Access ---
-        CombatSystem();                      // Defines the CombatSystem instance.
-        static CombatSystem* get_instance(); // Gets the CombatSystem instance.
+        static constexpr int TEAM_SIZE               = Config5v5::TEAM_SIZE; // Party slots per side.
+        static constexpr int MAX_TURN_ORDER_FORECAST = 32;                   // Longest turn-order preview served to the UI.
+        static constexpr int GUI_COLUMNS             = 3;                    // Per-unit GUI columns: life, life_bar, turn_bar.
+
+        static_assert(GUI_COLUMNS * 2 * TEAM_SIZE <= 32, "GUI dirty bits must fit in a uint32_t.");
+
+        CombatSystem();
 
         // --- Godot Entry Points ---
         void setup_from_parties(int ally_arena_id,        // Registers parties in the combat system.
                                 int opponent_arena_id);
         void roll_initiative();                           // Initialises life and turn bars, then selects the first actor.
-        void turn(int skill_slot, int target_pos);        // Handles a single player-controlled turn: choose skill/target, resolve, then advance to the next actor.
+        bool turn(int skill_slot, int target_pos);        // Handles a single player-controlled turn: choose skill/target, resolve, then advance to the next actor.
         godot::Dictionary get_creature_ids() const;       // Gets all creature_ids for the GUI.
-        godot::Dictionary get_gui_snapshot() const;       // Gets a snapshot of all combat-relevant values needed by the UI.
+        godot::Dictionary get_gui_snapshot();             // Gets a snapshot of all combat-relevant values needed by the UI, clearing the dirty mask.
+        int64_t get_gui_version() const;                  // Gets the version of the GUI snapshot, incremented on every change.
+        int64_t get_gui_dirty_mask() const;               // Gets the unit values changed since the last get_gui_snapshot, one bit each.
         godot::Dictionary get_current_turn_owner() const; // Gets turn owners team index and position.
-        
-        // --- Event pushing ---
-        // ROADMAP: To be made private.
-        void push_fast_event_plus(const Event& e); // Pushes an event to the fast_event_queue_plus.
-        void push_fast_event(const Event& e);      // Pushes an event to the fast_event_queue.
-        void push_main_event(const Event& e);      // Pushes an event to the main_event_queue.
-        void push_slow_event_plus(const Event& e); // Pushes an event to the slow_event_queue_plus.
-        void push_slow_event(const Event& e);      // Pushes an event to the slow_event_queue.
+        godot::Array get_turn_order_forecast(int count) const; // Gets up to count upcoming actors after the current one, for the turn-order strip.
+        void set_seed(int64_t seed);                      // Sets the seed used by the next roll_initiative, for reproducible battles.
+        int64_t get_seed() const;                         // Gets the seed of the current battle, for replays.
+        bool flush_journal(const godot::String& path);    // Appends the journal entries recorded since the last flush to a file.
+        bool seek_to_turn(int turn);                      // Restores the battle at a journaled turn, for the replay viewer.
+        godot::Dictionary get_trace_counters() const;     // Gets the current battle's trace counters (all zero unless built with PIPELINEPUNCH_TRACE).
+        bool export_trace(const godot::String& path);     // Writes the current battle's trace as Chrome trace event JSON.
+        godot::Dictionary choose_ai_turn();               // Gets the CombatAi's skill slot and target position for the current actor.
+        void ai_turn();                                   // Handles a single AI-controlled turn for the current actor.
+        void set_ai_budget_ms(int budget_ms);             // Sets the CombatAi's search budget per move.
+        bool load_creature_pack(const godot::String& path); // Maps a CreaturePack in place of the static creature library.
+        godot::String get_creature_name(int creature_id) const; // Gets a creature's name from the loaded CreaturePack.
+        godot::String get_skill_name(int skill_enum) const; // Gets a skill's name.
+        godot::String get_skill_description(int skill_enum) const; // Gets a skill's description.
 
     protected:
         static void _bind_methods(); // Binds C++ methods with Godot Engine.
 
     private:
-        inline static CombatSystem* instance = nullptr; // Singleton.
-
-        // --- Runtime CombatState ---
-        CombatState combat_state { CombatState::IDLE };
-
-        // --- Runtime Character Tables ---
-        CharacterTable<5> ally_character_table;
-        CharacterTable<5> opponent_character_table;
-
-        // --- Runtime Passive Tables ---
-        PassiveTable<5> ally_negate_table;
-        PassiveTable<5> ally_intercept_table;
-        PassiveTable<5> ally_react_table;
-        PassiveTable<5> ally_modify_table;
-        PassiveTable<5> opponent_negate_table;
-        PassiveTable<5> opponent_intercept_table;
-        PassiveTable<5> opponent_react_table;
-        PassiveTable<5> opponent_modify_table;
-
-        // --- Runtime Event Queues ---
-        EventQueue<4>  fast_event_queue_plus;
-        EventQueue<16> fast_event_queue;
-        EventQueue<4>  main_event_queue;
-        EventQueue<4>  slow_event_queue_plus;
-        EventQueue<16> slow_event_queue;
+        // --- Runtime Combat Engine ---
+        CombatEngine<Config5v5>   engine;
+        CombatJournal<TEAM_SIZE>  journal;               // Records every battle from roll_initiative on.
+        CombatTrace               trace;                 // Times every battle's turn phases, in PIPELINEPUNCH_TRACE builds.
+        CombatAi<Config5v5>       ai;                    // Chooses moves for AI-controlled turns.
 
-        // --- Runtime Intents ---
-        Intent main_intent;
-        Intent negate_intent;
-        Intent intercept_intent;
+        // --- Runtime GUI Snapshot (persistent buffers, by team index and column) ---
+        godot::PackedFloat32Array gui_columns[2][GUI_COLUMNS];
+        godot::String             gui_keys[2][GUI_COLUMNS];
+        godot::Dictionary         gui_snapshot;          // Holds gui_columns under their GUI keys.
+        uint32_t                  gui_dirty_mask { 0 };  // Values changed since the last get_gui_snapshot.
+        int64_t                   gui_version { 0 };
+        godot::PackedInt32Array   creature_ids[2];
+        godot::Dictionary         creature_ids_snapshot; // Holds creature_ids, refreshed by setup_from_parties.
 
         // --- Internal logic ---
-        void   start_combat();                               // Sets CombatState to RUNNING
-        void   stop_combat();                                // Sets CombatState to ENDED
-        Intent get_next_character(Intent& intent);           // Gets the next character.
-        void   build_main_event_queue(const Intent& intent); // Builds the main_event_queue from the active actor's chosen intent.
-        void   get_passives(Event& e);                       // Gets relevant passives that trigger from the current main event.
-        void   resolve_events(Event& main_event);            // Resolves all events in per-main-event queues in priority order.
-        void   resolve_event(Event& e);                      // Resolves an event.
+        void sync_gui_snapshot(); // Copies changed values into the GUI buffers and signals the change.
+        bool                      seed_is_set { false }; // Whether set_seed was called since the last roll_initiative.
     };
 }
\ No newline at end of file
@@ -0,0 +1,210 @@
+#pragma once
+
+// CombatTrace
+// -----------
+// Per-battle profile of the CombatEngine's turn phases, for finding where the time goes inside turn() on device.
+// - Compiled in only when PIPELINEPUNCH_TRACE is defined. Without it the engine's trace points expand to nothing,
+//   so release builds pay no branch, and a CombatTrace attached to an engine stays empty.
+// - Each traced phase (the whole turn, the intent build, a passive lookup, an event resolved from each cascade tier
+//   and a scheduler advance) becomes a TraceSpan in a fixed-size ring. Recording is a clock read and a copy into
+//   the next slot and never allocates; once the ring wraps, its oldest spans are overwritten.
+// - TraceCounters keep battle totals that do not wrap: events per turn, queue high-water marks, the passives each
+//   lookup scanned and the conditions it called.
+// - write_chrome_trace() exports the held spans and the counters as Chrome trace event JSON, which
+//   chrome://tracing and ui.perfetto.dev open directly. Phases nest, so a turn shows its phases below it.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace pipelinepunch {
+
+#if defined(PIPELINEPUNCH_TRACE)
+    constexpr bool COMBAT_TRACE_ENABLED = true;
+#else
+    constexpr bool COMBAT_TRACE_ENABLED = false;
+#endif
+
+    // Represents a traced phase of a turn.
+    enum class TracePhase : uint8_t {
+        TURN,              // A whole turn(), from the intent to the next actor.
+        BUILD_INTENT,      // build_main_event_queue: phase 1 of the actor's skill.
+        PASSIVE_LOOKUP,    // get_passives for one event.
+        RESOLVE_FAST_PLUS, // An event resolved from fast_event_queue_plus, its passive lookup included.
+        RESOLVE_FAST,      // An event resolved from fast_event_queue.
+        RESOLVE_MAIN,      // The main event.
+        RESOLVE_SLOW_PLUS, // An event resolved from slow_event_queue_plus.
+        RESOLVE_SLOW,      // An event resolved from slow_event_queue.
+        SCHEDULER_ADVANCE, // get_next_character: the AtbScheduler picking the next actor.
+        COUNT
+    };
+
+    // Names of the TracePhases, as shown in the trace viewer.
+    constexpr const char* TRACE_PHASE_NAMES[static_cast<int>(TracePhase::COUNT)] = {
+        "turn", "build_intent", "passive_lookup", "resolve_fast_plus", "resolve_fast", "resolve_main",
+        "resolve_slow_plus", "resolve_slow", "scheduler_advance"
+    };
+
+    // Represents the queues whose high-water marks are kept, in resolution order.
+    enum class TraceQueue : uint8_t {
+        MAIN,
+        FAST_PLUS,
+        FAST,
+        SLOW_PLUS,
+        SLOW,
+        COUNT
+    };
+
+    // Represents one timed phase.
+    struct TraceSpan {
+        uint64_t   start_ns;    // Since the battle's roll_initiative.
+        uint32_t   duration_ns;
+        uint32_t   turn;        // Turn count when the phase started.
+        TracePhase phase;
+        uint8_t    depth;       // Cascade depth of the event, for lookups and resolves.
+        uint8_t    reserved[6];
+    };
+
+    // Represents the counters of one battle.
+    struct TraceCounters {
+        uint64_t turns { 0 };
+        uint64_t events_resolved { 0 };    // Main events and reactions resolved.
+        uint32_t max_events_per_turn { 0 };
+        uint32_t queue_high_water[static_cast<int>(TraceQueue::COUNT)] {}; // Most events a queue held at once, by TraceQueue.
+        uint64_t passive_lookups { 0 };
+        uint64_t passives_scanned { 0 };   // Live passives in the tables each lookup consulted; a linear scan would test them all.
+        uint64_t condition_calls { 0 };    // Passives the trigger index matched, whose condition then ran.
+    };
+
+    // Represents the trace of one battle.
+    struct CombatTrace {
+        static constexpr int SPANS = 4096;
+        static_assert((SPANS & (SPANS - 1)) == 0, "The span ring capacity must be a power of two.");
+
+        uint64_t      seed { 0 };
+        uint64_t      origin_ns { 0 };   // Clock at begin(); spans are stored relative to it.
+        uint64_t      span_count { 0 };  // Spans written since begin(), including overwritten ones.
+        uint32_t      turn_events { 0 }; // Events resolved in the current turn.
+        TraceCounters counters;
+        TraceSpan     spans[SPANS];
+
+        // Gets the clock, in nanoseconds.
+        static uint64_t now_ns() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Gets the number of set bits of a mask.
+        static uint32_t count_bits(uint32_t bits) {
+        #if defined(__GNUC__) || defined(__clang__)
+            return static_cast<uint32_t>(__builtin_popcount(bits));
+        #else
+            uint32_t count = 0;
+            for (; bits; bits &= bits - 1) { count++; }
+            return count;
+        #endif
+        }
+
+        // --- Recording ---
+        // Starts the trace of a new battle, dropping everything recorded before.
+        void begin(uint64_t battle_seed) {
+            seed        = battle_seed;
+            origin_ns   = now_ns();
+            span_count  = 0;
+            turn_events = 0;
+            counters    = TraceCounters{};
+        }
+
+        // Records a phase that ran from start_ns to end_ns.
+        void record(TracePhase phase, uint64_t start_ns, uint64_t end_ns, uint32_t turn, uint8_t depth) {
+            TraceSpan& s  = spans[span_count++ & (SPANS - 1)];
+            s.start_ns    = start_ns - origin_ns;
+            s.duration_ns = static_cast<uint32_t>(end_ns - start_ns);
+            s.turn        = turn;
+            s.phase       = phase;
+            s.depth       = depth;
+        }
+
+        // Counts a resolved event towards the current turn.
+        void count_event() {
+            counters.events_resolved++;
+            turn_events++;
+        }
+
+        // Raises a queue's high-water mark to its current count.
+        void note_queue(TraceQueue queue, int count) {
+            uint32_t& mark = counters.queue_high_water[static_cast<int>(queue)];
+            if (static_cast<uint32_t>(count) > mark) { mark = static_cast<uint32_t>(count); }
+        }
+
+        // Closes the current turn's event count.
+        void end_turn() {
+            counters.turns++;
+            if (turn_events > counters.max_events_per_turn) { counters.max_events_per_turn = turn_events; }
+            turn_events = 0;
+        }
+
+        // --- Queries ---
+        // Gets the sequence number of the oldest span still held.
+        uint64_t first_span() const { return (span_count > SPANS) ? span_count - SPANS : 0; }
+
+        // Gets a span by sequence number; it must lie in [first_span(), span_count).
+        const TraceSpan& span(uint64_t sequence) const { return spans[sequence & (SPANS - 1)]; }
+
+        // --- Export ---
+        // Writes the held spans as complete ("X") events and the counters as a counter ("C") event, in Chrome
+        // trace event JSON, to a file opened for writing. Returns false on a write error.
+        bool write_chrome_trace(std::FILE* file) const {
+            std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"seed\":\"%llu\",\"spans_lost\":%llu},\"traceEvents\":[\n",
+                static_cast<unsigned long long>(seed), static_cast<unsigned long long>(first_span()));
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"combat\"}}");
+
+            uint64_t last_us_ns = 0;
+            for (uint64_t sequence = first_span(); sequence < span_count; sequence++) {
+                const TraceSpan& s = span(sequence);
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"combat\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"turn\":%u,\"depth\":%u}}",
+                    TRACE_PHASE_NAMES[static_cast<int>(s.phase)], s.start_ns / 1000.0, s.duration_ns / 1000.0, s.turn, static_cast<unsigned>(s.depth));
+                if (s.start_ns + s.duration_ns > last_us_ns) { last_us_ns = s.start_ns + s.duration_ns; }
+            }
+
+            const TraceCounters& c = counters;
+            std::fprintf(file, ",\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{"
+                "\"turns\":%llu,\"events_resolved\":%llu,\"max_events_per_turn\":%u,"
+                "\"main_high_water\":%u,\"fast_plus_high_water\":%u,\"fast_high_water\":%u,\"slow_plus_high_water\":%u,\"slow_high_water\":%u,"
+                "\"passive_lookups\":%llu,\"passives_scanned\":%llu,\"condition_calls\":%llu}}\n]}\n",
+                last_us_ns / 1000.0, static_cast<unsigned long long>(c.turns), static_cast<unsigned long long>(c.events_resolved), c.max_events_per_turn,
+                c.queue_high_water[0], c.queue_high_water[1], c.queue_high_water[2], c.queue_high_water[3], c.queue_high_water[4],
+                static_cast<unsigned long long>(c.passive_lookups), static_cast<unsigned long long>(c.passives_scanned), static_cast<unsigned long long>(c.condition_calls));
+
+            return std::ferror(file) == 0 && std::fflush(file) == 0;
+        }
+    };
+
+    // Represents a phase being timed: records a span into a trace, if there is one, when it goes out of scope.
+    class TraceScope {
+    public:
+        TraceScope(CombatTrace* trace, TracePhase phase, int turn, int depth)
+            : trace(trace), start_ns(trace ? CombatTrace::now_ns() : 0), turn(static_cast<uint32_t>(turn)), phase(phase), depth(static_cast<uint8_t>(depth)) {}
+        ~TraceScope() { if (trace) { trace->record(phase, start_ns, CombatTrace::now_ns(), turn, depth); } }
+
+        TraceScope(const TraceScope&)            = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        CombatTrace* trace;
+        uint64_t     start_ns;
+        uint32_t     turn;
+        TracePhase   phase;
+        uint8_t      depth;
+    };
+}
+
+// Trace points of the CombatEngine. Both expand to nothing unless PIPELINEPUNCH_TRACE is defined.
+// - PIPELINEPUNCH_TRACE_SCOPE(name, trace, phase, turn, depth) times the rest of the enclosing block as a span.
+// - PIPELINEPUNCH_TRACE_CALL(trace, call) runs trace->call when a trace is attached.
+#if defined(PIPELINEPUNCH_TRACE)
+    #define PIPELINEPUNCH_TRACE_SCOPE(name, trace, phase, turn, depth) ::pipelinepunch::TraceScope name((trace), (phase), (turn), (depth))
+    #define PIPELINEPUNCH_TRACE_CALL(trace, call) do { if (trace) { (trace)->call; } } while (false)
+#else
+    #define PIPELINEPUNCH_TRACE_SCOPE(name, trace, phase, turn, depth) ((void)0)
+    #define PIPELINEPUNCH_TRACE_CALL(trace, call) ((void)0)
+#endif
\ No newline at end of file
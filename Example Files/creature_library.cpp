@@ -13,8 +13,8 @@ namespace pipelinepunch {
     // Gets a pointer to the static creature library array.
     const CreatureSheet* get_creature_library() {
 
-        // Represents the library of all creatures as a static array.
-        static CreatureSheet creature_library[CREATURE_LIBRARY_SIZE] = {
+        // Represents the library of all creatures as a static, read-only array.
+        static const CreatureSheet creature_library[CREATURE_LIBRARY_SIZE] = {
             CreatureSheet(0, "Bat",      TypeEnum::MONSTER, {1000, 100, 100, 100, 100, 180}, SkillEnum::DEMO_ATTACK, SkillEnum::DEMO_CLEAVE),
             CreatureSheet(1, "Skeleton", TypeEnum::UNDEAD,  {1200, 120, 100, 100, 100, 140}, SkillEnum::DEMO_ATTACK, SkillEnum::DEMO_CLEAVE),
             CreatureSheet(2, "Orc",      TypeEnum::MONSTER, {1400, 140, 100, 100, 100, 100}, SkillEnum::DEMO_ATTACK, SkillEnum::DEMO_CLEAVE)
@@ -22,4 +22,29 @@ namespace pipelinepunch {
 
         return creature_library;
     }
+
+    // Represents the loaded creature pack; closed until load_creature_pack succeeds.
+    static CreaturePack creature_pack;
+
+    // Maps a CreaturePack, which then serves every lookup by id in place of the static array.
+    // Returns false, falling back to the static array, if the pack cannot be opened.
+    bool load_creature_pack(const char* path) { return creature_pack.open(path); }
+
+    // Gets why the last load_creature_pack failed, or "" if it succeeded.
+    const char* get_creature_pack_error() { return creature_pack.get_error(); }
+
+    // Gets the loaded CreaturePack, or nullptr if none is loaded.
+    const CreaturePack* get_creature_pack() { return creature_pack.is_open() ? &creature_pack : nullptr; }
+
+    // Gets the number of creature ids, from the pack if one is loaded.
+    int get_creature_count() { return creature_pack.is_open() ? creature_pack.creature_count() : CREATURE_LIBRARY_SIZE; }
+
+    // Gets a creature's CreatureSheet by id, from the pack if one is loaded. Returns false for an unknown id.
+    bool get_creature_sheet(int creature_id, CreatureSheet& sheet) {
+        if (creature_pack.is_open()) return creature_pack.get_creature_sheet(creature_id, sheet);
+        if (creature_id < 0 || creature_id >= CREATURE_LIBRARY_SIZE) return false;
+
+        sheet = get_creature_library()[creature_id];
+        return true;
+    }
 }
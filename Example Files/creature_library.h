@@ -4,7 +4,9 @@
 // ----------------
 // Provides read-only access to the array of all base CreatureSheet entries.
 // The library is static and allocated once.
+// A CreaturePack loaded at startup replaces the array for lookups by id; see creature_pack.h.
 
+#include "pipelinepunch/data/libraries/creature_pack.h"
 #include "pipelinepunch/utils/structs/creature_sheet.h"
 
 namespace pipelinepunch {
@@ -12,4 +14,10 @@ namespace pipelinepunch {
 	constexpr int CREATURE_LIBRARY_SIZE = 3;
 
     const CreatureSheet* get_creature_library(); // Gets a pointer to the static creature library array.
+
+    bool                load_creature_pack(const char* path);                       // Maps a CreaturePack in place of the static array; call before any battle is set up.
+    const char*         get_creature_pack_error();                                  // Gets why the last load_creature_pack failed.
+    const CreaturePack* get_creature_pack();                                        // Gets the loaded CreaturePack, or nullptr.
+    int                 get_creature_count();                                       // Gets the number of creature ids, from the pack if one is loaded.
+    bool                get_creature_sheet(int creature_id, CreatureSheet& sheet); // Gets a creature's CreatureSheet by id, from the pack if one is loaded.
 }
\ No newline at end of file
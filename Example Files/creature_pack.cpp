@@ -0,0 +1,356 @@
+// CreaturePack
+// ------------
+// Maps packs written by write_creature_pack and serves lookups straight from the mapping.
+// - open() maps the header and records only, and validates the layout and the record checksum.
+// - The string table gets its own mapping on the first string read, is checked once, then strings are returned
+//   in place; until then none of its pages are mapped.
+// - Mapping uses mmap on POSIX systems (Linux, Android, macOS, iOS) and a file mapping on Windows.
+
+#include "creature_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "pipelinepunch/data/libraries/skill_library.h"
+
+namespace pipelinepunch {
+
+    static_assert(sizeof(CreaturePackHeader) == 80, "CreaturePackHeader layout changed; bump CreaturePackHeader::VERSION.");
+    static_assert(sizeof(CreaturePackCreature) == 40, "CreaturePackCreature layout changed; bump CreaturePackHeader::VERSION.");
+    static_assert(sizeof(CreaturePackSkill) == 12, "CreaturePackSkill layout changed; bump CreaturePackHeader::VERSION.");
+
+    // Gets the checksum of a pack section: FNV-1a over native 8-byte words, then over any trailing bytes. Folding
+    // words rather than bytes keeps checking the records of a large pack well under a millisecond.
+    static uint64_t pack_checksum(const uint8_t* bytes, size_t count) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= count; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            hash ^= word;
+            hash *= 0x100000001B3ull;
+        }
+        for (; i < count; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+
+        return hash;
+    }
+
+    // --- Mapping ---
+    // Maps [offset, offset + count) of a file read-only. Returns a pointer to offset, with the whole view (which
+    // starts at the mapping granularity boundary below offset) in view and view_size, or nullptr on failure.
+    static const uint8_t* map_range(intptr_t file, uint64_t offset, size_t count, const void*& view, size_t& view_size) {
+#if defined(_WIN32)
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        const uint64_t start = offset / system_info.dwAllocationGranularity * system_info.dwAllocationGranularity;
+
+        view_size = static_cast<size_t>(offset - start) + count;
+        view      = MapViewOfFile(reinterpret_cast<HANDLE>(file), FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start), view_size);
+        if (!view) return nullptr;
+#else
+        const uint64_t page  = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        const uint64_t start = offset / page * page;
+
+        view_size = static_cast<size_t>(offset - start) + count;
+        void* mapped = mmap(nullptr, view_size, PROT_READ, MAP_PRIVATE, static_cast<int>(file), static_cast<off_t>(start));
+        if (mapped == MAP_FAILED) return nullptr;
+        view = mapped;
+#endif
+        return static_cast<const uint8_t*>(view) + (offset - start);
+    }
+
+    // Unmaps a view returned by map_range.
+    static void unmap_range(const void* view, size_t view_size) {
+#if defined(_WIN32)
+        UnmapViewOfFile(view);
+#else
+        munmap(const_cast<void*>(view), view_size);
+#endif
+    }
+
+    CreaturePack::~CreaturePack() { close(); }
+
+    // Maps the header and records of a pack, checks its layout and record checksum, and keeps the file open so the
+    // string table can be mapped on first use. Returns false, with the pack closed and the reason in get_error(),
+    // if the file is missing, truncated, corrupt or written for another layout.
+    bool CreaturePack::open(const char* path) {
+        close();
+        error[0] = '\0';
+
+        uint64_t file_size = 0;
+#if defined(_WIN32)
+        HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return fail("cannot open file");
+
+        LARGE_INTEGER size_on_disk;
+        const bool sized = GetFileSizeEx(handle, &size_on_disk) != 0;
+        HANDLE     map   = sized ? CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(handle);
+        if (!map) return fail("cannot map file");
+
+        file      = reinterpret_cast<intptr_t>(map);
+        file_size = static_cast<uint64_t>(size_on_disk.QuadPart);
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return fail("cannot open file");
+
+        file = fd;
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) return fail("cannot open file");
+        file_size = static_cast<uint64_t>(file_stat.st_size);
+#endif
+        if (file_size < sizeof(CreaturePackHeader)) return fail("file too small");
+
+        // Reads the header through a small view first; the records view is sized from it.
+        const void* view      = nullptr;
+        size_t      view_size = 0;
+        const uint8_t* header_bytes = map_range(file, 0, sizeof(CreaturePackHeader), view, view_size);
+        if (!header_bytes) return fail("cannot map file");
+
+        CreaturePackHeader h;
+        std::memcpy(&h, header_bytes, sizeof(h));
+        unmap_range(view, view_size);
+
+        if (h.magic != CreaturePackHeader::MAGIC)                                        return fail("not a creature pack");
+        if (h.version != CreaturePackHeader::VERSION)                                    return fail("unsupported pack version");
+        if (h.endianness != CreaturePackHeader::ENDIANNESS)                              return fail("pack written with another endianness");
+        if (h.header_size != sizeof(CreaturePackHeader) || h.creature_size != sizeof(CreaturePackCreature)
+            || h.skill_size != sizeof(CreaturePackSkill))                                return fail("pack written with another record layout");
+
+        // Sections must be aligned for their records, in order and inside the file.
+        const uint64_t creatures_end = h.creatures_offset + uint64_t(h.creature_count) * h.creature_size;
+        const uint64_t skills_end    = h.skills_offset + uint64_t(h.skill_count) * h.skill_size;
+        if (h.creatures_offset < h.header_size || h.creatures_offset % alignof(CreaturePackCreature) != 0
+            || h.skills_offset < creatures_end || h.skills_offset % alignof(CreaturePackSkill) != 0
+            || h.strings_offset < skills_end || h.strings_size == 0
+            || h.strings_offset > file_size || h.strings_size > file_size - h.strings_offset) return fail("pack sections out of bounds");
+
+        data = map_range(file, 0, static_cast<size_t>(h.strings_offset), view, view_size);
+        if (!data) return fail("cannot map file");
+        size = view_size;
+
+        if (pack_checksum(data + h.header_size, h.strings_offset - h.header_size) != h.records_checksum) return fail("record checksum mismatch");
+
+        return true;
+    }
+
+    // Unmaps the pack and closes its file. Must not run while other threads read the pack.
+    void CreaturePack::close() {
+        if (data)         { unmap_range(data, size); }
+        if (strings_view) { unmap_range(strings_view, strings_view_size); }
+
+        if (file != -1) {
+#if defined(_WIN32)
+            CloseHandle(reinterpret_cast<HANDLE>(file));
+#else
+            ::close(static_cast<int>(file));
+#endif
+        }
+
+        data              = nullptr;
+        size              = 0;
+        file              = -1;
+        strings_view      = nullptr;
+        strings_view_size = 0;
+        strings_failed    = false;
+        strings.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Records an error and closes the pack.
+    bool CreaturePack::fail(const char* message) {
+        close();
+        std::snprintf(error, sizeof(error), "%s", message);
+        return false;
+    }
+
+    // --- Lookups ---
+    // Gets a creature's record in O(1), or nullptr if the pack has no creature with that id.
+    const CreaturePackCreature* CreaturePack::find_creature(int creature_id) const {
+        if (creature_id < 0 || creature_id >= creature_count()) return nullptr;
+
+        const CreaturePackCreature* creatures = reinterpret_cast<const CreaturePackCreature*>(data + get_header().creatures_offset);
+        const CreaturePackCreature& creature  = creatures[creature_id];
+        return (creature.creature_id == creature_id) ? &creature : nullptr;
+    }
+
+    // Builds a creature's CreatureSheet. Its name is left empty so battle setup never pages the string table in;
+    // get_creature_name reads it.
+    bool CreaturePack::get_creature_sheet(int creature_id, CreatureSheet& sheet) const {
+        static_assert(SKILL_SLOTS == 2, "CreatureSheet takes one SkillEnum per skill slot.");
+
+        const CreaturePackCreature* creature = find_creature(creature_id);
+        if (!creature) return false;
+
+        const int32_t* s = creature->stats;
+        sheet = CreatureSheet(creature_id, "", static_cast<TypeEnum>(creature->type), { s[0], s[1], s[2], s[3], s[4], s[5] },
+                              static_cast<SkillEnum>(creature->skill_enum[0]), static_cast<SkillEnum>(creature->skill_enum[1]));
+        return true;
+    }
+
+    // Gets a creature's name, or "" if the pack has no creature with that id.
+    const char* CreaturePack::get_creature_name(int creature_id) const {
+        const CreaturePackCreature* creature = find_creature(creature_id);
+        return creature ? get_string(creature->name) : "";
+    }
+
+    // Gets a skill's name, or "" if the pack has no record for it.
+    const char* CreaturePack::get_skill_name(SkillEnum skill_enum) const {
+        const uint32_t index = static_cast<uint32_t>(skill_enum);
+        if (!is_open() || index >= get_header().skill_count) return "";
+        return get_string(reinterpret_cast<const CreaturePackSkill*>(data + get_header().skills_offset)[index].name);
+    }
+
+    // Gets a skill's description, or "" if the pack has no record for it.
+    const char* CreaturePack::get_skill_description(SkillEnum skill_enum) const {
+        const uint32_t index = static_cast<uint32_t>(skill_enum);
+        if (!is_open() || index >= get_header().skill_count) return "";
+        return get_string(reinterpret_cast<const CreaturePackSkill*>(data + get_header().skills_offset)[index].description);
+    }
+
+    // Gets a string of the table, or "" if the offset or the table is invalid.
+    const char* CreaturePack::get_string(uint32_t offset) const {
+        const char* table = strings.load(std::memory_order_acquire);
+        if (!table) { table = map_strings(); }
+
+        return (table && offset < get_header().strings_size) ? table + offset : "";
+    }
+
+    // Maps the string table and checks its checksum and termination, once; later calls return the same table.
+    // Returns nullptr if the table cannot be mapped or is corrupt.
+    const char* CreaturePack::map_strings() const {
+        std::lock_guard<std::mutex> lock(strings_mutex);
+
+        if (const char* table = strings.load(std::memory_order_relaxed)) return table;
+        if (strings_failed) return nullptr;
+
+        const CreaturePackHeader& h     = get_header();
+        const uint8_t*            table = map_range(file, h.strings_offset, static_cast<size_t>(h.strings_size), strings_view, strings_view_size);
+
+        if (!table || table[h.strings_size - 1] != '\0' || pack_checksum(table, h.strings_size) != h.strings_checksum) {
+            if (table) { unmap_range(strings_view, strings_view_size); }
+            strings_view      = nullptr;
+            strings_view_size = 0;
+            strings_failed    = true;
+            return nullptr;
+        }
+
+        strings.store(reinterpret_cast<const char*>(table), std::memory_order_release);
+        return reinterpret_cast<const char*>(table);
+    }
+
+    // --- Writing ---
+    // Represents a growing string table; offset 0 holds the empty string.
+    struct CreaturePackStrings {
+        std::string table { std::string(1, '\0') };
+
+        // Appends a string, returning its offset.
+        uint32_t add(const char* text) {
+            if (!text || !*text) return 0;
+
+            const uint32_t offset = static_cast<uint32_t>(table.size());
+            table.append(text);
+            table.push_back('\0');
+            return offset;
+        }
+    };
+
+    // Writes a pack of creatures and of every skill library entry's strings to a file opened for binary writing.
+    // Returns false if an id is negative or repeated, a value does not fit its record, or a write fails.
+    bool write_creature_pack(std::FILE* file, const CreaturePackSource* creatures, int count) {
+        int creature_count = 0;
+        for (int i = 0; i < count; i++) {
+            if (creatures[i].creature_id < 0) return false;
+            creature_count = std::max(creature_count, creatures[i].creature_id + 1);
+        }
+
+        CreaturePackStrings strings;
+
+        // Creature records, indexed by id; ids with no creature stay holes.
+        std::vector<CreaturePackCreature> creature_records(static_cast<size_t>(creature_count));
+        for (CreaturePackCreature& record : creature_records) {
+            record = CreaturePackCreature{};
+            record.creature_id = -1;
+        }
+
+        for (int i = 0; i < count; i++) {
+            const CreaturePackSource& source = creatures[i];
+            CreaturePackCreature&     record = creature_records[static_cast<size_t>(source.creature_id)];
+            if (record.creature_id != -1) return false;
+
+            record.creature_id = source.creature_id;
+            record.name        = strings.add(source.name);
+            record.type        = static_cast<uint8_t>(source.type);
+            record.stats[0]    = source.stats.lp;
+            record.stats[1]    = source.stats.atk;
+            record.stats[2]    = source.stats.def;
+            record.stats[3]    = source.stats.mag;
+            record.stats[4]    = source.stats.crt;
+            record.stats[5]    = source.stats.spe;
+
+            for (int slot = 0; slot < SKILL_SLOTS; slot++) {
+                const int skill_enum = static_cast<int>(source.skill_enum[slot]);
+                if (skill_enum < 0 || skill_enum > UINT16_MAX) return false;
+                record.skill_enum[slot] = static_cast<uint16_t>(skill_enum);
+            }
+        }
+
+        // Skill records, indexed by SkillEnum.
+        std::vector<CreaturePackSkill> skill_records(SKILL_LIBRARY_SIZE);
+        for (int i = 0; i < SKILL_LIBRARY_SIZE; i++) {
+            const Skill& skill = get_skill(static_cast<SkillEnum>(i));
+            skill_records[static_cast<size_t>(i)] = CreaturePackSkill{ static_cast<uint32_t>(i), strings.add(skill.name), strings.add(skill.description) };
+        }
+
+        // Records, then padding up to the string table's page, all covered by the record checksum.
+        std::vector<uint8_t> records(creature_records.size() * sizeof(CreaturePackCreature) + skill_records.size() * sizeof(CreaturePackSkill));
+        if (!creature_records.empty()) { std::memcpy(records.data(), creature_records.data(), creature_records.size() * sizeof(CreaturePackCreature)); }
+        std::memcpy(records.data() + creature_records.size() * sizeof(CreaturePackCreature), skill_records.data(), skill_records.size() * sizeof(CreaturePackSkill));
+
+        const uint64_t header_size    = sizeof(CreaturePackHeader);
+        const uint64_t strings_offset = (header_size + records.size() + CREATURE_PACK_PAGE - 1) / CREATURE_PACK_PAGE * CREATURE_PACK_PAGE;
+        records.resize(static_cast<size_t>(strings_offset - header_size), 0);
+
+        CreaturePackHeader header {};
+        header.magic            = CreaturePackHeader::MAGIC;
+        header.version          = CreaturePackHeader::VERSION;
+        header.endianness       = CreaturePackHeader::ENDIANNESS;
+        header.header_size      = static_cast<uint32_t>(header_size);
+        header.creature_size    = sizeof(CreaturePackCreature);
+        header.creature_count   = static_cast<uint32_t>(creature_count);
+        header.skill_size       = sizeof(CreaturePackSkill);
+        header.skill_count      = static_cast<uint32_t>(SKILL_LIBRARY_SIZE);
+        header.creatures_offset = header_size;
+        header.skills_offset    = header_size + creature_records.size() * sizeof(CreaturePackCreature);
+        header.strings_offset   = strings_offset;
+        header.strings_size     = strings.table.size();
+        header.records_checksum = pack_checksum(records.data(), records.size());
+        header.strings_checksum = pack_checksum(reinterpret_cast<const uint8_t*>(strings.table.data()), strings.table.size());
+
+        return std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(records.data(), 1, records.size(), file) == records.size()
+            && std::fwrite(strings.table.data(), 1, strings.table.size(), file) == strings.table.size()
+            && std::fflush(file) == 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+// CreaturePack
+// ------------
+// Versioned, checksummed binary form of the creature and skill libraries, written at build time by the
+// creature_packer tool and memory-mapped at startup.
+// - Records are fixed-size and stored in their in-memory layout, so opening a pack parses nothing: a creature is
+//   found by indexing the record array with its id, and a skill by its SkillEnum.
+// - Names and descriptions live in a string table after the records, starting on its own page. Opening maps the
+//   records only; the string table is mapped the first time the UI asks for a string, so battles never page it in.
+// - The header holds a word-wise FNV-1a checksum of the records, checked when the pack is opened, and one of the
+//   string table, checked when it is mapped.
+//
+// File layout: a CreaturePackHeader, the CreaturePackCreature array (one record per id below creature_count,
+// holes hold creature_id -1), the CreaturePackSkill array (one record per SkillEnum), then the string table of
+// NUL-terminated strings, aligned to CREATURE_PACK_PAGE. The header stores the record sizes and an endianness tag,
+// so a reader built with a different layout fails instead of misreading.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/data/enums/type_enums.h"
+#include "pipelinepunch/utils/structs/creature_sheet.h"
+#include "pipelinepunch/utils/structs/skills.h"
+#include "pipelinepunch/utils/structs/stats.h"
+
+namespace pipelinepunch {
+
+    constexpr uint64_t CREATURE_PACK_PAGE = 4096; // Alignment of the string table, so records and strings never share a page.
+
+    // Represents the header at the start of a pack.
+    struct CreaturePackHeader {
+        static constexpr uint32_t MAGIC      = 0x4C435050u; // "PPCL"
+        static constexpr uint32_t VERSION    = 1;
+        static constexpr uint32_t ENDIANNESS = 0x01020304u;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t endianness;
+        uint32_t header_size;
+        uint32_t creature_size;
+        uint32_t creature_count;   // Ids below creature_count have a record.
+        uint32_t skill_size;
+        uint32_t skill_count;      // SkillEnums below skill_count have a record.
+        uint64_t creatures_offset;
+        uint64_t skills_offset;
+        uint64_t strings_offset;
+        uint64_t strings_size;
+        uint64_t records_checksum; // Checksum of [header_size, strings_offset).
+        uint64_t strings_checksum; // Checksum of the string table.
+    };
+
+    // Represents one creature record; the stats and skills of a CreatureSheet, with its name in the string table.
+    struct CreaturePackCreature {
+        int32_t  creature_id;             // -1 for an id with no creature.
+        uint32_t name;                    // Offset of the name in the string table.
+        int32_t  stats[6];                // lp, atk, def, mag, crt, spe.
+        uint16_t skill_enum[SKILL_SLOTS];
+        uint8_t  type;                    // TypeEnum.
+        uint8_t  reserved[3];
+    };
+
+    // Represents one skill record; the strings of a skill library entry.
+    struct CreaturePackSkill {
+        uint32_t skill_enum;
+        uint32_t name;        // Offset of the name in the string table.
+        uint32_t description; // Offset of the description in the string table.
+    };
+
+    // Represents a creature handed to write_creature_pack.
+    struct CreaturePackSource {
+        int         creature_id;
+        const char* name;
+        TypeEnum    type;
+        Stats       stats;
+        SkillEnum   skill_enum[SKILL_SLOTS];
+    };
+
+    // Represents a read-only, memory-mapped pack.
+    class CreaturePack {
+    public:
+        static constexpr int MAX_ERROR = 96;
+
+        CreaturePack() = default;
+        ~CreaturePack();
+
+        CreaturePack(const CreaturePack&)            = delete;
+        CreaturePack& operator=(const CreaturePack&) = delete;
+
+        bool open(const char* path); // Maps a pack's records and checks them; false (and closed) on failure.
+        void close();                // Unmaps the pack; not while other threads read it.
+
+        bool                      is_open() const         { return data != nullptr; }
+        bool                      strings_mapped() const  { return strings.load(std::memory_order_acquire) != nullptr; } // Whether a string was read since open().
+        const char*               get_error() const       { return error; }
+        const CreaturePackHeader& get_header() const      { return *reinterpret_cast<const CreaturePackHeader*>(data); }   // Gets the header; the pack must be open.
+        int                       creature_count() const  { return is_open() ? static_cast<int>(get_header().creature_count) : 0; }
+
+        const CreaturePackCreature* find_creature(int creature_id) const; // Gets a creature's record in O(1), or nullptr.
+        bool        get_creature_sheet(int creature_id, CreatureSheet& sheet) const; // Builds a creature's CreatureSheet, without its name.
+        const char* get_creature_name(int creature_id) const;              // Gets a creature's name, or "" if unknown.
+        const char* get_skill_name(SkillEnum skill_enum) const;            // Gets a skill's name, or "" if unknown.
+        const char* get_skill_description(SkillEnum skill_enum) const;     // Gets a skill's description, or "" if unknown.
+
+    private:
+        const uint8_t*                   data { nullptr };              // Mapping of the header and records.
+        size_t                           size { 0 };
+        intptr_t                         file { -1 };                   // File descriptor (POSIX) or file mapping handle (Windows).
+        mutable std::atomic<const char*> strings { nullptr };           // String table, mapped on first use.
+        mutable const void*              strings_view { nullptr };
+        mutable size_t                   strings_view_size { 0 };
+        mutable bool                     strings_failed { false };      // The string table could not be mapped or is corrupt.
+        mutable std::mutex               strings_mutex;
+        char                             error[MAX_ERROR] {};
+
+        const char* get_string(uint32_t offset) const; // Gets a string of the table, mapping the table on first use.
+        const char* map_strings() const;               // Maps and checks the string table once.
+        bool        fail(const char* message);         // Records an error and closes the pack.
+    };
+
+    // Writes a pack of creatures and of every skill library entry's strings to a file opened for binary writing.
+    // Creature ids must be unique and non-negative. Returns false on invalid input or a write error.
+    bool write_creature_pack(std::FILE* file, const CreaturePackSource* creatures, int count);
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+// Creature Packer
+// ---------------
+// Build-time tool that packs creature source files into a CreaturePack, and checks packs.
+// - Reads creature statements (see demo_creatures.txt) and writes them, with the skill library's names and
+//   descriptions, through write_creature_pack.
+// - With --fill, pads the pack up to N creature ids by repeating the source creatures under new ids, to size
+//   the format and the startup cost for a full content set.
+// - With --check, maps a pack, checks it against the static creature library and the skill library, and reports
+//   the open time, the lookup time and whether either mapped the string table; exits with 2 on a mismatch.
+//
+// Usage: creature_packer --creatures FILE --out FILE [--fill N]
+//        creature_packer --check FILE
+// Source format (one statement per line, '#' starts a comment):
+//     creature <id> <name> <type> <lp> <atk> <def> <mag> <crt> <spe> <skill id> <skill id>
+// Names are single tokens. Types: monster, undead.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/data/libraries/creature_pack.h"
+#include "pipelinepunch/data/libraries/skill_library.h"
+
+namespace pipelinepunch {
+
+    constexpr int PACKER_LINE    = 256;     // Longest source line accepted.
+    constexpr int PACKER_TOKENS  = 12;      // Tokens in a creature statement.
+    constexpr int PACKER_MAX_ID  = 1 << 20; // Highest creature id accepted, so a typo cannot write a huge pack.
+    constexpr int PACKER_LOOKUPS = 1000000; // Lookups timed by --check.
+
+    // Represents the packer's command-line configuration.
+    struct PackerConfig {
+        const char* creatures { nullptr };
+        const char* out       { nullptr };
+        const char* check     { nullptr };
+        int         fill      { 0 };
+    };
+
+    // Represents a parsed creature, owning its name.
+    struct PackerCreature {
+        std::string        name;
+        CreaturePackSource source;
+    };
+
+    // Parses a whole token as a decimal int within [min, max], returning false if it is not one.
+    static bool parse_int(const char* token, long min, long max, int& value) {
+        char* end = nullptr;
+        const long parsed = std::strtol(token, &end, 10);
+        if (end == token || *end != '\0' || parsed < min || parsed > max) return false;
+
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // Parses a creature source file. Returns false, after printing the line and reason, on the first error.
+    static bool parse_creatures(const char* path, std::vector<PackerCreature>& creatures) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            std::fprintf(stderr, "--creatures: cannot open %s\n", path);
+            return false;
+        }
+
+        char line[PACKER_LINE];
+        int  line_number = 0;
+        bool ok          = true;
+
+        while (ok && std::fgets(line, sizeof(line), file)) {
+            line_number++;
+            if (char* comment = std::strchr(line, '#')) { *comment = '\0'; }
+
+            char* tokens[PACKER_TOKENS + 1];
+            int   token_count = 0;
+            for (char* token = std::strtok(line, " \t\r\n"); token && token_count <= PACKER_TOKENS; token = std::strtok(nullptr, " \t\r\n")) {
+                tokens[token_count++] = token;
+            }
+            if (token_count == 0) continue;
+
+            PackerCreature creature;
+            CreaturePackSource& source = creature.source;
+            int values[8];
+
+            ok = token_count == PACKER_TOKENS && std::strcmp(tokens[0], "creature") == 0
+                && parse_int(tokens[1], 0, PACKER_MAX_ID, source.creature_id);
+            for (int i = 0; ok && i < 6; i++) { ok = parse_int(tokens[4 + i], INT32_MIN, INT32_MAX, values[i]); }
+            for (int i = 0; ok && i < SKILL_SLOTS; i++) { ok = parse_int(tokens[10 + i], 0, SKILL_LIBRARY_SIZE - 1, values[6 + i]); }
+
+            if      (ok && std::strcmp(tokens[3], "monster") == 0) { source.type = TypeEnum::MONSTER; }
+            else if (ok && std::strcmp(tokens[3], "undead")  == 0) { source.type = TypeEnum::UNDEAD; }
+            else    { ok = false; }
+
+            if (!ok) {
+                std::fprintf(stderr, "--creatures: %s:%d: expected 'creature <id> <name> <type> <lp> <atk> <def> <mag> <crt> <spe> <skill id> <skill id>'\n", path, line_number);
+                break;
+            }
+
+            creature.name = tokens[2];
+            source.stats  = { values[0], values[1], values[2], values[3], values[4], values[5] };
+            for (int i = 0; i < SKILL_SLOTS; i++) { source.skill_enum[i] = static_cast<SkillEnum>(values[6 + i]); }
+            creatures.push_back(creature);
+        }
+
+        std::fclose(file);
+        return ok;
+    }
+
+    // Pads the creatures up to count ids by repeating them under the free ids, named "<name>_<id>".
+    static void fill_creatures(std::vector<PackerCreature>& creatures, int count) {
+        const size_t source_count = creatures.size();
+
+        std::vector<bool> used(static_cast<size_t>(count), false);
+        for (const PackerCreature& creature : creatures) {
+            if (creature.source.creature_id < count) { used[static_cast<size_t>(creature.source.creature_id)] = true; }
+        }
+
+        for (int id = 0, next = 0; id < count && source_count > 0; id++) {
+            if (used[static_cast<size_t>(id)]) continue;
+
+            PackerCreature creature = creatures[static_cast<size_t>(next++) % source_count];
+            creature.name += "_" + std::to_string(id);
+            creature.source.creature_id = id;
+            creatures.push_back(creature);
+        }
+    }
+
+    // Writes a pack from a creature source file. Returns the process exit status.
+    static int pack(const PackerConfig& config) {
+        std::vector<PackerCreature> creatures;
+        if (!parse_creatures(config.creatures, creatures)) return 1;
+        if (config.fill > 0) { fill_creatures(creatures, config.fill); }
+
+        std::vector<CreaturePackSource> sources;
+        for (PackerCreature& creature : creatures) {
+            creature.source.name = creature.name.c_str();
+            sources.push_back(creature.source);
+        }
+
+        std::FILE* file = std::fopen(config.out, "wb");
+        if (!file) {
+            std::fprintf(stderr, "--out: cannot open %s\n", config.out);
+            return 1;
+        }
+
+        const bool ok = write_creature_pack(file, sources.data(), static_cast<int>(sources.size()));
+        std::fclose(file);
+
+        if (!ok) {
+            std::fprintf(stderr, "--out: cannot write %s (repeated creature id or write error)\n", config.out);
+            std::remove(config.out);
+            return 1;
+        }
+
+        std::printf("packed %zu creatures and %d skills into %s\n", sources.size(), SKILL_LIBRARY_SIZE, config.out);
+        return 0;
+    }
+
+    // Maps a pack, checks it against the static creature library and times it. Returns the process exit status.
+    static int check(const PackerConfig& config) {
+        const auto open_start = std::chrono::steady_clock::now();
+        if (!load_creature_pack(config.check)) {
+            std::fprintf(stderr, "--check: %s: %s\n", config.check, get_creature_pack_error());
+            return 1;
+        }
+        const double open_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - open_start).count();
+
+        const CreaturePack& pack = *get_creature_pack();
+
+        // Every id present in both must match the static library. Sheets are built the way battles build them, so the
+        // string table check below also shows whether building them read a name.
+        int mismatches = 0;
+        for (int id = 0; id < CREATURE_LIBRARY_SIZE; id++) {
+            CreatureSheet sheet;
+            if (!pack.get_creature_sheet(id, sheet)) continue;
+
+            const CreatureSheet& creature = get_creature_library()[id];
+            const Stats&         stats    = creature.stats;
+            const int32_t        expected[6] = { stats.lp, stats.atk, stats.def, stats.mag, stats.crt, stats.spe };
+            const int32_t        actual[6]   = { sheet.stats.lp, sheet.stats.atk, sheet.stats.def, sheet.stats.mag, sheet.stats.crt, sheet.stats.spe };
+
+            bool same = sheet.type == creature.type && std::memcmp(actual, expected, sizeof(expected)) == 0;
+            for (int slot = 0; slot < SKILL_SLOTS; slot++) { same = same && sheet.skills.skill_enum[slot] == creature.skills.skill_enum[slot]; }
+            if (!same) { mismatches++; }
+        }
+
+        // Times lookups spread over every id.
+        const int  count        = pack.creature_count();
+        uint64_t   sink         = 0;
+        const auto lookup_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < PACKER_LOOKUPS && count > 0; i++) {
+            const CreaturePackCreature* record = pack.find_creature(static_cast<int>((static_cast<uint64_t>(i) * 2654435761u) % static_cast<uint64_t>(count)));
+            if (record) { sink += static_cast<uint64_t>(record->stats[1]); }
+        }
+        const double lookup_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - lookup_start).count() / PACKER_LOOKUPS;
+
+        // Asked before any string is read, so it shows whether opening, sheets and lookups left the string table alone.
+        const bool mapped_by_lookups = pack.strings_mapped();
+
+        // Skill strings must match the skill library; this also checks the string table's checksum.
+        for (int i = 0; i < SKILL_LIBRARY_SIZE; i++) {
+            const Skill& skill = get_skill(static_cast<SkillEnum>(i));
+            if (std::strcmp(pack.get_skill_name(skill.skill_enum), skill.name) != 0 || std::strcmp(pack.get_skill_description(skill.skill_enum), skill.description) != 0) { mismatches++; }
+        }
+
+        std::printf("creatures       %d\n", count);
+        std::printf("file            %.1f KiB\n", (pack.get_header().strings_offset + pack.get_header().strings_size) / 1024.0);
+        std::printf("open            %.1f us\n", open_us);
+        std::printf("lookup          %.1f ns (sink %llu)\n", lookup_ns, static_cast<unsigned long long>(sink));
+        std::printf("strings mapped  %s by open, sheets and lookups, %s once read\n", mapped_by_lookups ? "yes" : "no", pack.strings_mapped() ? "yes" : "no");
+        std::printf("mismatches      %d\n", mismatches);
+
+        return mismatches == 0 ? 0 : 2;
+    }
+
+    // Parses command-line arguments into a PackerConfig.
+    static bool parse_args(int argc, char** argv, PackerConfig& config) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const char* arg   = argv[i];
+            const char* value = argv[i + 1];
+
+            if      (std::strcmp(arg, "--creatures") == 0) { config.creatures = value; }
+            else if (std::strcmp(arg, "--out")       == 0) { config.out       = value; }
+            else if (std::strcmp(arg, "--check")     == 0) { config.check     = value; }
+            else if (std::strcmp(arg, "--fill")      == 0) { config.fill      = std::atoi(value); }
+            else return false;
+        }
+
+        return (argc % 2 == 1) && config.fill >= 0 && config.fill <= PACKER_MAX_ID + 1
+            && ((config.creatures && config.out && !config.check) || (config.check && !config.creatures && !config.out && config.fill == 0));
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace pipelinepunch;
+
+    PackerConfig config;
+    if (!parse_args(argc, argv, config)) {
+        std::fprintf(stderr, "usage: creature_packer --creatures FILE --out FILE [--fill N]\n       creature_packer --check FILE\n");
+        return 1;
+    }
+
+    return config.check ? check(config) : pack(config);
+}
\ No newline at end of file
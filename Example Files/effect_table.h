@@ -0,0 +1,259 @@
+#pragma once
+
+// EffectTable
+// -----------
+// Struct-of-Arrays table of one side's timed effects (buffs, debuffs, cooldowns), with fixed capacity.
+// - Each effect has a holder (SoA index), a bitmask of effect bits, a magnitude and the wheel tick it expires at.
+//   Storage is inline and live effects stay packed at [0, count): removing one moves the last into its place, so
+//   adding, removing and copying never allocate, and a copy only touches the live prefix (copy_to).
+// - Expiry is driven by the ATB clock through a timing wheel of WHEEL_SLOTS buckets, one per wheel tick
+//   (1/TICKS_PER_BAR of a speed-1 turn bar). advance() only visits the buckets the clock passed since its last
+//   call, so a turn costs the effects that expire in it rather than a scan of every live effect. Effects due more
+//   than a revolution ahead stay in their bucket and are skipped when it comes round.
+// - Every holder's effects are also linked in a per-unit list, so dispelling or querying one unit walks only its
+//   own effects. The OR of a holder's effect bits is kept in CharacterTable::effects, which passive conditions
+//   test by bitmask without touching this table.
+// - Cooldowns are effects on reserved high bits (cooldown_bit); the low bits are free for buffs and debuffs.
+
+#include <cstdint>
+#include <cstring>
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/structs/atb_scheduler.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    // Gets the effect bit reserved for a skill slot's cooldown.
+    constexpr uint32_t cooldown_bit(int skill_slot) { return 1u << (31 - skill_slot); }
+
+    constexpr uint32_t COOLDOWN_BITS = ((1u << SKILL_SLOTS) - 1u) << (32 - SKILL_SLOTS); // Every skill slot's cooldown bit.
+
+    // Represents the timed effects of a side with N slots, up to CAPACITY (CombatConfig::EFFECT_CAPACITY), expiring
+    // on the CLOCK of its AtbScheduler.
+    template <int N, AtbClock CLOCK = AtbClock::FLOAT, int CAPACITY = DEFAULT_EFFECTS_PER_UNIT * N>
+    struct EffectTable {
+        static constexpr int      MAX_EFFECTS   = CAPACITY; // Live effects the side can hold at once.
+        static constexpr uint16_t NONE          = 0xFFFF;   // End of a bucket or unit list.
+        static constexpr int      WHEEL_SLOTS   = 32;       // Buckets of the timing wheel, one wheel tick each.
+        static constexpr uint32_t TICKS_PER_BAR = 1024;     // Wheel ticks in a full turn bar at speed 1.
+
+        using Time = typename AtbScheduler<N, CLOCK>::Time;
+
+        static_assert(CAPACITY > 0 && CAPACITY < NONE, "Effect links are stored as uint16_t.");
+        static_assert((WHEEL_SLOTS & (WHEEL_SLOTS - 1)) == 0, "The wheel size must be a power of two.");
+
+        uint32_t tick { 0 };              // Wheel tick of the last advance.
+        int32_t  count { 0 };             // Live effects, packed at [0, count).
+        uint16_t bucket_head[WHEEL_SLOTS];
+        uint16_t unit_head[N];
+
+        int8_t   unit[CAPACITY];          // Holder's SoA index.
+        uint32_t bits[CAPACITY];
+        float    magnitude[CAPACITY];
+        uint32_t expire_tick[CAPACITY];   // Wheel tick at which the effect expires; its bucket is expire_tick % WHEEL_SLOTS.
+        uint16_t wheel_next[CAPACITY];
+        uint16_t wheel_prev[CAPACITY];
+        uint16_t unit_next[CAPACITY];
+        uint16_t unit_prev[CAPACITY];
+
+        // --- Entry Points ---
+        // Drops every effect and sets the wheel to a clock time.
+        void clear(Time now) {
+            tick  = to_tick(now);
+            count = 0;
+            for (int b = 0; b < WHEEL_SLOTS; b++) { bucket_head[b] = NONE; }
+            for (int index = 0; index < N; index++) { unit_head[index] = NONE; }
+        }
+
+        // Adds an effect to the unit at an SoA index, expiring at a clock time, and sets its bits in ct.effects.
+        // An effect already due expires at the next wheel tick. Returns false if the table is full.
+        bool add(int index, uint32_t effect_bits, float value, Time expire_time, CharacterTable<N>& ct) {
+            if (count >= CAPACITY) return false;
+
+            const int i = count++;
+            const uint32_t expire = to_tick(expire_time);
+
+            unit[i]        = static_cast<int8_t>(index);
+            bits[i]        = effect_bits;
+            magnitude[i]   = value;
+            expire_tick[i] = (expire > tick) ? expire : tick + 1;
+
+            link_wheel(i);
+            link_unit(i);
+            ct.effects[index] |= effect_bits;
+            return true;
+        }
+
+        // Removes the effects of a unit that have any bit of a mask. Returns the number removed.
+        int dispel(int index, uint32_t mask, CharacterTable<N>& ct) {
+            int removed = 0;
+
+            for (uint16_t i = unit_head[index]; i != NONE; ) {
+                const uint16_t next = unit_next[i];
+                if (!(bits[i] & mask)) {
+                    i = next;
+                    continue;
+                }
+
+                const uint16_t last = static_cast<uint16_t>(count - 1);
+                remove(i);
+                removed++;
+                i = (next == last) ? i : next; // The last effect was moved into i and is next in line.
+            }
+
+            if (removed) { ct.effects[index] = unit_bits(index); }
+            return removed;
+        }
+
+        // Advances the wheel to a clock time, expiring every effect due by then and updating its holder's
+        // ct.effects. Returns the holders that lost an effect with any bit of watch_bits, as a mask of SoA indices.
+        uint32_t advance(Time now, uint32_t watch_bits, CharacterTable<N>& ct) {
+            const uint32_t now_tick = to_tick(now);
+            if (now_tick <= tick) return 0;
+
+            if (count == 0) {
+                tick = now_tick;
+                return 0;
+            }
+
+            uint32_t steps = now_tick - tick;
+            if (steps > WHEEL_SLOTS) { steps = WHEEL_SLOTS; }
+
+            uint32_t touched = 0; // Holders whose masks need recomputing.
+            uint32_t watched = 0; // Holders that lost a watched bit.
+
+            for (uint32_t step = 1; step <= steps; step++) {
+                const int b = static_cast<int>((tick + step) & (WHEEL_SLOTS - 1));
+
+                for (uint16_t i = bucket_head[b]; i != NONE; ) {
+                    const uint16_t next = wheel_next[i];
+                    if (expire_tick[i] > now_tick) {
+                        i = next;
+                        continue;
+                    }
+
+                    touched |= 1u << unit[i];
+                    if (bits[i] & watch_bits) { watched |= 1u << unit[i]; }
+                    const uint16_t last = static_cast<uint16_t>(count - 1);
+                    remove(i);
+                    i = (next == last) ? i : next; // The last effect was moved into i and is next in line.
+                }
+            }
+
+            tick = now_tick;
+            for (; touched; touched &= touched - 1) {
+                const int index = PassiveTriggerIndex<N>::count_trailing_zeros(touched);
+                ct.effects[index] = unit_bits(index);
+            }
+            return watched;
+        }
+
+        // Copies the wheel and the live effects into another table of the same side, for snapshots.
+        // Columns past count are left as they were, so a table without effects copies its heads alone.
+        void copy_to(EffectTable& to) const {
+            to.tick  = tick;
+            to.count = count;
+            std::memcpy(to.bucket_head, bucket_head, sizeof(bucket_head));
+            std::memcpy(to.unit_head,   unit_head,   sizeof(unit_head));
+            if (count == 0) return;
+
+            const size_t live = static_cast<size_t>(count);
+            std::memcpy(to.unit,        unit,        live * sizeof(unit[0]));
+            std::memcpy(to.bits,        bits,        live * sizeof(bits[0]));
+            std::memcpy(to.magnitude,   magnitude,   live * sizeof(magnitude[0]));
+            std::memcpy(to.expire_tick, expire_tick, live * sizeof(expire_tick[0]));
+            std::memcpy(to.wheel_next,  wheel_next,  live * sizeof(wheel_next[0]));
+            std::memcpy(to.wheel_prev,  wheel_prev,  live * sizeof(wheel_prev[0]));
+            std::memcpy(to.unit_next,   unit_next,   live * sizeof(unit_next[0]));
+            std::memcpy(to.unit_prev,   unit_prev,   live * sizeof(unit_prev[0]));
+        }
+
+        // Rewrites every unit's ct.effects from the table, after it was restored from a snapshot.
+        void sync_effects(CharacterTable<N>& ct) const {
+            for (int index = 0; index < N; index++) { ct.effects[index] = unit_bits(index); }
+        }
+
+        // --- Queries ---
+        // Gets the OR of the bits of a unit's effects.
+        uint32_t unit_bits(int index) const {
+            uint32_t mask = 0;
+            for (uint16_t i = unit_head[index]; i != NONE; i = unit_next[i]) { mask |= bits[i]; }
+            return mask;
+        }
+
+        // Gets the summed magnitude of a unit's effects that have any bit of a mask.
+        float get_magnitude(int index, uint32_t mask) const {
+            float total = 0.0f;
+            for (uint16_t i = unit_head[index]; i != NONE; i = unit_next[i]) {
+                if (bits[i] & mask) { total += magnitude[i]; }
+            }
+            return total;
+        }
+
+        // Gets the wheel tick of a clock time: 1/TICKS_PER_BAR of a speed-1 turn bar, rounded down.
+        static uint32_t to_tick(Time time) {
+            if constexpr (CLOCK == AtbClock::FIXED) {
+                constexpr int64_t CLOCK_TICKS = AtbScheduler<N, CLOCK>::BAR_TICKS / AtbScheduler<N, CLOCK>::SPEED_ONE / TICKS_PER_BAR;
+                return static_cast<uint32_t>(time / CLOCK_TICKS);
+            } else {
+                return static_cast<uint32_t>(time * TICKS_PER_BAR);
+            }
+        }
+
+    private:
+        // --- Internal list logic ---
+        // Inserts an effect at the head of its expiry bucket.
+        void link_wheel(int i) {
+            uint16_t& head = bucket_head[expire_tick[i] & (WHEEL_SLOTS - 1)];
+            wheel_prev[i] = NONE;
+            wheel_next[i] = head;
+            if (head != NONE) { wheel_prev[head] = static_cast<uint16_t>(i); }
+            head = static_cast<uint16_t>(i);
+        }
+
+        // Inserts an effect at the head of its holder's list.
+        void link_unit(int i) {
+            uint16_t& head = unit_head[unit[i]];
+            unit_prev[i] = NONE;
+            unit_next[i] = head;
+            if (head != NONE) { unit_prev[head] = static_cast<uint16_t>(i); }
+            head = static_cast<uint16_t>(i);
+        }
+
+        // Takes an effect out of its bucket and its holder's list.
+        void unlink(int i) {
+            if (wheel_prev[i] != NONE) { wheel_next[wheel_prev[i]] = wheel_next[i]; } else { bucket_head[expire_tick[i] & (WHEEL_SLOTS - 1)] = wheel_next[i]; }
+            if (wheel_next[i] != NONE) { wheel_prev[wheel_next[i]] = wheel_prev[i]; }
+            if (unit_prev[i]  != NONE) { unit_next[unit_prev[i]]   = unit_next[i]; }  else { unit_head[unit[i]] = unit_next[i]; }
+            if (unit_next[i]  != NONE) { unit_prev[unit_next[i]]   = unit_prev[i]; }
+        }
+
+        // Unlinks an effect and moves the last live effect into its place, pointing that effect's neighbours at
+        // its new position. The holder's ct.effects is left to the caller.
+        void remove(int i) {
+            unlink(i);
+
+            const int last = --count;
+            if (i == last) return;
+
+            unit[i]        = unit[last];
+            bits[i]        = bits[last];
+            magnitude[i]   = magnitude[last];
+            expire_tick[i] = expire_tick[last];
+            wheel_next[i]  = wheel_next[last];
+            wheel_prev[i]  = wheel_prev[last];
+            unit_next[i]   = unit_next[last];
+            unit_prev[i]   = unit_prev[last];
+
+            const uint16_t to = static_cast<uint16_t>(i);
+            if (wheel_prev[i] != NONE) { wheel_next[wheel_prev[i]] = to; } else { bucket_head[expire_tick[i] & (WHEEL_SLOTS - 1)] = to; }
+            if (wheel_next[i] != NONE) { wheel_prev[wheel_next[i]] = to; }
+            if (unit_prev[i]  != NONE) { unit_next[unit_prev[i]]   = to; } else { unit_head[unit[i]] = to; }
+            if (unit_next[i]  != NONE) { unit_prev[unit_next[i]]   = to; }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+// Event
+// -----
+// Describes one resolved skill effect for a battle with TEAM_SIZE slots per side.
+// - Created by an ActiveEventBuilder in phase 1 (shape and flags), filled with values in phase 2.
+// - Builders reserve events in place through the BattleContext, so an event lives in one EventArena slot from
+//   creation to resolution and is never copied.
+// - Per-position damage arrays are sized by the battle's CombatConfig, so events stay fixed-size.
+// - The header is 16 bytes: the intent is narrowed to bytes, as journal records store it, and the flags share a
+//   word with the cascade depth. The damage arrays follow it at a 16-byte offset.
+// - Reaction events carry their cascade depth, stamped by the CombatEngine after their PassiveEventBuilder runs.
+
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the Intent an event was built from, narrowed to one byte per field.
+    struct EventIntent {
+        int8_t owner_team_index { 0 };
+        int8_t owner_index { 0 };
+        int8_t skill_slot { 0 };
+        int8_t target_pos { 0 };
+
+        // Stores an Intent.
+        void pack(const Intent& intent) {
+            owner_team_index = static_cast<int8_t>(intent.owner_team_index);
+            owner_index      = static_cast<int8_t>(intent.owner_index);
+            skill_slot       = static_cast<int8_t>(intent.skill_slot);
+            target_pos       = static_cast<int8_t>(intent.target_pos);
+        }
+
+        // Gets the stored Intent back, for builders and passive conditions.
+        Intent unpack() const {
+            Intent intent;
+            intent.owner_team_index = owner_team_index;
+            intent.owner_index      = owner_index;
+            intent.skill_slot       = skill_slot;
+            intent.target_pos       = target_pos;
+            return intent;
+        }
+    };
+
+    // Represents an event in a battle with N slots per side.
+    template <int N>
+    struct Event {
+        EventIntent intent;
+        uint32_t    target_bitmask { 0 };   // One bit per targeted party position.
+        uint32_t    effect_bitmask { 0 };   // Effect flags observed by passives.
+        bool        is_aoe { false };
+        bool        is_negated { false };
+        uint8_t     depth { 0 };            // Cascade depth: 0 for main events, parent depth + 1 for reactions.
+        uint8_t     reserved { 0 };
+        float       owner_pos_damage[N] {}; // Damage dealt to the owner's side, by party position.
+        float       other_pos_damage[N] {}; // Damage dealt to the other side, by party position.
+    };
+
+    static_assert(sizeof(Event<5>)  == 16 + 2 * 5 * sizeof(float),  "The Event header must stay at 16 bytes.");
+    static_assert(sizeof(Event<30>) == 16 + 2 * 30 * sizeof(float), "The Event header must stay at 16 bytes.");
+}
\ No newline at end of file
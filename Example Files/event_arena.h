@@ -0,0 +1,44 @@
+#pragma once
+
+// EventArena
+// ----------
+// Per-turn storage of a battle's events, which the EventQueues of its BattleContext index into.
+// - Builders reserve a cleared slot and fill it in place, so events are neither built on the stack nor copied
+//   into a queue.
+// - Slots are handed out in creation order from inline storage, so the arena never allocates. reset() frees every
+//   slot at the start of a turn, and rewind() frees the reactions of one main event's cascade; both are O(1).
+// - Capacity comes from the battle's CombatConfig: the main events plus every reaction queue, so a reservation
+//   only fails once the queue it is for is full.
+
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/structs/event.h"
+
+namespace pipelinepunch {
+
+    // Represents the event slots of a turn, up to CAPACITY, for a battle with N slots per side.
+    template <int CAPACITY, int N>
+    struct EventArena {
+        static_assert(CAPACITY <= UINT16_MAX, "EventQueues store arena slots as uint16_t.");
+
+        Event<N> event[CAPACITY];
+        int      top { 0 }; // Slots handed out since the last reset.
+
+        // Reserves the next slot and clears it. Returns -1 once the arena is full.
+        int allocate() {
+            if (top >= CAPACITY) return -1;
+
+            event[top] = Event<N>{};
+            return top++;
+        }
+
+        // Gets the position of the next slot, for a later rewind().
+        int mark() const { return top; }
+
+        // Frees every slot handed out since a mark().
+        void rewind(int position) { top = position; }
+
+        // Frees every slot.
+        void reset() { top = 0; }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+// EventQueue
+// ----------
+// Fixed-capacity queue of events, one per priority tier of a battle.
+// - Holds the EventArena slots of its events in push order, so queues never allocate or copy events; capacities
+//   come from the battle's CombatConfig.
+// - Events pushed into a full queue are dropped and counted, so the CombatEngine can report overflows.
+
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/structs/event_arena.h"
+
+namespace pipelinepunch {
+
+    // Represents a queue of up to CAPACITY events for a battle with N slots per side.
+    template <int CAPACITY, int N>
+    struct EventQueue {
+        uint16_t slot[CAPACITY]; // EventArena slots, in push order.
+        int      count { 0 };
+        int      dropped { 0 };  // Events rejected since the last clear().
+
+        // Reserves a cleared event in an arena and queues it. Returns nullptr and counts the event as dropped once
+        // the queue or the arena is full.
+        template <int ARENA>
+        Event<N>* emplace_event(EventArena<ARENA, N>& arena) {
+            const int index = (count < CAPACITY) ? arena.allocate() : -1;
+            if (index < 0) {
+                dropped++;
+                return nullptr;
+            }
+
+            slot[count++] = static_cast<uint16_t>(index);
+            return &arena.event[index];
+        }
+
+        // Removes all events and resets the overflow count. Their slots are freed by the arena.
+        void clear() {
+            count   = 0;
+            dropped = 0;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+// PassiveTable
+// ------------
+// Struct-of-Arrays registry of the passives of one tier (negate, intercept, react, modify) for one side.
+// - Sized by the battle's TEAM_SIZE: N entries per tier and side, so a side's units share N passives of each tier
+//   (one per unit, or several for some units and none for others). A kit of 3-4 passives per unit fits when they
+//   are spread over the four tiers; add() returns false once a table is full. Entry masks are one uint32_t wide.
+// - Keeps a PassiveTriggerIndex next to the entries, so an event only visits passives that could fire.
+
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Checks whether a registered passive may trigger for an intent.
+    template <int N>
+    using PassiveCondition = bool (*)(const CharacterTable<N>& owner_ct, const CharacterTable<N>& other_ct, const Intent& intent);
+
+    // PassiveTriggerIndex
+    // -------------------
+    // Bitmask index over the entries of one PassiveTable; bit i stands for entry i.
+    // - by_effect[b] holds the entries observing effect bit b, by_caster[c] / by_target[t] the entries filtering on
+    //   that SoA index, and wildcard the entries with either filter set to -1 (which always pass the filter check).
+    // - live drops the entries of dead owners; owner_entries maps an owner to its entries for that update.
+    // - Updated incrementally by PassiveTable::add and PassiveTable::on_owner_died, never rebuilt per event.
+    template <int N>
+    struct PassiveTriggerIndex {
+        static_assert(N <= 32, "Entry masks hold one bit per passive.");
+
+        uint32_t by_effect[32];    // Entries observing each effect bit.
+        uint32_t by_caster[N];     // Entries observing a caster SoA index.
+        uint32_t by_target[N];     // Entries observing a target SoA index.
+        uint32_t wildcard;         // Entries observing any caster or any target.
+        uint32_t live;             // Entries whose owner is alive.
+        uint32_t owner_entries[N]; // Entries owned by each SoA index.
+        uint32_t observed_effects; // Union of all observed effect bits, so unobserved bits are skipped.
+
+        // Removes every entry.
+        void clear() {
+            for (int b = 0; b < 32; b++) { by_effect[b] = 0; }
+            for (int i = 0; i < N; i++) {
+                by_caster[i]     = 0;
+                by_target[i]     = 0;
+                owner_entries[i] = 0;
+            }
+            wildcard         = 0;
+            live             = 0;
+            observed_effects = 0;
+        }
+
+        // Gets the entries that observe any bit of effect_bitmask and match the caster or target filter.
+        // A target_index of -1 (no single target) only matches wildcard and caster filters.
+        uint32_t match(uint32_t effect_bitmask, int caster_index, int target_index) const {
+            uint32_t observed = 0;
+            for (uint32_t bits = effect_bitmask & observed_effects; bits; bits &= bits - 1) {
+                observed |= by_effect[count_trailing_zeros(bits)];
+            }
+
+            uint32_t filtered = wildcard | by_caster[caster_index];
+            if (target_index >= 0) { filtered |= by_target[target_index]; }
+
+            return observed & filtered & live;
+        }
+
+        // Gets the index of the lowest set bit of a non-zero mask.
+        static int count_trailing_zeros(uint32_t bits) {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(bits);
+        #else
+            int i = 0;
+            while (!(bits & 1u)) { bits >>= 1; i++; }
+            return i;
+        #endif
+        }
+    };
+
+    // Represents the passives of one tier for a side with N slots.
+    template <int N>
+    struct PassiveTable {
+        int                    count { 0 };
+        Intent                 intent[N];                  // Passive owner and skill slot.
+        uint32_t               observed_effect_bitmask[N]; // Effects that can trigger the passive.
+        int                    observed_caster_index[N];   // Caster filter, or -1 for any.
+        int                    observed_target_index[N];   // Target filter, or -1 for any.
+        PassiveCondition<N>    condition[N];               // Extra trigger condition.
+        PassiveTriggerIndex<N> trigger_index;              // Effect/caster/target index over the entries above.
+
+        PassiveTable() { clear(); }
+
+        // Removes every passive.
+        void clear() {
+            count = 0;
+            trigger_index.clear();
+        }
+
+        // Registers a passive for a living owner. Returns false if the table is full, or if the owner index is outside
+        // [0, N) or a caster or target filter outside [-1, N).
+        bool add(const Intent& owner_intent, uint32_t effect_bitmask, int caster_index, int target_index, PassiveCondition<N> passive_condition) {
+            if (count >= N) { return false; }
+            if (owner_intent.owner_index < 0 || owner_intent.owner_index >= N) { return false; }
+            if (caster_index < -1 || caster_index >= N || target_index < -1 || target_index >= N) { return false; }
+
+            const int      i   = count++;
+            const uint32_t bit = 1u << i;
+
+            intent[i]                  = owner_intent;
+            observed_effect_bitmask[i] = effect_bitmask;
+            observed_caster_index[i]   = caster_index;
+            observed_target_index[i]   = target_index;
+            condition[i]               = passive_condition;
+
+            PassiveTriggerIndex<N>& ti = trigger_index;
+            for (uint32_t bits = effect_bitmask; bits; bits &= bits - 1) {
+                ti.by_effect[PassiveTriggerIndex<N>::count_trailing_zeros(bits)] |= bit;
+            }
+            ti.observed_effects |= effect_bitmask;
+
+            if (caster_index == -1 || target_index == -1) { ti.wildcard |= bit; }
+            if (caster_index >= 0) { ti.by_caster[caster_index] |= bit; }
+            if (target_index >= 0) { ti.by_target[target_index] |= bit; }
+
+            ti.owner_entries[owner_intent.owner_index] |= bit;
+            ti.live |= bit;
+
+            return true;
+        }
+
+        // Drops the passives of a unit that died, so later events skip them without a scan.
+        void on_owner_died(int owner_index) { trigger_index.live &= ~trigger_index.owner_entries[owner_index]; }
+    };
+}
\ No newline at end of file
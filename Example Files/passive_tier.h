@@ -0,0 +1,12 @@
+#pragma once
+
+namespace pipelinepunch {
+
+    // Represents the tier of a passive, which decides when it answers an event.
+    enum class PassiveTier {
+        NEGATE,    // Cancels the event; the fastest valid passive wins.
+        INTERCEPT, // Modifies or inserts events; the fastest valid passive wins.
+        REACT,     // Responds after the event; every valid passive triggers.
+        MODIFY     // Adjusts the values of a resolving event.
+    };
+}
\ No newline at end of file
@@ -0,0 +1,441 @@
+// Replay Verifier
+// ---------------
+// Headless, Godot-free bulk verifier of submitted battle journals, for rejecting tampered PvP and leaderboard logs.
+// - Re-simulates each log on the CombatEngine from its seed and the server's parties, feeding it the log's turn
+//   intents, and compares every record the engine journals (turn intents and each resolved event's damage arrays)
+//   with the log's own, bit for bit. The first record that differs is the divergent turn.
+// - With --effects, also applies the log's effect, dispel and cooldown records between turns, for modes whose
+//   items or field effects add them. The engine can only check that they are legal where they appear, not that the
+//   game granted them, so without --effects a log that holds any is a mismatch.
+// - Rejects a move the engine could not have been given (a skill slot the actor lacks, a position off the board)
+//   before it reaches the engine, so a crafted log is reported rather than played.
+// - Picks the CombatConfig from the team size and AtbClock in each log's header, so one run verifies 5v5, 1v20 and
+//   30v30 logs on either clock.
+// - Spreads logs over all hardware threads, one set of engines per worker; workers pull the next log path as they
+//   finish, so paths piped on stdin are verified while they arrive.
+// - Logs carry no parties: the verifier plays every log with --allies and --opponents, as a server plays them with
+//   the matchup it recorded, so a client cannot claim other creatures.
+//
+// Usage: replay_verifier --allies a,b,... --opponents a,b,... [--threads T] [--out FILE] [--effects] [PATH...]
+// Each PATH is a journal file or a directory of them; with no PATH (or "-"), journal paths are read from stdin,
+// one per line. Writes one tab-separated verdict per log, in completion order:
+//     <path> <verdict> <turn> <detail>
+// where verdict is ok (turn = turns played), incomplete (the log stops while the battle still runs),
+// mismatch (turn = first divergent turn) or invalid (not a readable journal; turn = -1).
+// Prints a summary to stderr and exits with status 2 if any log is not ok.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "pipelinepunch/data/libraries/creature_library.h"
+#include "pipelinepunch/systems/combat_system/combat_engine.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_journal.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+
+namespace pipelinepunch {
+
+    constexpr int VERIFY_RECORDS   = 1 << 14; // Longest log accepted, in records.
+    constexpr int VERIFY_MAX_PARTY = 32;      // Longest party list accepted on the command line.
+    constexpr int VERIFY_DETAIL    = 64;
+    constexpr int VERIFY_PATH      = 4096;    // Longest path read from stdin.
+
+    // Represents the verifier's command-line configuration.
+    struct VerifierConfig {
+        int                      threads { 0 };
+        std::vector<int>         allies;
+        std::vector<int>         opponents;
+        const char*              out { nullptr };
+        bool                     effects { false }; // Applies effect, dispel and cooldown records instead of rejecting them.
+        std::vector<std::string> paths; // Files and directories; empty to read paths from stdin.
+    };
+
+    // Represents the outcome of one log.
+    enum class Verdict {
+        OK,
+        INCOMPLETE,
+        MISMATCH,
+        INVALID,
+        COUNT
+    };
+
+    constexpr const char* VERDICT_NAMES[static_cast<int>(Verdict::COUNT)] = { "ok", "incomplete", "mismatch", "invalid" };
+
+    // Represents the result of verifying one log.
+    struct VerifyResult {
+        Verdict verdict { Verdict::INVALID };
+        int     turn { -1 };
+        char    detail[VERIFY_DETAIL] {};
+    };
+
+    // Fills a VerifyResult; detail is a printf format.
+    static VerifyResult make_result(Verdict verdict, int turn, const char* detail, ...) {
+        VerifyResult result;
+        result.verdict = verdict;
+        result.turn    = turn;
+
+        va_list args;
+        va_start(args, detail);
+        std::vsnprintf(result.detail, sizeof(result.detail), detail, args);
+        va_end(args);
+        return result;
+    }
+
+    // Parses a comma separated list of creature ids; they are checked against the library before any log is read.
+    static bool parse_party(const char* text, std::vector<int>& party) {
+        party.clear();
+
+        for (;;) {
+            char* end = nullptr;
+            long  id  = std::strtol(text, &end, 10);
+            if (end == text || id < -1 || id > INT32_MAX || party.size() == VERIFY_MAX_PARTY) return false;
+
+            party.push_back(static_cast<int>(id));
+            text = end;
+
+            if (*text == '\0') return true;
+            if (*text != ',') return false;
+            text++;
+        }
+    }
+
+    // Checks that every creature id of a party exists in the creature library.
+    static bool party_is_known(const std::vector<int>& party) {
+        CreatureSheet creature;
+        for (int id : party) {
+            if (id >= 0 && !get_creature_sheet(id, creature)) return false;
+        }
+        return true;
+    }
+
+    // Checks whether two journal records are identical, damage bits included; reserved bytes are not compared.
+    template <int N>
+    static bool same_record(const JournalRecord<N>& a, const JournalRecord<N>& b) {
+        return a.type == b.type && a.owner_team_index == b.owner_team_index && a.owner_index == b.owner_index
+            && a.skill_slot == b.skill_slot && a.target_pos == b.target_pos && a.depth == b.depth && a.turn == b.turn
+            && a.effect_bits == b.effect_bits && a.seed == b.seed
+            && std::memcmp(&a.effect_magnitude, &b.effect_magnitude, sizeof(a.effect_magnitude)) == 0
+            && std::memcmp(&a.effect_duration, &b.effect_duration, sizeof(a.effect_duration)) == 0
+            && std::memcmp(a.owner_pos_damage, b.owner_pos_damage, sizeof(a.owner_pos_damage)) == 0
+            && std::memcmp(a.other_pos_damage, b.other_pos_damage, sizeof(a.other_pos_damage)) == 0;
+    }
+
+    // Represents one worker's verifier for the logs of one CombatConfig. Engines and journals are large, so they
+    // live on the heap and are reused from log to log.
+    template <typename Config>
+    class LogVerifier {
+    public:
+        static constexpr int N = Config::TEAM_SIZE;
+
+        using Journal   = typename CombatEngine<Config>::Journal;
+        using Submitted = CombatJournal<N, Config::ATB_CLOCK, Config::EFFECT_CAPACITY, VERIFY_RECORDS>;
+
+        LogVerifier(const std::vector<int>& allies, const std::vector<int>& opponents, bool allow_effects)
+            : engine(new CombatEngine<Config>()), recorded(new Journal()), submitted(new Submitted()), effects(allow_effects) {
+            build_party(allies,    ally_sheets,     ally_slots);
+            build_party(opponents, opponent_sheets, opponent_slots);
+            engine->set_journal(recorded.get());
+        }
+
+        // Verifies the journal in a file opened for binary reading, positioned at its start.
+        VerifyResult verify(std::FILE* file) {
+            if (!submitted->load(file))                                   return make_result(Verdict::INVALID, -1, "not a journal of this build's layout");
+            if (submitted->first_record() > 0)                            return make_result(Verdict::INVALID, -1, "longer than %d records", VERIFY_RECORDS);
+            if (submitted->record(0).type != JournalRecordType::SEED
+                || submitted->record(0).seed != submitted->seed)          return make_result(Verdict::INVALID, -1, "does not open with its seed record");
+
+            engine->setup_from_sheets(ally_slots, opponent_slots);
+            engine->set_seed(submitted->seed);
+            engine->roll_initiative();
+
+            uint64_t next = 0; // Next submitted record to compare.
+            uint64_t seen = 0; // Next recorded record to compare.
+
+            // Compares the records the engine wrote since the last call with the log's next ones.
+            auto matches = [&]() {
+                for (; seen < recorded->record_count; seen++, next++) {
+                    if (next == submitted->record_count || !same_record(recorded->record(seen), submitted->record(next))) return false;
+                }
+                return true;
+            };
+
+            if (!matches()) return make_result(Verdict::MISMATCH, 0, "record %llu differs at roll_initiative", static_cast<unsigned long long>(next));
+
+            while (engine->get_combat_state() == CombatState::RUNNING) {
+                const int turn = engine->get_turn_count();
+                if (next == submitted->record_count) return make_result(Verdict::INCOMPLETE, turn, "log ends while the battle runs");
+
+                const JournalRecord<N>& r = submitted->record(next);
+
+                // An effect record must be applied by the engine and journaled again identically, where the log has it.
+                if (r.type == JournalRecordType::EFFECT || r.type == JournalRecordType::DISPEL || r.type == JournalRecordType::COOLDOWN) {
+                    const uint64_t applied = next;
+                    if (!effects || r.turn != static_cast<uint32_t>(turn)) return make_result(Verdict::MISMATCH, turn, "record %llu is an effect not allowed here", static_cast<unsigned long long>(next));
+                    if (!engine->apply_effect_record(r) || !matches() || next == applied) return make_result(Verdict::MISMATCH, turn, "effect record %llu refused", static_cast<unsigned long long>(applied));
+                    continue;
+                }
+
+                if (r.type != JournalRecordType::TURN || r.turn != static_cast<uint32_t>(turn)) return make_result(Verdict::MISMATCH, turn, "record %llu is not this turn's intent", static_cast<unsigned long long>(next));
+
+                // The log's actor fields are compared with the engine's by matches(); the move must be legal for the engine's actor.
+                if (!engine->turn(r.skill_slot, r.target_pos)) {
+                    return make_result(Verdict::MISMATCH, turn, "illegal move (slot %d, target %d)", r.skill_slot, r.target_pos);
+                }
+                if (!matches()) {
+                    if (next == submitted->record_count) return make_result(Verdict::MISMATCH, turn, "log ends inside the turn");
+                    return make_result(Verdict::MISMATCH, turn, "record %llu differs", static_cast<unsigned long long>(next));
+                }
+            }
+
+            const int turns = engine->get_turn_count();
+            if (next != submitted->record_count) return make_result(Verdict::MISMATCH, turns, "%llu records after the battle ended", static_cast<unsigned long long>(submitted->record_count - next));
+
+            return make_result(Verdict::OK, turns, "winner %d", engine->get_winner_team_index());
+        }
+
+    private:
+        std::unique_ptr<CombatEngine<Config>> engine;
+        std::unique_ptr<Journal>              recorded;  // Written by the engine while it replays.
+        std::unique_ptr<Submitted>            submitted; // Loaded from the log.
+        bool                                  effects;   // Applies effect records instead of rejecting them.
+        std::array<CharacterSheet, N>         ally_sheets;
+        std::array<CharacterSheet, N>         opponent_sheets;
+        std::array<const CharacterSheet*, N>  ally_slots;
+        std::array<const CharacterSheet*, N>  opponent_slots;
+
+        // Builds the runtime CharacterSheets for a party of creature ids.
+        static void build_party(const std::vector<int>& creature_ids, std::array<CharacterSheet, N>& sheets, std::array<const CharacterSheet*, N>& slots) {
+            for (size_t pos = 0; pos < N; pos++) {
+                if (pos >= creature_ids.size() || creature_ids[pos] < 0) {
+                    slots[pos] = nullptr;
+                    continue;
+                }
+
+                sheets[pos] = CharacterSheet{};
+                get_creature_sheet(creature_ids[pos], sheets[pos].creature_sheet);
+
+                const CreatureSheet& creature = sheets[pos].creature_sheet;
+                sheets[pos].stats  = creature.stats;
+                sheets[pos].skills = creature.skills;
+                slots[pos] = &sheets[pos];
+            }
+        }
+    };
+
+    // Represents the shared queue of log paths: the command-line files and directories, or stdin.
+    class LogSource {
+    public:
+        explicit LogSource(const VerifierConfig& config) : from_stdin(config.paths.empty()) {
+            for (const std::string& path : config.paths) {
+                if (path == "-") { from_stdin = true; continue; }
+
+                std::error_code error;
+                if (!std::filesystem::is_directory(path, error)) {
+                    paths.push_back(path);
+                    continue;
+                }
+
+                // A directory's files are taken in name order, so repeated runs read them alike.
+                std::vector<std::string> files;
+                for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+                    if (entry.is_regular_file(error)) { files.push_back(entry.path().string()); }
+                }
+                std::sort(files.begin(), files.end());
+                paths.insert(paths.end(), files.begin(), files.end());
+            }
+        }
+
+        // Gets the next log path; false once every path has been handed out.
+        bool next(std::string& path) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (cursor < paths.size()) {
+                path = paths[cursor++];
+                return true;
+            }
+
+            // Stdin is read one line per call, so logs are verified as their paths arrive.
+            char line[VERIFY_PATH];
+            while (from_stdin && std::fgets(line, sizeof(line), stdin)) {
+                size_t length = std::strlen(line);
+                while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) { line[--length] = '\0'; }
+                if (length == 0) continue;
+
+                path.assign(line, length);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        std::mutex               mutex;
+        std::vector<std::string> paths;
+        size_t                   cursor { 0 };
+        bool                     from_stdin;
+    };
+
+    // Represents one worker's verifiers for the configs of one AtbClock.
+    template <typename Config5, typename Config20, typename Config30>
+    struct ClockVerifiers {
+        LogVerifier<Config5>  verifier_5v5;
+        LogVerifier<Config20> verifier_1v20;
+        LogVerifier<Config30> verifier_30v30;
+
+        explicit ClockVerifiers(const VerifierConfig& config)
+            : verifier_5v5(config.allies, config.opponents, config.effects), verifier_1v20(config.allies, config.opponents, config.effects),
+              verifier_30v30(config.allies, config.opponents, config.effects) {}
+
+        // Verifies a log with the verifier of its header's team size.
+        VerifyResult verify(const JournalFileHeader& header, std::FILE* file) {
+            switch (header.team_size) {
+                case Config5::TEAM_SIZE:  return verifier_5v5.verify(file);
+                case Config20::TEAM_SIZE: return verifier_1v20.verify(file);
+                case Config30::TEAM_SIZE: return verifier_30v30.verify(file);
+                default:                  return make_result(Verdict::INVALID, -1, "unsupported team size %u", header.team_size);
+            }
+        }
+    };
+
+    // Represents one worker's verifiers, one per CombatConfig.
+    struct VerifierWorker {
+        ClockVerifiers<Config5v5, Config1v20, Config30v30>                float_verifiers;
+        ClockVerifiers<Config5v5Fixed, Config1v20Fixed, Config30v30Fixed> fixed_verifiers;
+
+        explicit VerifierWorker(const VerifierConfig& config) : float_verifiers(config), fixed_verifiers(config) {}
+
+        // Verifies one log file, choosing the verifier from its header's AtbClock and team size.
+        VerifyResult verify(const std::string& path) {
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return make_result(Verdict::INVALID, -1, "cannot open");
+
+            JournalFileHeader header;
+            const bool has_header = std::fread(&header, sizeof(header), 1, file) == 1;
+            std::rewind(file);
+
+            VerifyResult result;
+            if (!has_header || header.magic != JournalFileHeader::MAGIC)         { result = make_result(Verdict::INVALID, -1, "not a journal"); }
+            else if (header.version != JournalFileHeader::VERSION)               { result = make_result(Verdict::INVALID, -1, "journal version %u", header.version); }
+            else if (header.atb_clock == static_cast<uint32_t>(AtbClock::FLOAT)) { result = float_verifiers.verify(header, file); }
+            else if (header.atb_clock == static_cast<uint32_t>(AtbClock::FIXED)) { result = fixed_verifiers.verify(header, file); }
+            else                                                                 { result = make_result(Verdict::INVALID, -1, "unsupported clock %u", header.atb_clock); }
+
+            std::fclose(file);
+            return result;
+        }
+    };
+
+    // Verifies every log across all workers, writing verdicts as they complete, and prints a summary.
+    static int run_verifier(const VerifierConfig& config) {
+        std::FILE* out = config.out ? std::fopen(config.out, "w") : stdout;
+        if (!out) {
+            std::fprintf(stderr, "--out: cannot open %s\n", config.out);
+            return 1;
+        }
+
+        const int thread_count = (config.threads > 0) ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+
+        LogSource                source(config);
+        std::mutex               out_mutex;
+        std::atomic<uint64_t>    counts[static_cast<int>(Verdict::COUNT)] {};
+        std::vector<std::thread> workers;
+
+        // Verifies logs until the source runs dry.
+        auto worker = [&]() {
+            std::unique_ptr<VerifierWorker> verifier(new VerifierWorker(config));
+
+            std::string path;
+            while (source.next(path)) {
+                const VerifyResult result = verifier->verify(path);
+                counts[static_cast<int>(result.verdict)].fetch_add(1, std::memory_order_relaxed);
+
+                std::lock_guard<std::mutex> lock(out_mutex);
+                std::fprintf(out, "%s\t%s\t%d\t%s\n", path.c_str(), VERDICT_NAMES[static_cast<int>(result.verdict)], result.turn, result.detail);
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < thread_count; i++) { workers.emplace_back(worker); }
+        for (std::thread& t : workers) { t.join(); }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const bool written = (config.out ? std::fclose(out) : std::fflush(out)) == 0;
+        if (!written) {
+            std::fprintf(stderr, "cannot write verdicts\n");
+            return 1;
+        }
+
+        uint64_t total = 0;
+        for (const auto& count : counts) { total += count.load(); }
+
+        std::fprintf(stderr, "logs            %llu\n", static_cast<unsigned long long>(total));
+        std::fprintf(stderr, "threads         %d\n", thread_count);
+        std::fprintf(stderr, "seconds         %.3f\n", seconds);
+        std::fprintf(stderr, "logs/sec        %.0f\n", (seconds > 0.0) ? total / seconds : 0.0);
+        for (int v = 0; v < static_cast<int>(Verdict::COUNT); v++) {
+            std::fprintf(stderr, "%-15s %llu\n", VERDICT_NAMES[v], static_cast<unsigned long long>(counts[v].load()));
+        }
+
+        return (counts[static_cast<int>(Verdict::OK)].load() == total) ? 0 : 2;
+    }
+
+    // Parses command-line arguments into a VerifierConfig.
+    static bool parse_args(int argc, char** argv, VerifierConfig& config) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg   = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+            if (std::strncmp(arg, "--", 2) != 0) {
+                config.paths.push_back(arg);
+                continue;
+            }
+            if (std::strcmp(arg, "--effects") == 0) {
+                config.effects = true;
+                continue;
+            }
+
+            if (!value) return false;
+
+            if      (std::strcmp(arg, "--threads")   == 0) { config.threads = std::atoi(value); }
+            else if (std::strcmp(arg, "--out")       == 0) { config.out     = value; }
+            else if (std::strcmp(arg, "--allies")    == 0) { if (!parse_party(value, config.allies))    return false; }
+            else if (std::strcmp(arg, "--opponents") == 0) { if (!parse_party(value, config.opponents)) return false; }
+            else return false;
+
+            i++;
+        }
+
+        return !config.allies.empty() && !config.opponents.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    pipelinepunch::VerifierConfig config;
+
+    if (!pipelinepunch::parse_args(argc, argv, config)) {
+        std::fprintf(stderr, "usage: replay_verifier --allies a,b,... --opponents a,b,... [--threads T] [--out FILE] [--effects] [PATH...]\n");
+        return 1;
+    }
+
+    if (!pipelinepunch::party_is_known(config.allies) || !pipelinepunch::party_is_known(config.opponents)) {
+        std::fprintf(stderr, "unknown creature id in --allies or --opponents\n");
+        return 1;
+    }
+
+    return pipelinepunch::run_verifier(config);
+}
\ No newline at end of file
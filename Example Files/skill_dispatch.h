@@ -0,0 +1,17 @@
+#pragma once
+
+namespace pipelinepunch {
+
+    // Represents how a CombatEngine reaches its ActiveEventBuilders.
+    enum class SkillDispatch {
+        SWITCH,  // A compile-time switch over SkillEnum, with each phase a separate, inlinable function.
+        POINTER, // The per-slot ActiveEventBuilder function pointers, branching on Event* for the phase.
+        PROGRAM  // The slot's SkillProgram from the attached SkillProgramLibrary if it has one, otherwise SWITCH.
+    };
+
+    // Represents the phase of an ActiveEventBuilder.
+    enum class SkillPhase {
+        CREATE,  // Builds the main event and pushes it to the main event queue.
+        RESOLVE  // Fills in the main event's resolved values (damage, resource changes, etc.).
+    };
+}
\ No newline at end of file
@@ -1,30 +1,90 @@
 // Skill Library
 // ----------------
 // Provides read-only access to the array of all base Skill entries.
-// The library is static and allocated once.
+// The library is a constexpr table: it is built at compile time, so it needs no dynamic initialisation and is
+// safe to read from other static initialisers (e.g. the creature library).
 
 #include "skill_library.h"
 
 #include "pipelinepunch/data/skills/active_event_builders.h"
 #include "pipelinepunch/data/skills/passive_event_builders.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
 
 namespace pipelinepunch {
     
-    // Builds the skill_library instance.
-    static std::array<Skill, SKILL_LIBRARY_SIZE> build_skill_library() {
-        std::array<Skill, SKILL_LIBRARY_SIZE> lib{};
+    // Represents the skill library while it is built: its entries, and which SkillEnums were registered.
+    struct SkillLibraryBuild {
+        std::array<Skill, SKILL_LIBRARY_SIZE> skills {};
+        std::array<bool, SKILL_LIBRARY_SIZE>  registered {};
 
-        lib[static_cast<int>(SkillEnum::DEMO_ATTACK)] = { SkillEnum::DEMO_ATTACK, demo_attack, nullptr, "Demo Attack", "Attacks a single target." };
-        lib[static_cast<int>(SkillEnum::DEMO_CLEAVE)] = { SkillEnum::DEMO_CLEAVE, demo_cleave, nullptr, "Demo Cleave", "Attacks all opponents." };
+        // Registers a skill at its own SkillEnum. Every skill takes an ActiveEventBuilder.
+        constexpr void add(SkillEnum skill_enum, ActiveEventBuilder active_event_builder, PassiveEventBuilder passive_event_builder, const char* name, const char* description) {
+            skills[static_cast<int>(skill_enum)]     = Skill{ skill_enum, active_event_builder, passive_event_builder, name, description };
+            registered[static_cast<int>(skill_enum)] = true;
+        }
+    };
+
+    // Builds the skill_library instance at compile time.
+    static constexpr SkillLibraryBuild build_skill_library() {
+        SkillLibraryBuild lib{};
+
+        lib.add(SkillEnum::DEMO_ATTACK, demo_attack<Config5v5>, nullptr, "Demo Attack", "Attacks a single target.");
+        lib.add(SkillEnum::DEMO_CLEAVE, demo_cleave<Config5v5>, nullptr, "Demo Cleave", "Attacks all opponents.");
 
         return lib;
     }
 
+    static constexpr SkillLibraryBuild skill_library_build = build_skill_library();
+
     // Represents the skill_library instance.
-    static const std::array<Skill, SKILL_LIBRARY_SIZE> skill_library = build_skill_library();
+    static constexpr const std::array<Skill, SKILL_LIBRARY_SIZE>& skill_library = skill_library_build.skills;
+
+    // Checks that every SkillEnum was registered. Checked on the flags, not the builder pointers: comparing a function
+    // pointer to null is not a constant expression under -fsanitize=null.
+    static constexpr bool skill_library_is_complete() {
+        for (int i = 0; i < SKILL_LIBRARY_SIZE; i++) {
+            if (!skill_library_build.registered[i] || static_cast<int>(skill_library_build.skills[i].skill_enum) != i) return false;
+        }
+        return true;
+    }
+
+    static_assert(skill_library_is_complete(), "Every SkillEnum needs a skill_library entry with an ActiveEventBuilder.");
 
     // Gets data for a skill from a SkillEnum.
     const Skill& get_skill(SkillEnum skill_enum) {
         return skill_library[static_cast<int>(skill_enum)];
     }
+
+    // Gets a skill's ActiveEventBuilder for a CombatConfig.
+    template <typename Config>
+    ActiveEventBuilderT<Config> get_active_event_builder(SkillEnum skill_enum) {
+        switch (skill_enum) {
+            case SkillEnum::DEMO_ATTACK: return demo_attack<Config>;
+            case SkillEnum::DEMO_CLEAVE: return demo_cleave<Config>;
+            default:                     return nullptr;
+        }
+    }
+
+    // Gets a skill's PassiveEventBuilder for a CombatConfig.
+    // ROADMAP: Map passive skills once PassiveEventBuilders ship in the demo build.
+    template <typename Config>
+    PassiveEventBuilderT<Config> get_passive_event_builder(SkillEnum) { return nullptr; }
+
+    // --- Instantiations ---
+    template ActiveEventBuilderT<Config5v5>         get_active_event_builder<Config5v5>(SkillEnum);
+    template ActiveEventBuilderT<Config5v5Pointer>  get_active_event_builder<Config5v5Pointer>(SkillEnum);
+    template ActiveEventBuilderT<Config5v5Program>  get_active_event_builder<Config5v5Program>(SkillEnum);
+    template ActiveEventBuilderT<Config1v20>        get_active_event_builder<Config1v20>(SkillEnum);
+    template ActiveEventBuilderT<Config30v30>       get_active_event_builder<Config30v30>(SkillEnum);
+    template ActiveEventBuilderT<Config5v5Fixed>    get_active_event_builder<Config5v5Fixed>(SkillEnum);
+    template ActiveEventBuilderT<Config1v20Fixed>   get_active_event_builder<Config1v20Fixed>(SkillEnum);
+    template ActiveEventBuilderT<Config30v30Fixed>  get_active_event_builder<Config30v30Fixed>(SkillEnum);
+    template PassiveEventBuilderT<Config5v5>        get_passive_event_builder<Config5v5>(SkillEnum);
+    template PassiveEventBuilderT<Config5v5Pointer> get_passive_event_builder<Config5v5Pointer>(SkillEnum);
+    template PassiveEventBuilderT<Config5v5Program> get_passive_event_builder<Config5v5Program>(SkillEnum);
+    template PassiveEventBuilderT<Config1v20>       get_passive_event_builder<Config1v20>(SkillEnum);
+    template PassiveEventBuilderT<Config30v30>      get_passive_event_builder<Config30v30>(SkillEnum);
+    template PassiveEventBuilderT<Config5v5Fixed>   get_passive_event_builder<Config5v5Fixed>(SkillEnum);
+    template PassiveEventBuilderT<Config1v20Fixed>  get_passive_event_builder<Config1v20Fixed>(SkillEnum);
+    template PassiveEventBuilderT<Config30v30Fixed> get_passive_event_builder<Config30v30Fixed>(SkillEnum);
 }
\ No newline at end of file
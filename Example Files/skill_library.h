@@ -3,7 +3,8 @@
 // Skill Library
 // ----------------
 // Provides read-only access to the array of all base Skill entries.
-// The library is static and allocated once.
+// The library is a constexpr table: it is built at compile time, so it needs no dynamic initialisation and is
+// safe to read from other static initialisers (e.g. the creature library).
 
 #include <string>
 
@@ -20,7 +21,7 @@ namespace pipelinepunch {
         const char*         name;
         const char*         description;
 
-        Skill(SkillEnum se = SkillEnum::DEMO_ATTACK, ActiveEventBuilder a = nullptr, PassiveEventBuilder p = nullptr, const char* n = "", const char* d = "")
+        constexpr Skill(SkillEnum se = SkillEnum::DEMO_ATTACK, ActiveEventBuilder a = nullptr, PassiveEventBuilder p = nullptr, const char* n = "", const char* d = "")
         : skill_enum(se),
             active_event_builder(a),
             passive_event_builder(p),
@@ -30,4 +31,7 @@ namespace pipelinepunch {
     };
 
     const Skill& get_skill(SkillEnum skill_enum); // Gets data for a skill from a SkillEnum.
+
+    template <typename Config> ActiveEventBuilderT<Config>  get_active_event_builder(SkillEnum skill_enum);  // Gets a skill's ActiveEventBuilder for a CombatConfig.
+    template <typename Config> PassiveEventBuilderT<Config> get_passive_event_builder(SkillEnum skill_enum); // Gets a skill's PassiveEventBuilder for a CombatConfig.
 }
\ No newline at end of file
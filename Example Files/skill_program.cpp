@@ -0,0 +1,387 @@
+// SkillProgram
+// ------------
+// Compiles data-driven skill source into SkillPrograms and runs them in place of hand-written ActiveEventBuilders.
+// - Compilation happens once, at load time; running a program only walks its op list.
+// - Each op is a straight loop over the lanes of every target position, so the interpreter's cost is a
+//   few vector passes per op rather than a branchy loop per target.
+
+#include "skill_program.h"
+#include "alias.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+#include "pipelinepunch/utils/structs/skills.h"
+
+namespace pipelinepunch {
+
+    constexpr int SKILL_SOURCE_LINE   = 256; // Longest source line accepted.
+    constexpr int SKILL_SOURCE_TOKENS = 4;   // Most tokens in a statement.
+
+    // Represents a named value in the source format.
+    template <typename T>
+    struct SkillSourceName {
+        const char* name;
+        T           value;
+    };
+
+    static constexpr SkillSourceName<SkillStat> SKILL_STAT_NAMES[] = {
+        { "lp", SkillStat::LP }, { "atk", SkillStat::ATK }, { "def", SkillStat::DEF },
+        { "mag", SkillStat::MAG }, { "crt", SkillStat::CRT }, { "spe", SkillStat::SPE }
+    };
+
+    // ROADMAP: Name every TypeEnum once creature types beyond the demo ship.
+    static constexpr SkillSourceName<TypeEnum> SKILL_TYPE_NAMES[] = {
+        { "monster", TypeEnum::MONSTER }, { "undead", TypeEnum::UNDEAD }
+    };
+
+    // Looks up a named value, returning false if the name is unknown.
+    template <typename T, size_t COUNT>
+    static bool find_name(const SkillSourceName<T> (&names)[COUNT], const char* name, T& value) {
+        for (const SkillSourceName<T>& entry : names) {
+            if (std::strcmp(entry.name, name) == 0) {
+                value = entry.value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Parses a whole token as a decimal int, returning false if it is not one.
+    static bool parse_int(const char* token, int32_t& value) {
+        char* end = nullptr;
+        const long parsed = std::strtol(token, &end, 10);
+        if (end == token || *end != '\0' || parsed < INT32_MIN || parsed > INT32_MAX) return false;
+
+        value = static_cast<int32_t>(parsed);
+        return true;
+    }
+
+    // Gets a CharacterTable stat column. The stat columns are consecutive and in SkillStat order, so a column is an
+    // offset from lp, with no table to load on the way to the stat.
+    template <int N>
+    static const float* stat_column(const CharacterTable<N>& ct, SkillStat stat) {
+        static_assert(offsetof(CharacterTable<N>, spe) - offsetof(CharacterTable<N>, lp) == static_cast<size_t>(SkillStat::SPE) * sizeof(ct.lp),
+            "SkillStat columns must be consecutive in the CharacterTable, in SkillStat order.");
+        return reinterpret_cast<const float*>(reinterpret_cast<const char*>(&ct) + offsetof(CharacterTable<N>, lp) + static_cast<size_t>(stat) * sizeof(ct.lp));
+    }
+
+    // Fuses the program's last ops into one where a fused op exists, so the interpreter makes fewer passes.
+    static void fuse_last_ops(SkillProgram& program) {
+        if (program.op_count < 2) return;
+
+        // A power, an owner/target ratio and a damage: POWER takes the same power against every type.
+        if (program.op_count >= 3 && program.ops[program.op_count - 1].code == SkillOpCode::DAMAGE) {
+            SkillOp&       power = program.ops[program.op_count - 3];
+            const SkillOp& ratio = program.ops[program.op_count - 2];
+
+            if ((power.code == SkillOpCode::POWER || power.code == SkillOpCode::POWER_BY_TYPE) && ratio.code == SkillOpCode::MUL_OWNER_DIV_TARGET) {
+                if (power.code == SkillOpCode::POWER) { power.value_vs = power.value; }
+                power.code     = SkillOpCode::RATIO_DAMAGE;
+                power.stat     = ratio.stat;
+                power.div_stat = ratio.div_stat;
+                program.op_count -= 2;
+                return;
+            }
+        }
+
+        SkillOp& first = program.ops[program.op_count - 2];
+        SkillOp& last  = program.ops[program.op_count - 1];
+
+        if (first.code == SkillOpCode::POWER && last.code == SkillOpCode::POWER_VS_TYPE) {
+            first.code     = SkillOpCode::POWER_BY_TYPE;
+            first.type     = last.type;
+            first.value_vs = last.value;
+        } else if (first.code == SkillOpCode::MUL_OWNER_STAT && last.code == SkillOpCode::DIV_TARGET_STAT) {
+            first.code     = SkillOpCode::MUL_OWNER_DIV_TARGET;
+            first.div_stat = last.stat;
+        } else {
+            return;
+        }
+
+        program.op_count--;
+    }
+
+    // --- SkillProgramLibrary ---
+    // Compiles source text, replacing every program. Returns false on the first error, leaving the library
+    // empty and the line and message in error_line and error.
+    bool SkillProgramLibrary::compile(const char* source) {
+        count      = 0;
+        error_line = 0;
+        error[0]   = '\0';
+
+        SkillProgram* current     = nullptr;
+        int           line_number = 0;
+
+        // Records the first error and empties the library.
+        auto fail = [&](const char* message) {
+            error_line = line_number;
+            std::snprintf(error, sizeof(error), "%s", message);
+            count = 0;
+            return false;
+        };
+
+        for (const char* cursor = source; *cursor;) {
+            line_number++;
+
+            // Copies the line without its comment, then splits it into tokens.
+            char line[SKILL_SOURCE_LINE];
+            int  length = 0;
+            while (*cursor && *cursor != '\n') {
+                if (length == SKILL_SOURCE_LINE - 1) return fail("line too long");
+                line[length++] = *cursor++;
+            }
+            if (*cursor == '\n') { cursor++; }
+            line[length] = '\0';
+
+            if (char* comment = std::strchr(line, '#')) { *comment = '\0'; }
+
+            char* tokens[SKILL_SOURCE_TOKENS + 1];
+            int   token_count = 0;
+            for (char* token = std::strtok(line, " \t\r"); token; token = std::strtok(nullptr, " \t\r")) {
+                if (token_count == SKILL_SOURCE_TOKENS) return fail("too many tokens");
+                tokens[token_count++] = token;
+            }
+            if (token_count == 0) continue;
+
+            const char* statement = tokens[0];
+
+            // Outside a program only 'skill' is valid.
+            if (!current) {
+                int32_t id = 0;
+                if (std::strcmp(statement, "skill") != 0 || token_count != 3)  return fail("expected 'skill <id> <name>'");
+                if (!parse_int(tokens[1], id) || id < 0)                        return fail("skill id must be a non-negative integer");
+                if (id >= static_cast<int32_t>(NO_SKILL))                       return fail("skill id out of range");
+                if (find(static_cast<SkillEnum>(id)))                           return fail("duplicate skill id");
+                if (count == MAX_PROGRAMS)                                      return fail("too many skills");
+
+                current = &programs[count];
+                *current = SkillProgram{};
+                current->skill_enum = static_cast<SkillEnum>(id);
+                std::snprintf(current->name, sizeof(current->name), "%s", tokens[2]);
+                continue;
+            }
+
+            if (std::strcmp(statement, "end") == 0) {
+                if (token_count != 1) return fail("'end' takes no arguments");
+                count++;
+                current = nullptr;
+                continue;
+            }
+
+            if (std::strcmp(statement, "target") == 0) {
+                if (token_count != 2) return fail("expected 'target single|all'");
+                if      (std::strcmp(tokens[1], "single") == 0) { current->is_aoe = false; }
+                else if (std::strcmp(tokens[1], "all")    == 0) { current->is_aoe = true; }
+                else return fail("expected 'target single|all'");
+                continue;
+            }
+
+            if (current->op_count == SkillProgram::MAX_OPS) return fail("too many ops in skill");
+            SkillOp& op = current->ops[current->op_count];
+            op = SkillOp{};
+
+            if (std::strcmp(statement, "power") == 0) {
+                if (token_count != 2 || !parse_int(tokens[1], op.value)) return fail("expected 'power <value>'");
+                op.code = SkillOpCode::POWER;
+            } else if (std::strcmp(statement, "power_vs") == 0) {
+                if (token_count != 3 || !find_name(SKILL_TYPE_NAMES, tokens[1], op.type) || !parse_int(tokens[2], op.value)) return fail("expected 'power_vs <type> <value>'");
+                op.code = SkillOpCode::POWER_VS_TYPE;
+            } else if (std::strcmp(statement, "mul") == 0 || std::strcmp(statement, "div") == 0) {
+                const bool is_mul = statement[0] == 'm';
+                if (token_count != 3 || !find_name(SKILL_STAT_NAMES, tokens[2], op.stat)) return fail("expected 'mul|div owner|target <stat>'");
+
+                if      (std::strcmp(tokens[1], "owner")  == 0) { op.code = is_mul ? SkillOpCode::MUL_OWNER_STAT  : SkillOpCode::DIV_OWNER_STAT; }
+                else if (std::strcmp(tokens[1], "target") == 0) { op.code = is_mul ? SkillOpCode::MUL_TARGET_STAT : SkillOpCode::DIV_TARGET_STAT; }
+                else return fail("expected 'mul|div owner|target <stat>'");
+            } else if (std::strcmp(statement, "damage") == 0) {
+                if (token_count != 1) return fail("'damage' takes no arguments");
+                op.code = SkillOpCode::DAMAGE;
+                current->effect_bitmask |= DAMAGE;
+            } else {
+                return fail("unknown statement");
+            }
+
+            current->op_count++;
+            fuse_last_ops(*current);
+        }
+
+        if (current) { return fail("missing 'end'"); }
+
+        return true;
+    }
+
+    // Reads a whole source file and compiles it.
+    bool SkillProgramLibrary::load(std::FILE* file) {
+        std::string source;
+        char        chunk[4096];
+
+        for (size_t read; (read = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) { source.append(chunk, read); }
+        if (std::ferror(file)) {
+            count      = 0;
+            error_line = 0;
+            std::snprintf(error, sizeof(error), "read error");
+            return false;
+        }
+
+        return compile(source.c_str());
+    }
+
+    // Gets the program of a SkillEnum, or nullptr.
+    const SkillProgram* SkillProgramLibrary::find(SkillEnum skill_enum) const {
+        for (int i = 0; i < count; i++) {
+            if (programs[i].skill_enum == skill_enum) return &programs[i];
+        }
+        return nullptr;
+    }
+
+    // --- Interpreter ---
+    // Truncates a lane toward zero like integer division does; a round trip through int64 is far cheaper than std::trunc
+    // without SSE4.1. Lanes of 2^52 or more are already whole (and may not fit an int64), so they are kept as they are.
+    static inline double truncate(double value) { return (std::fabs(value) < 0x1p52) ? static_cast<double>(static_cast<int64_t>(value)) : value; }
+
+    // Gets a stat as a divisor. Empty slots hold zero stats, so a zero divisor becomes 1, as in BatchCombatEngine's
+    // empty lanes; the lanes of empty slots are computed but never written.
+    static inline double divisor(float stat) {
+        const int value = static_cast<int>(stat);
+        return value ? value : 1;
+    }
+
+    // Runs a program's ops over WIDTH lanes, one per target position from first on. Lanes of positions the program
+    // does not hit are computed too, and only DAMAGE looks at targeted, so every op is a straight, branch-free loop.
+    template <int WIDTH, int N>
+    static void run_lanes(const SkillProgram& program, const CharacterTable<N>& owner_ct, const CharacterTable<N>& other_ct, const Intent& intent, int first, Event<N>& event) {
+        int    index[WIDTH];    // SoA index of each lane's target.
+        bool   targeted[WIDTH];
+        double lane[WIDTH] {};
+
+        for (int l = 0; l < WIDTH; l++) {
+            index[l]    = other_ct.pos_to_index[first + l];
+            targeted[l] = !program.is_aoe || other_ct.life[index[l]] > 0.0f;
+        }
+
+        for (int i = 0; i < program.op_count; i++) {
+            const SkillOp& op = program.ops[i];
+
+            switch (op.code) {
+                case SkillOpCode::POWER:
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = op.value; }
+                    break;
+
+                case SkillOpCode::POWER_VS_TYPE:
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = (other_ct.type[index[l]] == op.type) ? op.value : lane[l]; }
+                    break;
+
+                case SkillOpCode::POWER_BY_TYPE:
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = (other_ct.type[index[l]] == op.type) ? op.value_vs : op.value; }
+                    break;
+
+                case SkillOpCode::MUL_OWNER_STAT: {
+                    const double stat = static_cast<int>(stat_column(owner_ct, op.stat)[intent.owner_index]);
+                    for (int l = 0; l < WIDTH; l++) { lane[l] *= stat; }
+                    break;
+                }
+
+                case SkillOpCode::DIV_OWNER_STAT: {
+                    const double stat = divisor(stat_column(owner_ct, op.stat)[intent.owner_index]);
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = truncate(lane[l] / stat); }
+                    break;
+                }
+
+                case SkillOpCode::MUL_TARGET_STAT: {
+                    const float* column = stat_column(other_ct, op.stat);
+                    for (int l = 0; l < WIDTH; l++) { lane[l] *= static_cast<int>(column[index[l]]); }
+                    break;
+                }
+
+                case SkillOpCode::DIV_TARGET_STAT: {
+                    const float* column = stat_column(other_ct, op.stat);
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = truncate(lane[l] / divisor(column[index[l]])); }
+                    break;
+                }
+
+                case SkillOpCode::MUL_OWNER_DIV_TARGET: {
+                    const double stat   = static_cast<int>(stat_column(owner_ct, op.stat)[intent.owner_index]);
+                    const float* column = stat_column(other_ct, op.div_stat);
+                    for (int l = 0; l < WIDTH; l++) { lane[l] = truncate(lane[l] * stat / divisor(column[index[l]])); }
+                    break;
+                }
+
+                case SkillOpCode::DAMAGE:
+                    for (int l = 0; l < WIDTH; l++) {
+                        if (targeted[l]) { event.other_pos_damage[first + l] = static_cast<float>(lane[l]); }
+                    }
+                    break;
+
+                case SkillOpCode::RATIO_DAMAGE: {
+                    const double stat   = static_cast<int>(stat_column(owner_ct, op.stat)[intent.owner_index]);
+                    const float* column = stat_column(other_ct, op.div_stat);
+                    for (int l = 0; l < WIDTH; l++) {
+                        const double power = (other_ct.type[index[l]] == op.type) ? op.value_vs : op.value;
+                        lane[l] = truncate(power * stat / divisor(column[index[l]]));
+                        if (targeted[l]) { event.other_pos_damage[first + l] = static_cast<float>(lane[l]); }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Runs a program that is a single RATIO_DAMAGE op on the chosen position, or on every living position for AOE
+    // skills. It needs no lanes: each target is one int ratio, computed as the hand-written builders do, so the
+    // program costs what its builder does. Only lanes beyond int range (stats in the millions) would differ.
+    template <int N>
+    static void run_ratio_damage(const SkillProgram& program, const CharacterTable<N>& owner_ct, const CharacterTable<N>& other_ct, const Intent& intent, Event<N>& event) {
+        const SkillOp& op     = program.ops[0];
+        const int      stat   = static_cast<int>(stat_column(owner_ct, op.stat)[intent.owner_index]);
+        const float*   column = stat_column(other_ct, op.div_stat);
+
+        // Branches on the type rather than selecting the power, like the builders, which keeps the select off the
+        // path to the division.
+        auto ratio = [&](int target_index) {
+            const int value       = static_cast<int>(column[target_index]);
+            const int denominator = value ? value : 1;
+            return (other_ct.type[target_index] == op.type) ? op.value_vs * stat / denominator : op.value * stat / denominator;
+        };
+
+        if (!program.is_aoe) {
+            event.other_pos_damage[intent.target_pos] = ratio(other_ct.pos_to_index[intent.target_pos]);
+            return;
+        }
+
+        for (int pos = 0; pos < N; pos++) {
+            const int target_index = other_ct.pos_to_index[pos];
+            if (other_ct.life[target_index] > 0.0f) { event.other_pos_damage[pos] = ratio(target_index); }
+        }
+    }
+
+    // Runs one phase of a SkillProgram. Phase 1 builds the event like a hand-written builder would; phase 2 runs
+    // the ops over the chosen position's lane for single-target skills, or over every position's lane for AOE skills.
+    // A program that fused into a single RATIO_DAMAGE skips the lanes.
+    template <typename Config, SkillPhase PHASE>
+    void run_skill_program(const SkillProgram& program, BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event) {
+        constexpr int N = Config::TEAM_SIZE;
+
+        if constexpr (PHASE == SkillPhase::CREATE) {
+            Event<N>* new_event = context.emplace_main_event(intent);
+            if (!new_event) return;
+
+            new_event->is_aoe = program.is_aoe;
+            new_event->target_bitmask = program.is_aoe ? AOE : single_target(intent);
+            new_event->effect_bitmask = program.effect_bitmask;
+        } else {
+            if      (program.op_count == 1 && program.ops[0].code == SkillOpCode::RATIO_DAMAGE) { run_ratio_damage<N>(program, owner_ct, other_ct, intent, *event); }
+            else if (program.is_aoe)                                                             { run_lanes<N>(program, owner_ct, other_ct, intent, 0, *event); }
+            else                                                                                 { run_lanes<1>(program, owner_ct, other_ct, intent, intent.target_pos, *event); }
+        }
+    }
+
+    // --- Instantiations ---
+    template void run_skill_program<Config5v5Program, SkillPhase::CREATE> (const SkillProgram&, BattleContext<Config5v5Program>&, const CharacterTable<5>&, const CharacterTable<5>&, const Intent&, Event<5>*);
+    template void run_skill_program<Config5v5Program, SkillPhase::RESOLVE>(const SkillProgram&, BattleContext<Config5v5Program>&, const CharacterTable<5>&, const CharacterTable<5>&, const Intent&, Event<5>*);
+}
\ No newline at end of file
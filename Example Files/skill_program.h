@@ -0,0 +1,104 @@
+#pragma once
+
+// SkillProgram
+// ------------
+// Data-driven skills: a skill described in a text file is compiled at load time into a short, flat op list,
+// which an interpreter runs in place of a hand-written ActiveEventBuilder.
+// - Ops work on one lane per target position: the interpreter runs each op across every position at once,
+//   as straight loops over fixed-size lane arrays the compiler can vectorise. Single-target skills run one lane.
+// - The compiler fuses common op pairs (a power with its type bonus, an attack/defence ratio) into single ops, and a
+//   whole power/ratio/damage sequence into RATIO_DAMAGE. A program of that op alone skips the lanes and computes its
+//   targets' int ratios the way the hand-written builder it mirrors does, at the builder's cost.
+// - Lanes hold doubles: products and quotients of the integer stats are exact there, and a truncated
+//   quotient equals C++ integer division, so a program reproduces the matching hand-written builder bit for bit.
+// - A SkillProgramLibrary is compiled from source text, caller-owned and read-only while battles run; a
+//   CombatEngine whose CombatConfig selects SkillDispatch::PROGRAM runs the programs it finds in it.
+//
+// Source format (one statement per line, '#' starts a comment):
+//     skill <skill_enum id> <name>   Starts a program for a SkillEnum value; ids past the skill library add new skills.
+//     target single|all              Targets the chosen position, or every living opponent (an AOE event).
+//     power <value>                  Sets every lane to a base power.
+//     power_vs <type> <value>        Replaces the power of lanes whose target is of a creature type.
+//     mul owner|target <stat>        Multiplies lanes by the caster's or the target's stat (truncated to an int).
+//     div owner|target <stat>        Divides lanes by a stat, truncating like integer division.
+//     damage                         Writes the lanes of targeted positions to the event's damage.
+//     end                            Ends the program.
+// Stats: lp, atk, def, mag, crt, spe. Types: monster, undead.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/data/enums/type_enums.h"
+#include "pipelinepunch/systems/combat_system/enums/skill_dispatch.h"
+#include "pipelinepunch/systems/combat_system/structs/battle_context.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/event.h"
+#include "pipelinepunch/systems/combat_system/structs/intent.h"
+
+namespace pipelinepunch {
+
+    // Represents the operation of a SkillOp.
+    enum class SkillOpCode : uint8_t {
+        POWER,           // lane = value
+        POWER_VS_TYPE,   // lane = value where the target's type matches
+        MUL_OWNER_STAT,  // lane *= int(owner stat)
+        MUL_TARGET_STAT, // lane *= int(target stat)
+        DIV_OWNER_STAT,  // lane = trunc(lane / int(owner stat))
+        DIV_TARGET_STAT, // lane = trunc(lane / int(target stat))
+        DAMAGE,          // other_pos_damage = lane, for targeted positions
+
+        // Fused by the compiler from two consecutive ops, to save the interpreter a pass.
+        POWER_BY_TYPE,        // POWER, then POWER_VS_TYPE: lane = value_vs where the target's type matches, else value
+        MUL_OWNER_DIV_TARGET, // MUL_OWNER_STAT, then DIV_TARGET_STAT: lane = trunc(lane * int(owner stat) / int(target div_stat))
+
+        // Fused from three: POWER or POWER_BY_TYPE, MUL_OWNER_DIV_TARGET, then DAMAGE. A program that is only this op
+        // (the shape of the demo skills) runs without lanes, as one int ratio per target.
+        RATIO_DAMAGE
+    };
+
+    // Represents a CharacterTable stat column read by a SkillOp.
+    enum class SkillStat : uint8_t { LP, ATK, DEF, MAG, CRT, SPE };
+
+    // Represents one compiled op.
+    struct SkillOp {
+        SkillOpCode code;
+        SkillStat   stat;
+        SkillStat   div_stat; // Divisor of MUL_OWNER_DIV_TARGET.
+        TypeEnum    type;
+        int32_t     value;
+        int32_t     value_vs; // Power against the type of POWER_BY_TYPE.
+    };
+
+    // Represents a compiled skill.
+    struct SkillProgram {
+        static constexpr int MAX_OPS  = 16;
+        static constexpr int MAX_NAME = 32;
+
+        SkillEnum skill_enum;
+        char      name[MAX_NAME];
+        bool      is_aoe;         // Targets every living opponent instead of the chosen position.
+        uint32_t  effect_bitmask; // Effect flags of the created event.
+        int       op_count;
+        SkillOp   ops[MAX_OPS];
+    };
+
+    // Represents a set of compiled skills, looked up by SkillEnum.
+    struct SkillProgramLibrary {
+        static constexpr int MAX_PROGRAMS = 64;
+        static constexpr int MAX_ERROR    = 96;
+
+        int          count { 0 };
+        SkillProgram programs[MAX_PROGRAMS];
+        int          error_line { 0 };    // Line of the first compile error, 0 if none.
+        char         error[MAX_ERROR] {}; // Message of the first compile error.
+
+        bool                compile(const char* source);      // Compiles source text, replacing every program; false (and empty) on the first error.
+        bool                load(std::FILE* file);            // Reads a whole source file and compiles it.
+        const SkillProgram* find(SkillEnum skill_enum) const; // Gets the program of a SkillEnum, or nullptr.
+    };
+
+    // Runs one phase of a SkillProgram for an event of a battle shaped by Config; event is only read in SkillPhase::RESOLVE.
+    template <typename Config, SkillPhase PHASE>
+    void run_skill_program(const SkillProgram& program, BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+// Skills
+// ------
+// Holds a unit's skill slots as function pointers registered from the skill library.
+// - ActiveEventBuilders create and resolve main events.
+// - PassiveEventBuilders respond to events registered in the passive tables.
+// - Both receive the BattleContext of the battle they run in, never a global instance.
+// - Builder signatures depend on the battle's CombatConfig. Sheets hold the 5v5 builders; a CombatEngine
+//   resolves the builders of its own config from each slot's SkillEnum through the skill library.
+
+#include <limits>
+#include <type_traits>
+
+#include "pipelinepunch/data/enums/skill_enums.h"
+#include "pipelinepunch/systems/combat_system/structs/combat_config.h"
+
+namespace pipelinepunch {
+
+    template <int N> struct CharacterTable;
+    template <int N> struct Event;
+    template <typename Config> struct BattleContext;
+    struct Intent;
+
+    constexpr int SKILL_SLOTS = 2;
+
+    // Represents an empty skill slot: no skill library entry, builder or SkillProgram has this SkillEnum.
+    constexpr SkillEnum NO_SKILL = static_cast<SkillEnum>(std::numeric_limits<std::underlying_type_t<SkillEnum>>::max());
+
+    template <typename Config>
+    using ActiveEventBuilderT  = void (*)(BattleContext<Config>& context, const CharacterTable<Config::TEAM_SIZE>& owner_ct, const CharacterTable<Config::TEAM_SIZE>& other_ct, const Intent& intent, Event<Config::TEAM_SIZE>* event);
+    template <typename Config>
+    using PassiveEventBuilderT = void (*)(BattleContext<Config>& context, CharacterTable<Config::TEAM_SIZE>& owner_ct, CharacterTable<Config::TEAM_SIZE>& other_ct, Intent& intent);
+
+    using ActiveEventBuilder  = ActiveEventBuilderT<Config5v5>;
+    using PassiveEventBuilder = PassiveEventBuilderT<Config5v5>;
+
+    // Represents a unit's skill slots.
+    struct Skills {
+        SkillEnum           skill_enum[SKILL_SLOTS];
+        ActiveEventBuilder  active_event_builder[SKILL_SLOTS];
+        PassiveEventBuilder passive_event_builder[SKILL_SLOTS];
+    };
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+
+// StatTable
+// ---------
+// Struct-of-Arrays store behind one side's effective stats, which are kept current as their modifiers change
+// instead of being recomputed for every event.
+// - Holds each unit's base stats and the standing modifiers granted to it. The effective values live in the
+//   CharacterTable's own stat columns, so builders, skill programs and the scheduler read a modified stat with one
+//   load and battles without modifiers read exactly their base stats.
+// - A stat is changed by the timed effects whose bits are bound to it (StatBindings), each adding its magnitude as a
+//   fraction, and by standing modifiers (passive auras), each adding a flat amount and a fraction while its owner
+//   lives: effective = (base + flat) * (1 + fractions), never below MIN_STAT_FACTOR of the base.
+// - rebuild() recomputes one unit from its own modifier and effect lists. The engine calls it only for a unit whose
+//   modifiers changed, and bumps that unit's version.
+// - version counts those changes since roll_initiative and is saved in the BattleState; built is the version each
+//   unit's columns were computed at. Versions are a byte, to keep the 5v5 BattleState in budget, and wrap from 255
+//   to 1, so zero always means unchanged. A restore rebuilds only units with a non-zero version on either side,
+//   since branches restored from different snapshots can count the same number of different changes.
+
+#include <cstdint>
+
+#include "pipelinepunch/systems/combat_system/enums/atb_clock.h"
+#include "pipelinepunch/systems/combat_system/enums/combat_stat.h"
+#include "pipelinepunch/systems/combat_system/structs/character_table.h"
+#include "pipelinepunch/systems/combat_system/structs/effect_table.h"
+#include "pipelinepunch/systems/combat_system/structs/passive_table.h"
+#include "pipelinepunch/utils/structs/character_sheet.h"
+
+namespace pipelinepunch {
+
+    // Represents which timed effect bits modify a stat, shared by both sides of a battle.
+    struct StatBindings {
+        uint32_t   bits { 0 }; // Effect bits bound to a stat.
+        CombatStat stat[32];   // Stat of each bound bit.
+    };
+
+    // Represents the base stats and standing modifiers of a side with N slots.
+    template <int N>
+    struct StatTable {
+        static constexpr int     STATS           = static_cast<int>(CombatStat::COUNT);
+        static constexpr int     MAX_MODIFIERS   = 2 * N; // Standing modifiers the side's units can receive.
+        static constexpr uint8_t NONE            = 0xFF;  // End of a target's modifier list.
+        static constexpr float   MIN_STAT_FACTOR = 0.1f;  // Lowest effective stat, as a fraction of the base.
+
+        static_assert(MAX_MODIFIERS < NONE, "Modifier links are stored as uint8_t.");
+
+        // CharacterTable columns in CombatStat order, so a modifier finds its column without a branch.
+        static constexpr float (CharacterTable<N>::*COLUMNS[STATS])[N] = {
+            &CharacterTable<N>::atk, &CharacterTable<N>::def, &CharacterTable<N>::mag, &CharacterTable<N>::crt,
+            &CharacterTable<N>::spe, &CharacterTable<N>::dmg_in, &CharacterTable<N>::dmg_out
+        };
+
+        float      base[STATS][N];          // By CombatStat and SoA index.
+        int32_t    modifier_count { 0 };
+        uint8_t    modifier_head[N];        // First standing modifier of each target.
+        uint8_t    modifier_next[MAX_MODIFIERS];
+        int8_t     owner_team_index[MAX_MODIFIERS];
+        int8_t     owner_index[MAX_MODIFIERS];
+        CombatStat stat[MAX_MODIFIERS];
+        float      flat[MAX_MODIFIERS];     // Added to the base.
+        float      scale[MAX_MODIFIERS];    // Fraction of the modified base added on top.
+        uint32_t   owner_targets[2][N];     // Targets on this side of each owner, by team and SoA index.
+        uint8_t    version[N];              // Changes to each unit's modifiers since roll_initiative, wrapping past zero.
+        uint8_t    built[N];                // Version each unit's effective columns were computed at.
+
+        // --- Entry Points ---
+        // Sets a unit's base stats from its sheet's stats, or to zero for an empty slot (nullptr).
+        void set_base(int index, const Stats* stats) {
+            base[static_cast<int>(CombatStat::ATK)][index]     = stats ? stats->atk : 0.0f;
+            base[static_cast<int>(CombatStat::DEF)][index]     = stats ? stats->def : 0.0f;
+            base[static_cast<int>(CombatStat::MAG)][index]     = stats ? stats->mag : 0.0f;
+            base[static_cast<int>(CombatStat::CRT)][index]     = stats ? stats->crt : 0.0f;
+            base[static_cast<int>(CombatStat::SPE)][index]     = stats ? stats->spe : 0.0f;
+            base[static_cast<int>(CombatStat::DMG_IN)][index]  = stats ? 1.0f : 0.0f;
+            base[static_cast<int>(CombatStat::DMG_OUT)][index] = stats ? 1.0f : 0.0f;
+        }
+
+        // Removes every standing modifier and resets the versions.
+        void clear_modifiers() {
+            modifier_count = 0;
+            for (int index = 0; index < N; index++) {
+                modifier_head[index]    = NONE;
+                owner_targets[0][index] = 0;
+                owner_targets[1][index] = 0;
+                version[index]          = 0;
+                built[index]            = 0;
+            }
+        }
+
+        // Counts a change to a unit's modifiers, skipping zero when the version wraps.
+        void bump_version(int index) { version[index] = (version[index] == UINT8_MAX) ? 1 : static_cast<uint8_t>(version[index] + 1); }
+
+        // Grants a unit a standing modifier owned by a unit of either side. Returns false if the table is full.
+        bool add_modifier(int owner_team, int owner, int target_index, CombatStat modified_stat, float flat_value, float scale_value) {
+            if (modifier_count >= MAX_MODIFIERS) return false;
+
+            const int m = modifier_count++;
+            owner_team_index[m] = static_cast<int8_t>(owner_team);
+            owner_index[m]      = static_cast<int8_t>(owner);
+            stat[m]             = modified_stat;
+            flat[m]             = flat_value;
+            scale[m]            = scale_value;
+
+            modifier_next[m]            = modifier_head[target_index];
+            modifier_head[target_index] = static_cast<uint8_t>(m);
+            owner_targets[owner_team][owner] |= 1u << target_index;
+            return true;
+        }
+
+        // Recomputes a unit's effective stats into ct from its base, the standing modifiers of living owners and its
+        // timed effects with bound bits, and marks them built at the unit's current version. Without modifiers the
+        // columns get the base values exactly. owner_life holds both sides' life columns, by team index.
+        template <AtbClock CLOCK, int EFFECTS>
+        void rebuild(int index, const EffectTable<N, CLOCK, EFFECTS>& effects, const StatBindings& bindings, const float* const owner_life[2], CharacterTable<N>& ct) {
+            float added[STATS]     = {};
+            float fractions[STATS] = {};
+
+            for (uint8_t m = modifier_head[index]; m != NONE; m = modifier_next[m]) {
+                if (owner_life[owner_team_index[m]][owner_index[m]] <= 0.0f) continue;
+
+                added[static_cast<int>(stat[m])]     += flat[m];
+                fractions[static_cast<int>(stat[m])] += scale[m];
+            }
+
+            if (ct.effects[index] & bindings.bits) {
+                for (uint16_t i = effects.unit_head[index]; i != EffectTable<N, CLOCK, EFFECTS>::NONE; i = effects.unit_next[i]) {
+                    for (uint32_t bits = effects.bits[i] & bindings.bits; bits; bits &= bits - 1) {
+                        fractions[static_cast<int>(bindings.stat[PassiveTriggerIndex<N>::count_trailing_zeros(bits)])] += effects.magnitude[i];
+                    }
+                }
+            }
+
+            for (int s = 0; s < STATS; s++) {
+                const float value  = (base[s][index] + added[s]) * (1.0f + fractions[s]);
+                const float lowest = base[s][index] * MIN_STAT_FACTOR;
+                (ct.*COLUMNS[s])[index] = (value < lowest) ? lowest : value;
+            }
+
+            built[index] = version[index];
+        }
+    };
+}
\ No newline at end of file
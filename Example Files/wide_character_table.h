@@ -0,0 +1,27 @@
+#pragma once
+
+// WideCharacterTable
+// ------------------
+// Struct-of-Arrays character table interleaved across LANES independent battles.
+// - Column [unit][lane] holds the same value CharacterTable<N> holds at [index], one battle per lane,
+//   so a single vector operation advances the same unit slot in every battle at once.
+// - Only the columns read or written by scheduling and damage resolution are kept.
+// - Lanes use party position as SoA index; the pos_to_index indirection is not needed in bulk runs.
+
+namespace pipelinepunch {
+
+    // Represents one side of LANES battles running in lockstep.
+    template <int N, int LANES>
+    struct WideCharacterTable {
+        static_assert(LANES % 4 == 0, "LANES must be a multiple of the narrowest vector width (4 floats).");
+
+        alignas(64) float turn_bar[N][LANES];
+        alignas(64) float spe[N][LANES];
+        alignas(64) float life[N][LANES];
+        alignas(64) float life_bar[N][LANES];
+        alignas(64) float lp[N][LANES];
+        alignas(64) float atk[N][LANES];
+        alignas(64) float def[N][LANES];
+        alignas(64) float undead[N][LANES]; // 1.0f for TypeEnum::UNDEAD, selecting the skill's undead multiplier.
+    };
+}
\ No newline at end of file